@@ -27,6 +27,8 @@ def create_app() -> Flask:
     app.config["DATA_DIR"] = os.environ.get("DATA_DIR", "/app/data")
 
     app.config["ENGINE_TIMEOUT_S"] = int(os.environ.get("ENGINE_TIMEOUT_S", "300"))
+    # "binary" uses the compact wire format for backend -> engine calls; "json" is the fallback.
+    app.config["ENGINE_WIRE_FORMAT"] = os.environ.get("ENGINE_WIRE_FORMAT", "binary").strip().lower()
     app.config["ENABLE_TEST_ENDPOINT"] = os.environ.get("ENABLE_TEST_ENDPOINT", "0").strip() in {
         "1",
         "true",
@@ -9,15 +9,18 @@ from pathlib import Path
 from typing import Any
 
 import requests
-from flask import Blueprint, current_app, jsonify, request
+from flask import Blueprint, Response, current_app, jsonify, request, stream_with_context
 
+from ..core import dataset_file, wire
 from ..core.simulator import generate_skus, generate_truck
 
 api = Blueprint("api", __name__)
 
 ENGINE_TIMEOUT_S = 300
 DATASET_PREFIX = "dataset_"
-DATASET_SUFFIX = ".json"
+DATASET_SUFFIX = dataset_file.SUFFIX
+# Datasets written before the columnar format; still readable and cleaned up on reset.
+LEGACY_DATASET_SUFFIX = ".json"
 DATASET_PREVIEW_SIZE = 25
 
 
@@ -35,9 +38,9 @@ def _data_dir() -> Path:
     return data_dir
 
 
-def _dataset_path(dataset_id: str) -> Path:
+def _dataset_path(dataset_id: str, suffix: str = DATASET_SUFFIX) -> Path:
     """Build the absolute path for a dataset id within the configured DATA_DIR."""
-    return _data_dir() / f"{dataset_id}{DATASET_SUFFIX}"
+    return _data_dir() / f"{dataset_id}{suffix}"
 
 
 def _safe_unlink(path: Path) -> bool:
@@ -56,11 +59,23 @@ def _safe_unlink(path: Path) -> bool:
 
 
 def _load_dataset(dataset_id: str) -> dict[str, Any] | None:
-    """Load a dataset JSON file by id.
+    """Load a dataset by id as `{truck, skus}`.
 
+    Reads the columnar file, falling back to a legacy JSON dataset.
     Returns None if the dataset doesn't exist or can't be parsed.
     """
     path = _dataset_path(dataset_id)
+    if path.exists():
+        try:
+            return dataset_file.decode_dataset(path.read_bytes())
+        except OSError:
+            current_app.logger.exception("Failed to read dataset: %s", path)
+            return None
+        except wire.WireError:
+            current_app.logger.exception("Invalid dataset file: %s", path)
+            return None
+
+    path = _dataset_path(dataset_id, LEGACY_DATASET_SUFFIX)
     if not path.exists():
         return None
     try:
@@ -75,14 +90,17 @@ def _load_dataset(dataset_id: str) -> dict[str, Any] | None:
 
 
 def _save_dataset(dataset_id: str, truck: dict[str, Any], skus: list[dict[str, Any]]) -> None:
-    """Persist a dataset JSON file.
+    """Persist a columnar dataset file.
+
+    Written to a temp name and renamed so the engine never maps a half-written file.
 
     Raises:
         OSError: if the dataset can't be written.
     """
     path = _dataset_path(dataset_id)
-    with path.open("w", encoding="utf-8") as f:
-        json.dump({"truck": truck, "skus": skus}, f)
+    tmp = path.with_suffix(".tmp")
+    tmp.write_bytes(dataset_file.encode_dataset(truck, skus))
+    tmp.replace(path)
 
 
 def _engine_base_url() -> str:
@@ -91,21 +109,119 @@ def _engine_base_url() -> str:
 
 
 def _post_engine_optimize(
-    truck: dict[str, Any], boxes: list[Any], params: dict[str, Any]
+    truck: dict[str, Any],
+    boxes: list[Any],
+    params: dict[str, Any],
+    endpoint: str = "/optimize",
+    query: dict[str, Any] | None = None,
+    stream: bool = False,
 ) -> requests.Response:
-    """Call the engine optimize endpoint.
+    """Call the engine optimize endpoint (or `/jobs`, `/optimize/stream`: same bodies).
+
+    Uses the binary wire format when `ENGINE_WIRE_FORMAT=binary` (the default) and the
+    payload fits it; anything it can't express (e.g. malformed boxes, structured params)
+    goes as JSON so the engine reports the error in its usual shape.
 
     Raises:
         requests.RequestException: for network failures.
         requests.Timeout: on timeout.
     """
+    url = f"{_engine_base_url()}{endpoint}"
+    timeout = int(current_app.config.get("ENGINE_TIMEOUT_S", 300))
+
+    if current_app.config.get("ENGINE_WIRE_FORMAT") == "binary":
+        try:
+            data = wire.encode_request(truck, boxes, params)
+        except (wire.WireError, KeyError, TypeError, ValueError, AttributeError):
+            data = None
+        if data is not None:
+            headers = {
+                "Content-Type": wire.CONTENT_TYPE,
+                "Accept": f"{wire.CONTENT_TYPE}, application/json;q=0.5",
+            }
+            return requests.post(
+                url, data=data, headers=headers, params=query, stream=stream, timeout=timeout
+            )
+
     return requests.post(
-        f"{_engine_base_url()}/optimize",
+        url,
         json={"truck": truck, "boxes": boxes, "params": params},
+        params=query,
+        stream=stream,
+        timeout=timeout,
+    )
+
+
+def _forget_engine_dataset(dataset_id: str) -> None:
+    """Best-effort: drop a dataset from the engine's in-memory registry."""
+    try:
+        requests.delete(f"{_engine_base_url()}/datasets/{dataset_id}", timeout=5)
+    except requests.exceptions.RequestException:
+        current_app.logger.info("Engine registry cleanup failed for %s", dataset_id)
+
+
+def _post_engine_optimize_dataset(
+    dataset_id: str,
+    params: dict[str, Any],
+    endpoint: str = "/optimize",
+    query: dict[str, Any] | None = None,
+    stream: bool = False,
+) -> requests.Response:
+    """Ask the engine to optimize a stored dataset by id.
+
+    The engine maps the columnar file from the shared DATA_DIR, so only the id and params
+    cross the wire.
+
+    Raises:
+        requests.RequestException: for network failures.
+        requests.Timeout: on timeout.
+    """
+    return requests.post(
+        f"{_engine_base_url()}{endpoint}",
+        json={"dataset_id": dataset_id, "params": params},
+        headers={"Accept": f"{wire.CONTENT_TYPE}, application/json;q=0.5"},
+        params=query,
+        stream=stream,
         timeout=int(current_app.config.get("ENGINE_TIMEOUT_S", 300)),
     )
 
 
+def _engine_response_body(resp: requests.Response) -> Any:
+    """Decode an engine response (binary or JSON) into a JSON-serializable body."""
+    content_type = resp.headers.get("Content-Type", "")
+    try:
+        if content_type.startswith(wire.CONTENT_TYPE):
+            return wire.decode_result(resp.content)
+        return resp.json()
+    except ValueError:
+        return {"error": "engine_bad_response", "status_code": resp.status_code, "text": resp.text}
+
+
+def _relay_sse(resp: requests.Response, payload_boxes: list[Any]) -> Any:
+    """Pass engine SSE events through, enriching the final `result` like `/api/optimize`.
+
+    Progress events carry only placement deltas and are forwarded untouched.
+    """
+    try:
+        event: list[str] = []
+        for line in resp.iter_lines(decode_unicode=True):
+            if line:
+                event.append(line)
+                continue
+            if event and event[0] == "event: result":
+                data = "".join(x[len("data:") :].strip() for x in event if x.startswith("data:"))
+                try:
+                    body = json.loads(data)
+                    body = _enrich_placements(payload_boxes=payload_boxes, response_body=body)
+                    event = ["event: result", f"data: {json.dumps(body, separators=(',', ':'))}"]
+                except ValueError:
+                    current_app.logger.exception("Failed to enrich streamed result")
+            yield "\n".join(event) + "\n\n"
+            event = []
+    finally:
+        resp.close()
+
+
 def _enrich_placements(payload_boxes: list[Any], response_body: Any) -> Any:
     """Attach input box metadata to engine placements for UI inspection.
 
@@ -208,6 +324,8 @@ def simulate() -> Any:
     if previous_dataset_id:
         # Keeps disk usage stable during iterative experimentation.
         _safe_unlink(_dataset_path(str(previous_dataset_id)))
+        _safe_unlink(_dataset_path(str(previous_dataset_id), LEGACY_DATASET_SUFFIX))
+        _forget_engine_dataset(str(previous_dataset_id))
 
     dataset_id = f"{DATASET_PREFIX}{time.time_ns()}"
     sku_dicts = [asdict(s) for s in skus]
@@ -229,7 +347,8 @@ def optimize() -> Any:
 
     Request (JSON):
         Supports two modes:
-        - Dataset-backed: `{dataset_id, params?}`
+        - Dataset-backed: `{dataset_id, params?}`; the engine maps the stored columnar file
+          by id (falls back to sending the boxes when the engine can't see `DATA_DIR`)
         - Ad-hoc: `{truck?, boxes, params?}`
 
     Response (200 on success):
@@ -250,27 +369,33 @@ def optimize() -> Any:
     """
     payload = request.get_json(silent=True) or {}
 
-    dataset_id = payload.get("dataset_id")
-    if dataset_id:
-        dataset = _load_dataset(str(dataset_id))
-        if dataset is None:
-            return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
-        truck = dataset["truck"]
-        boxes = dataset["skus"]
-    else:
-        truck = generate_truck(payload.get("truck"))
-        boxes = payload.get("boxes") or []
-
-    if not isinstance(boxes, list):
-        return _bad_request("boxes must be a JSON array")
-
     params = payload.get("params") or {}
 
     if not isinstance(params, dict):
         return _bad_request("params must be a JSON object")
 
+    dataset_id = payload.get("dataset_id")
     try:
-        resp = _post_engine_optimize(truck=truck, boxes=boxes, params=params)
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            resp = None
+            if _dataset_path(dataset_id).exists():
+                resp = _post_engine_optimize_dataset(dataset_id=dataset_id, params=params)
+                if resp.status_code == 404:
+                    # Engine doesn't share DATA_DIR (e.g. local runs); send the boxes instead.
+                    resp = None
+            dataset = _load_dataset(dataset_id)
+            if dataset is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            boxes = dataset["skus"]
+            if resp is None:
+                resp = _post_engine_optimize(truck=dataset["truck"], boxes=boxes, params=params)
+        else:
+            truck = generate_truck(payload.get("truck"))
+            boxes = payload.get("boxes") or []
+            if not isinstance(boxes, list):
+                return _bad_request("boxes must be a JSON array")
+            resp = _post_engine_optimize(truck=truck, boxes=boxes, params=params)
     except requests.exceptions.Timeout:
         return (
             jsonify(
@@ -288,10 +413,7 @@ def optimize() -> Any:
         # For the UI: distinguish network failures from optimization failures.
         return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
 
-    try:
-        body = resp.json()
-    except ValueError:
-        body = {"error": "engine_bad_response", "status_code": resp.status_code, "text": resp.text}
+    body = _engine_response_body(resp)
 
     try:
         body = _enrich_placements(payload_boxes=boxes, response_body=body)
@@ -301,9 +423,371 @@ def optimize() -> Any:
     return jsonify(body), resp.status_code
 
 
+@api.post("/api/optimize/batch")
+def optimize_batch() -> Any:
+    """Optimize many independent instances in one engine call.
+
+    Request (JSON):
+        `{"instances": [...]}`, each item shaped like an `/api/optimize` body
+        (`{dataset_id, params?}` or `{truck?, boxes, params?}`).
+
+    Response (200):
+        `{"results": [...], "elapsed_ms"}` with results in input order; each is an engine
+        result (enriched like `/api/optimize`) plus `elapsed_ms`, or `{error, elapsed_ms}`.
+
+    Failure modes:
+        - 400 `invalid_request` if `instances` is not an array of objects.
+        - 404 `dataset_not_found` when a `dataset_id` doesn't exist under `DATA_DIR`.
+        - 502 `engine_unreachable` / 504 `engine_timeout` as for `/api/optimize`.
+
+    Auth:
+        None.
+    """
+    payload = request.get_json(silent=True) or {}
+    items = payload.get("instances")
+    if not isinstance(items, list) or not all(isinstance(i, dict) for i in items):
+        return _bad_request("instances must be an array of objects")
+
+    instances: list[dict[str, Any]] = []
+    inline: list[dict[str, Any]] = []
+    boxes_per_item: list[list[Any]] = []
+    for item in items:
+        params = item.get("params") or {}
+        if not isinstance(params, dict):
+            return _bad_request("params must be a JSON object")
+        if item.get("dataset_id"):
+            dataset_id = str(item["dataset_id"])
+            dataset = _load_dataset(dataset_id)
+            if dataset is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            instances.append({"dataset_id": dataset_id, "params": params})
+            inline.append({"truck": dataset["truck"], "boxes": dataset["skus"], "params": params})
+            boxes_per_item.append(dataset["skus"])
+        else:
+            boxes = item.get("boxes") or []
+            if not isinstance(boxes, list):
+                return _bad_request("boxes must be a JSON array")
+            entry = {"truck": generate_truck(item.get("truck")), "boxes": boxes, "params": params}
+            instances.append(entry)
+            inline.append(entry)
+            boxes_per_item.append(boxes)
+
+    url = f"{_engine_base_url()}/optimize/batch"
+    timeout = int(current_app.config.get("ENGINE_TIMEOUT_S", 300))
+    try:
+        resp = requests.post(url, json={"instances": instances}, timeout=timeout)
+        if resp.status_code == 404 and instances != inline:
+            # Engine doesn't share DATA_DIR; send the boxes instead.
+            resp = requests.post(url, json={"instances": inline}, timeout=timeout)
+    except requests.exceptions.Timeout:
+        message = "El engine tardó demasiado en responder al lote."
+        return jsonify({"error": "engine_timeout", "message": message}), 504
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+
+    body = _engine_response_body(resp)
+    results = body.get("results") if isinstance(body, dict) else None
+    if isinstance(results, list):
+        try:
+            body["results"] = [
+                _enrich_placements(payload_boxes=boxes, response_body=result)
+                for boxes, result in zip(boxes_per_item, results)
+            ]
+        except Exception:
+            current_app.logger.exception("Failed to enrich placements")
+
+    return jsonify(body), resp.status_code
+
+
+@api.post("/api/optimize/fleet")
+def optimize_fleet() -> Any:
+    """Pack a manifest into several trucks in one engine call.
+
+    Request (JSON):
+        `{fleet, dataset_id, params?}` or `{fleet, boxes, params?}`; `fleet` lists truck
+        types `{id?, w, h, d, max_weight?, count}`. `params.fill_target` (optional) sets
+        how full a truck is planned before the next one is opened.
+
+    Response (200):
+        `{"trucks": [...], "unplaced", "metrics"}`; each truck has `truck_type`, `index`,
+        `truck` and a regular result (placements enriched like `/api/optimize`);
+        `metrics.trucks_used` is the number of trucks needed.
+
+    Failure modes:
+        - 400 `invalid_request` if `fleet` is missing or not an array.
+        - 404 `dataset_not_found` when `dataset_id` doesn't exist under `DATA_DIR`.
+        - 502 `engine_unreachable` / 504 `engine_timeout` as for `/api/optimize`.
+
+    Auth:
+        None.
+    """
+    payload = request.get_json(silent=True) or {}
+    fleet = payload.get("fleet")
+    params = payload.get("params") or {}
+    if not isinstance(fleet, list) or not fleet:
+        return _bad_request("fleet must be a non-empty JSON array")
+    if not isinstance(params, dict):
+        return _bad_request("params must be a JSON object")
+
+    url = f"{_engine_base_url()}/optimize/fleet"
+    timeout = int(current_app.config.get("ENGINE_TIMEOUT_S", 300))
+    dataset_id = payload.get("dataset_id")
+    try:
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            dataset = _load_dataset(dataset_id)
+            if dataset is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            boxes = dataset["skus"]
+            body = {"dataset_id": dataset_id, "fleet": fleet, "params": params}
+            resp = requests.post(url, json=body, timeout=timeout)
+            if resp.status_code == 404:
+                body = {"boxes": boxes, "fleet": fleet, "params": params}
+                resp = requests.post(url, json=body, timeout=timeout)
+        else:
+            boxes = payload.get("boxes") or []
+            if not isinstance(boxes, list):
+                return _bad_request("boxes must be a JSON array")
+            body = {"boxes": boxes, "fleet": fleet, "params": params}
+            resp = requests.post(url, json=body, timeout=timeout)
+    except requests.exceptions.Timeout:
+        message = "El engine tardó demasiado en responder a la flota."
+        return jsonify({"error": "engine_timeout", "message": message}), 504
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+
+    out = _engine_response_body(resp)
+    trucks = out.get("trucks") if isinstance(out, dict) else None
+    if isinstance(trucks, list):
+        try:
+            out["trucks"] = [
+                _enrich_placements(payload_boxes=boxes, response_body=t) for t in trucks
+            ]
+        except Exception:
+            current_app.logger.exception("Failed to enrich placements")
+
+    return jsonify(out), resp.status_code
+
+
+@api.post("/api/optimize/stream")
+def optimize_stream() -> Any:
+    """Optimize while streaming best-so-far plans as Server-Sent Events.
+
+    Request (JSON):
+        Same bodies as `/api/optimize`.
+
+    Response (200, `text/event-stream`):
+        Engine events relayed as they arrive: `progress` (generation, best score,
+        utilization and an incumbent placement delta `{upserts, removed}`), then `result`
+        (enriched like `/api/optimize`) or `error`.
+
+    Failure modes:
+        - 400 `invalid_request` / 404 `dataset_not_found` before the stream starts.
+        - 502 `engine_unreachable` on connection errors to the engine.
+        - Failures after the stream starts arrive as an `error` event.
+
+    Auth:
+        None.
+    """
+    payload = request.get_json(silent=True) or {}
+
+    params = payload.get("params") or {}
+    if not isinstance(params, dict):
+        return _bad_request("params must be a JSON object")
+
+    dataset_id = payload.get("dataset_id")
+    try:
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            resp = None
+            if _dataset_path(dataset_id).exists():
+                resp = _post_engine_optimize_dataset(
+                    dataset_id=dataset_id, params=params, endpoint="/optimize/stream", stream=True
+                )
+                if resp.status_code == 404:
+                    resp.close()
+                    resp = None
+            dataset = _load_dataset(dataset_id)
+            if dataset is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            boxes = dataset["skus"]
+            if resp is None:
+                resp = _post_engine_optimize(
+                    truck=dataset["truck"],
+                    boxes=boxes,
+                    params=params,
+                    endpoint="/optimize/stream",
+                    stream=True,
+                )
+        else:
+            truck = generate_truck(payload.get("truck"))
+            boxes = payload.get("boxes") or []
+            if not isinstance(boxes, list):
+                return _bad_request("boxes must be a JSON array")
+            resp = _post_engine_optimize(
+                truck=truck, boxes=boxes, params=params, endpoint="/optimize/stream", stream=True
+            )
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+
+    if resp.status_code != 200:
+        return jsonify(_engine_response_body(resp)), resp.status_code
+
+    return Response(
+        stream_with_context(_relay_sse(resp, boxes)),
+        mimetype="text/event-stream",
+        headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"},
+    )
+
+
+@api.post("/api/optimize/jobs")
+def submit_optimize_job() -> Any:
+    """Queue an optimization on the engine and return immediately.
+
+    Long GA runs used to hold the request open until `ENGINE_TIMEOUT_S`; a job id lets the
+    UI poll progress instead.
+
+    Request (JSON):
+        Same bodies as `/api/optimize`. Optional query param `priority` (int, higher runs
+        first).
+
+    Response (202):
+        `{"job_id", "status": "queued"}`
+
+    Failure modes:
+        - 400 `invalid_request` for invalid `params`/`boxes`/`priority`.
+        - 404 `dataset_not_found` when `dataset_id` doesn't exist under `DATA_DIR`.
+        - 503 `queue_full` (forwarded) when the engine job queue is at capacity.
+        - 502 `engine_unreachable` on connection errors to the engine.
+
+    Auth:
+        None.
+    """
+    payload = request.get_json(silent=True) or {}
+
+    params = payload.get("params") or {}
+    if not isinstance(params, dict):
+        return _bad_request("params must be a JSON object")
+
+    try:
+        priority = int(request.args.get("priority", 0))
+    except ValueError:
+        return _bad_request("priority must be an integer", priority=request.args.get("priority"))
+
+    dataset_id = payload.get("dataset_id")
+    try:
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            resp = None
+            if _dataset_path(dataset_id).exists():
+                resp = _post_engine_optimize_dataset(
+                    dataset_id=dataset_id,
+                    params=params,
+                    endpoint="/jobs",
+                    query={"priority": priority},
+                )
+                if resp.status_code == 404:
+                    resp = None
+            if resp is None:
+                dataset = _load_dataset(dataset_id)
+                if dataset is None:
+                    return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+                # The label lets job polling enrich placements from the dataset.
+                resp = _post_engine_optimize(
+                    truck=dataset["truck"],
+                    boxes=dataset["skus"],
+                    params=params,
+                    endpoint="/jobs",
+                    query={"priority": priority, "label": dataset_id},
+                )
+        else:
+            truck = generate_truck(payload.get("truck"))
+            boxes = payload.get("boxes") or []
+            if not isinstance(boxes, list):
+                return _bad_request("boxes must be a JSON array")
+            resp = _post_engine_optimize(
+                truck=truck,
+                boxes=boxes,
+                params=params,
+                endpoint="/jobs",
+                query={"priority": priority},
+            )
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+
+    return jsonify(_engine_response_body(resp)), resp.status_code
+
+
+@api.get("/api/optimize/jobs/<int:job_id>")
+def optimize_job_status(job_id: int) -> Any:
+    """Poll an optimization job.
+
+    Request:
+        Optional query param `result=0` to skip the result while the UI only needs progress.
+
+    Response (200):
+        `{"job_id", "status", "priority", "label", "queued_ms", "run_ms", "progress", "result"?}`
+        where `status` is one of `queued|running|done|cancelled|failed` and `progress` is
+        `{generation, generations, best_score, utilization, placed, unplaced}` or null.
+        `result.placed` is enriched like `/api/optimize` for dataset-backed jobs.
+
+    Failure modes:
+        - 404 `job_not_found` (forwarded) for unknown or expired ids.
+        - 502 `engine_unreachable` on connection errors to the engine.
+
+    Auth:
+        None.
+    """
+    try:
+        resp = requests.get(
+            f"{_engine_base_url()}/jobs/{job_id}",
+            params={"result": request.args.get("result", "1")},
+            timeout=30,
+        )
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+
+    body = _engine_response_body(resp)
+    result = body.get("result") if isinstance(body, dict) else None
+    label = str(body.get("label") or "") if isinstance(body, dict) else ""
+    if isinstance(result, dict) and label.startswith(DATASET_PREFIX):
+        dataset = _load_dataset(label)
+        if dataset is not None:
+            try:
+                body["result"] = _enrich_placements(
+                    payload_boxes=dataset["skus"], response_body=result
+                )
+            except Exception:
+                current_app.logger.exception("Failed to enrich placements")
+
+    return jsonify(body), resp.status_code
+
+
+@api.delete("/api/optimize/jobs/<int:job_id>")
+def cancel_optimize_job(job_id: int) -> Any:
+    """Cancel an optimization job.
+
+    Response (200):
+        `{"job_id", "status": "cancelling"}`; a running job stops after its current
+        generation and keeps the best plan found so far.
+
+    Failure modes:
+        - 404 `job_not_found` / 409 `job_finished` (forwarded).
+        - 502 `engine_unreachable` on connection errors to the engine.
+
+    Auth:
+        None.
+    """
+    try:
+        resp = requests.delete(f"{_engine_base_url()}/jobs/{job_id}", timeout=30)
+    except requests.exceptions.RequestException as e:
+        return jsonify({"error": "engine_unreachable", "message": str(e)}), 502
+    return jsonify(_engine_response_body(resp)), resp.status_code
+
+
 @api.post("/api/reset")
 def reset() -> Any:
-    """Delete all dataset JSON files from `DATA_DIR`.
+    """Delete all dataset files (columnar and legacy JSON) from `DATA_DIR`.
 
     Request:
         No body.
@@ -319,7 +803,11 @@ def reset() -> Any:
     """
     data_dir = _data_dir()
     deleted = 0
-    for path in data_dir.glob(f"{DATASET_PREFIX}*{DATASET_SUFFIX}"):
+    paths = [
+        *data_dir.glob(f"{DATASET_PREFIX}*{DATASET_SUFFIX}"),
+        *data_dir.glob(f"{DATASET_PREFIX}*{LEGACY_DATASET_SUFFIX}"),
+    ]
+    for path in paths:
         try:
             if path.is_file() and path.parent == data_dir:
                 path.unlink()
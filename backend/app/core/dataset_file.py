@@ -0,0 +1,81 @@
+"""Columnar dataset files written by `/api/simulate`.
+
+Mirrors `engine/include/dataset_file.h`: an 8-byte header, the truck record and one box
+column block (same layout as the wire format). The engine memory-maps these files
+directly, so optimizing a stored dataset needs no parsing on either side.
+"""
+
+from __future__ import annotations
+
+import struct
+from typing import Any
+
+from . import wire
+
+MAGIC = b"VLDS"
+SUFFIX = ".vlds"
+
+
+def encode_dataset(truck: dict[str, Any], skus: list[dict[str, Any]]) -> bytes:
+    out = bytearray()
+    wire.write_header(out, MAGIC)
+    out += struct.pack(
+        "<4d",
+        float(truck["w"]),
+        float(truck["h"]),
+        float(truck["d"]),
+        float(truck.get("max_weight", 12_000.0)),
+    )
+    rows, columns = wire.box_columns(skus)
+    wire.write_column_block(out, rows, columns)
+    return bytes(out)
+
+
+def decode_dataset(data: bytes) -> dict[str, Any]:
+    """Decode a dataset into the `{truck, skus}` shape the JSON datasets used."""
+    buf = memoryview(data)
+    pos = wire.read_header(buf, MAGIC)
+    try:
+        w, h, d, max_weight = struct.unpack_from("<4d", buf, pos)
+    except struct.error as exc:
+        raise wire.WireError(str(exc)) from exc
+    rows, cols, _pos = wire.read_column_block(buf, pos + 32)
+
+    ids = cols.get(wire.COL_ID)
+    ws, hs, ds = cols.get(wire.COL_W), cols.get(wire.COL_H), cols.get(wire.COL_D)
+    if ids is None or ws is None or hs is None or ds is None:
+        raise wire.WireError("dataset is missing id/w/h/d columns")
+    weights = cols.get(wire.COL_WEIGHT) or [1.0] * rows
+    priorities = cols.get(wire.COL_PRIORITY) or [1] * rows
+
+    skus = [
+        {
+            "sku": ids[i],
+            "w": ws[i],
+            "h": hs[i],
+            "d": ds[i],
+            "weight": weights[i],
+            "priority": priorities[i],
+        }
+        for i in range(rows)
+    ]
+    masks = cols.get(wire.COL_ORIENTATIONS)
+    if masks is not None:
+        for sku, mask in zip(skus, masks):
+            sku["orientations"] = mask
+    max_loads = cols.get(wire.COL_MAX_LOAD)
+    if max_loads is not None:
+        for sku, max_load in zip(skus, max_loads):
+            if max_load:
+                sku["max_load"] = max_load
+    fragile = cols.get(wire.COL_FRAGILE)
+    if fragile is not None:
+        for sku, flag in zip(skus, fragile):
+            if flag:
+                sku["fragile"] = True
+    drops = cols.get(wire.COL_DROP)
+    if drops is not None:
+        for sku, drop in zip(skus, drops):
+            if drop:
+                sku["drop"] = drop
+    return {"truck": {"w": w, "h": h, "d": d, "max_weight": max_weight}, "skus": skus}
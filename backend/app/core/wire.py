@@ -0,0 +1,260 @@
+"""Python side of the engine's binary wire format.
+
+Mirrors `engine/include/wire_format.h`; keep the two in sync. Boxes travel as a few
+little-endian columns plus an id string table instead of one JSON object per box, which
+keeps large manifests small and cheap to encode on both ends.
+"""
+
+from __future__ import annotations
+
+import struct
+import sys
+from array import array
+from itertools import accumulate
+from typing import Any
+
+CONTENT_TYPE = "application/x-vectorload"
+VERSION = 1
+
+REQUEST_MAGIC = b"VLRQ"
+RESULT_MAGIC = b"VLRS"
+
+COL_ID = 1
+COL_W = 2
+COL_H = 3
+COL_D = 4
+COL_WEIGHT = 5
+COL_PRIORITY = 6
+COL_X = 7
+COL_Y = 8
+COL_Z = 9
+COL_ORIENTATIONS = 10
+COL_MAX_LOAD = 11
+COL_FRAGILE = 12
+COL_DROP = 13
+
+# Truck balance limits (axle loads, lateral offset) the request header has no room for.
+TRUCK_BALANCE_FIELDS = (
+    "front_axle_z",
+    "rear_axle_z",
+    "front_axle_max",
+    "rear_axle_max",
+    "max_lateral_offset",
+)
+
+# Orientation masks, as in `engine/include/engine_types.h`.
+ANY_ORIENTATION = 0x3F
+UPRIGHT_ORIENTATIONS = 0x21
+
+DTYPE_F64 = 1
+DTYPE_I32 = 2
+DTYPE_STRINGS = 3
+
+PARAM_NUMBER = 1
+PARAM_STRING = 2
+
+_TYPECODES = {DTYPE_F64: "d", DTYPE_I32: "i"}
+_BIG_ENDIAN = sys.byteorder == "big"
+
+
+class WireError(ValueError):
+    """Raised when a buffer is not a valid wire message."""
+
+
+def _pad(out: bytearray, align: int = 8) -> None:
+    out.extend(b"\0" * (-len(out) % align))
+
+
+def _le(values: array) -> bytes:
+    if _BIG_ENDIAN:
+        values = array(values.typecode, values)
+        values.byteswap()
+    return values.tobytes()
+
+
+def f64_column(tag: int, values: Any) -> tuple[int, int, bytes]:
+    return tag, DTYPE_F64, _le(array("d", values))
+
+
+def i32_column(tag: int, values: Any) -> tuple[int, int, bytes]:
+    return tag, DTYPE_I32, _le(array("i", values))
+
+
+def strings_column(tag: int, values: list[str]) -> tuple[int, int, bytes]:
+    encoded = [v.encode("utf-8") for v in values]
+    offsets = array("I", accumulate((len(e) for e in encoded), initial=0))
+    return tag, DTYPE_STRINGS, _le(offsets) + b"".join(encoded)
+
+
+def write_header(out: bytearray, magic: bytes) -> None:
+    out += magic
+    out += struct.pack("<HH", VERSION, 0)
+
+
+def read_header(buf: memoryview, magic: bytes) -> int:
+    if len(buf) < 8 or bytes(buf[:4]) != magic:
+        raise WireError("bad magic")
+    version, _flags = struct.unpack_from("<HH", buf, 4)
+    if version == 0 or version > VERSION:
+        raise WireError(f"unsupported version {version}")
+    return 8
+
+
+def write_column_block(out: bytearray, rows: int, columns: list[tuple[int, int, bytes]]) -> None:
+    _pad(out)
+    out += struct.pack("<II", rows, len(columns))
+    for tag, dtype, payload in columns:
+        out += struct.pack("<HHIQ", tag, dtype, 0, len(payload))
+        out += payload
+        _pad(out)
+
+
+def read_column_block(buf: memoryview, pos: int) -> tuple[int, dict[int, Any], int]:
+    """Parse a column block at `pos`; returns (rows, {tag: values}, next_pos).
+
+    Numeric columns come back as `array`s, string columns as `list[str]`.
+    """
+    pos += -pos % 8
+    try:
+        rows, count = struct.unpack_from("<II", buf, pos)
+        pos += 8
+        columns: dict[int, Any] = {}
+        for _ in range(count):
+            tag, dtype, _reserved, byte_len = struct.unpack_from("<HHIQ", buf, pos)
+            pos += 16
+            payload = buf[pos : pos + byte_len]
+            if len(payload) != byte_len:
+                raise WireError("truncated column")
+            pos += byte_len
+            pos += -pos % 8
+            if dtype in _TYPECODES:
+                values = array(_TYPECODES[dtype])
+                values.frombytes(payload)
+                if _BIG_ENDIAN:
+                    values.byteswap()
+                if len(values) != rows:
+                    raise WireError("column length does not match row count")
+                columns[tag] = values
+            elif dtype == DTYPE_STRINGS:
+                offsets = array("I")
+                offsets.frombytes(payload[: (rows + 1) * 4])
+                if _BIG_ENDIAN:
+                    offsets.byteswap()
+                blob = bytes(payload[(rows + 1) * 4 :])
+                columns[tag] = [
+                    blob[offsets[i] : offsets[i + 1]].decode("utf-8") for i in range(rows)
+                ]
+    except struct.error as exc:
+        raise WireError(str(exc)) from exc
+    return rows, columns, pos
+
+
+def orientation_mask(box: Any) -> int:
+    """Allowed orientations of a box dict (`orientations` mask, narrowed by `upright`)."""
+    mask = int(box.get("orientations", ANY_ORIENTATION))
+    if box.get("upright"):
+        mask &= UPRIGHT_ORIENTATIONS
+    return mask
+
+
+def box_columns(boxes: list[Any]) -> tuple[int, list[tuple[int, int, bytes]]]:
+    """Column-encode boxes with the same defaults as the engine's dict path."""
+    ids = [str(b["id"] if "id" in b else b["sku"]) for b in boxes]
+    columns = [
+        strings_column(COL_ID, ids),
+        f64_column(COL_W, (float(b["w"]) for b in boxes)),
+        f64_column(COL_H, (float(b["h"]) for b in boxes)),
+        f64_column(COL_D, (float(b["d"]) for b in boxes)),
+        f64_column(COL_WEIGHT, (float(b.get("weight", 1.0)) for b in boxes)),
+        i32_column(COL_PRIORITY, (int(b.get("priority", 1)) for b in boxes)),
+    ]
+    masks = [orientation_mask(b) for b in boxes]
+    if any(m != ANY_ORIENTATION for m in masks):
+        columns.append(i32_column(COL_ORIENTATIONS, masks))
+    max_loads = [float(b.get("max_load", 0.0)) for b in boxes]
+    if any(m != 0.0 for m in max_loads):
+        columns.append(f64_column(COL_MAX_LOAD, max_loads))
+    fragile = [1 if b.get("fragile") else 0 for b in boxes]
+    if any(fragile):
+        columns.append(i32_column(COL_FRAGILE, fragile))
+    drops = [int(b.get("drop", 0)) for b in boxes]
+    if any(drops):
+        columns.append(i32_column(COL_DROP, drops))
+    return len(boxes), columns
+
+
+def _write_params(out: bytearray, params: dict[str, Any]) -> None:
+    entries = bytearray()
+    count = 0
+    for key, value in params.items():
+        key_bytes = str(key).encode("utf-8")
+        if isinstance(value, str):
+            text = value.encode("utf-8")
+            entries += struct.pack("<HBB", len(key_bytes), PARAM_STRING, 0) + key_bytes
+            entries += struct.pack("<I", len(text)) + text
+        elif isinstance(value, (bool, int, float)):
+            entries += struct.pack("<HBB", len(key_bytes), PARAM_NUMBER, 0) + key_bytes
+            entries += struct.pack("<d", float(value))
+        else:
+            # Structured params are not part of v1; callers fall back to JSON for those.
+            raise WireError(f"param {key!r} is not a number or string")
+        count += 1
+    out += struct.pack("<I", count)
+    out += entries
+
+
+def encode_request(truck: dict[str, Any], boxes: list[Any], params: dict[str, Any]) -> bytes:
+    """Encode an optimize request for the engine `/optimize` endpoint."""
+    limits = sorted(k for k in TRUCK_BALANCE_FIELDS if truck.get(k))
+    if limits:
+        # The header only carries `f64 truck[4]`; callers fall back to JSON for these.
+        raise WireError(f"truck balance limits {limits} are not part of v1")
+    out = bytearray()
+    write_header(out, REQUEST_MAGIC)
+    out += struct.pack(
+        "<4d",
+        float(truck.get("w", 0.0)),
+        float(truck.get("h", 0.0)),
+        float(truck.get("d", 0.0)),
+        float(truck.get("max_weight", 12_000.0)),
+    )
+    rows, columns = box_columns(boxes)
+    write_column_block(out, rows, columns)
+    _write_params(out, params)
+    return bytes(out)
+
+
+def decode_result(data: bytes) -> dict[str, Any]:
+    """Decode an engine result into the same shape as the JSON response."""
+    buf = memoryview(data)
+    pos = read_header(buf, RESULT_MAGIC)
+
+    rows, cols, pos = read_column_block(buf, pos)
+    try:
+        ids, xs, ys, zs = cols[COL_ID], cols[COL_X], cols[COL_Y], cols[COL_Z]
+        ws, hs, ds = cols[COL_W], cols[COL_H], cols[COL_D]
+    except KeyError as exc:
+        raise WireError(f"missing placement column {exc}") from exc
+    placed = [
+        {"id": ids[i], "x": xs[i], "y": ys[i], "z": zs[i], "w": ws[i], "h": hs[i], "d": ds[i]}
+        for i in range(rows)
+    ]
+
+    _rows, cols, pos = read_column_block(buf, pos)
+    unplaced = list(cols.get(COL_ID, []))
+
+    metrics: dict[str, float] = {}
+    try:
+        (count,) = struct.unpack_from("<I", buf, pos)
+        pos += 4
+        for _ in range(count):
+            (key_len,) = struct.unpack_from("<H", buf, pos)
+            pos += 2
+            key = bytes(buf[pos : pos + key_len]).decode("utf-8")
+            pos += key_len
+            (metrics[key],) = struct.unpack_from("<d", buf, pos)
+            pos += 8
+    except struct.error as exc:
+        raise WireError(str(exc)) from exc
+
+    return {"placed": placed, "unplaced": unplaced, "metrics": metrics}
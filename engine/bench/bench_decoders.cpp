@@ -0,0 +1,107 @@
+// Compares the placement decoders on synthetic manifests.
+//
+//   bench_decoders [boxes...]   (default: 100 300 1200)
+//
+// For each size it times one decode of the volume-descending order and a short GA run
+// per decoder, and prints utilization, placed count and wall time. Only sizes that
+// overflow the truck tell the decoders apart; 1200 boxes is about twice its volume.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "decoder.h"
+#include "optimizer.h"
+#include "packing_common.h"
+#include "test_common.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Named {
+  const char* name;
+  engine::DecoderKind kind;
+  double fixed_unit;
+  engine::PhysicsMode physics;
+};
+
+constexpr auto kFull = engine::PhysicsMode::kFull;
+
+constexpr Named kDecoders[] = {
+    {"extreme_points", engine::DecoderKind::kExtremePoints, 0, kFull},
+    {"ep_fixed_mm", engine::DecoderKind::kExtremePoints, 0.001, kFull},
+    {"ep_support", engine::DecoderKind::kExtremePoints, 0, engine::PhysicsMode::kSupportOnly},
+    {"ep_no_physics", engine::DecoderKind::kExtremePoints, 0, engine::PhysicsMode::kNone},
+    {"wall", engine::DecoderKind::kWallBuilding, 0, kFull},
+    {"ems", engine::DecoderKind::kEmptySpaces, 0, kFull},
+};
+
+size_t count_overlaps(const engine::Result& r) {
+  size_t overlaps = 0;
+  for (size_t i = 0; i < r.placed.size(); ++i) {
+    for (size_t j = i + 1; j < r.placed.size(); ++j) overlaps += engine_test::overlap(r.placed[i], r.placed[j]);
+  }
+  return overlaps;
+}
+
+double ms_since(Clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+void report(const char* mode, const char* decoder, size_t n, const engine::Result& r, double ms) {
+  std::printf("%-8s %-15s %6zu %7zu %8.2f%% %9.1f %8zu\n", mode, decoder, n, r.placed.size(), r.utilization * 100.0, ms,
+              count_overlaps(r));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<size_t> sizes;
+  for (int i = 1; i < argc; ++i) sizes.push_back(static_cast<size_t>(std::strtoul(argv[i], nullptr, 10)));
+  if (sizes.empty()) sizes = {100, 300, 1200};
+
+  const engine::Truck truck{2.4, 2.6, 13.6, 24000};
+
+  std::printf("placed-box kernels: %s\n", engine::packing::placed_kernels_isa());
+  std::printf("%-8s %-15s %6s %7s %9s %9s %8s\n", "mode", "decoder", "boxes", "placed", "util", "ms", "overlaps");
+  for (size_t n : sizes) {
+    const auto inst = engine::prepare_instance(truck, engine_test::make_boxes(n, static_cast<uint32_t>(n)));
+
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return inst.volumes[a] > inst.volumes[b]; });
+
+    for (const auto& d : kDecoders) {
+      engine::PhysicsModel physics;
+      physics.mode = d.physics;
+      const auto t0 = Clock::now();
+      engine::Result r;
+      if (d.fixed_unit > 0) {
+        const auto geometry = engine::make_fixed_geometry(inst, d.fixed_unit);
+        auto decoder = engine::make_fixed_point_decoder(inst, geometry, physics);
+        for (size_t idx : order) decoder->place(idx);
+        r = decoder->result();
+      } else {
+        r = engine::decode_order(inst, d.kind, order, physics);
+      }
+      report("decode", d.name, n, r, ms_since(t0));
+    }
+    for (const auto& d : kDecoders) {
+      engine::GaParams params;
+      params.population = 10;
+      params.generations = 6;
+      params.slab_mode = engine::SlabMode::kOff;
+      params.decoder = d.kind;
+      params.fixed_unit = d.fixed_unit;
+      params.physics.mode = d.physics;
+      const auto t0 = Clock::now();
+      const auto r = engine::optimize_ga(inst, params);
+      report("ga", d.name, n, r, ms_since(t0));
+    }
+  }
+  return 0;
+}
@@ -1,12 +1,65 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "batch.h"
+#include "dataset_file.h"
+#include "dataset_registry.h"
 #include "engine_types.h"
+#include "fleet.h"
+#include "job_scheduler.h"
+#include "optimizer.h"
+#include "packer.h"
+#include "placement_delta.h"
+#include "result_cache.h"
+#include "thread_pool.h"
+#include "warm_start.h"
+#include "wire_format.h"
 
 namespace py = pybind11;
 
-namespace engine {
-Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int population, int generations, double mutation_rate, uint32_t seed);
+static engine::DatasetRegistry& registry() {
+  static engine::DatasetRegistry r(size_t{512} << 20);
+  return r;
+}
+
+// Raised to Python as engine_bindings.QueueFullError.
+struct JobQueueFull : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+static std::mutex g_jobs_mu;
+static std::unique_ptr<engine::JobScheduler> g_jobs;
+
+static engine::JobScheduler& jobs() {
+  std::lock_guard<std::mutex> lock(g_jobs_mu);
+  if (!g_jobs) {
+    const size_t workers = std::max(1u, std::thread::hardware_concurrency() / 2);
+    g_jobs = std::make_unique<engine::JobScheduler>(workers, 64);
+  }
+  return *g_jobs;
+}
+
+// Shared by every optimize_batch call; held by shared_ptr so reconfiguring never pulls
+// the pool out from under a running batch.
+static std::mutex g_pool_mu;
+static std::shared_ptr<engine::WorkStealingPool> g_pool;
+
+static std::shared_ptr<engine::WorkStealingPool> batch_pool() {
+  std::lock_guard<std::mutex> lock(g_pool_mu);
+  if (!g_pool) g_pool = std::make_shared<engine::WorkStealingPool>(std::max(1u, std::thread::hardware_concurrency()));
+  return g_pool;
 }
 
 static engine::Truck truck_from_dict(const py::dict& d) {
@@ -19,6 +72,19 @@ static engine::Truck truck_from_dict(const py::dict& d) {
   } else {
     t.max_weight = 12000.0;
   }
+  // Balance limits: axle positions in metres from the front wall, loads in kg.
+  for (auto [key, field] : {std::pair{"front_axle_z", &engine::Truck::front_axle_z},
+                            std::pair{"rear_axle_z", &engine::Truck::rear_axle_z},
+                            std::pair{"front_axle_max", &engine::Truck::front_axle_max},
+                            std::pair{"rear_axle_max", &engine::Truck::rear_axle_max},
+                            std::pair{"max_lateral_offset", &engine::Truck::max_lateral_offset}}) {
+    if (!d.contains(key)) continue;
+    t.*field = py::float_(d[key]).cast<double>();
+    if (!(t.*field >= 0)) throw py::value_error(std::string(key) + " must be >= 0");
+  }
+  if ((t.front_axle_max > 0 || t.rear_axle_max > 0) && !(t.rear_axle_z > t.front_axle_z)) {
+    throw py::value_error("axle limits need rear_axle_z > front_axle_z");
+  }
   return t;
 }
 
@@ -39,51 +105,743 @@ static engine::Box box_from_any(const py::handle& obj) {
   } else {
     b.priority = 1;
   }
+  // "orientations": mask as in engine_types.h; "upright": true keeps h vertical.
+  if (d.contains("orientations")) {
+    const int mask = py::int_(d["orientations"]).cast<int>();
+    if (mask <= 0 || mask > engine::kAnyOrientation) throw py::value_error("orientations must be a mask in 1..63");
+    b.orientations = static_cast<uint8_t>(mask);
+  }
+  if (d.contains("upright") && py::bool_(d["upright"]).cast<bool>()) b.orientations &= engine::kUprightOrientations;
+  // "max_load": kg the top may carry (0 derives it); "fragile": true keeps everything off it.
+  if (d.contains("max_load")) {
+    b.max_load = py::float_(d["max_load"]).cast<double>();
+    if (!(b.max_load >= 0)) throw py::value_error("max_load must be >= 0");
+  }
+  if (d.contains("fragile")) b.fragile = py::bool_(d["fragile"]).cast<bool>();
+  // "drop": delivery stop, 1 = unloaded first; 0 stays on board to the end.
+  if (d.contains("drop")) {
+    b.drop = py::int_(d["drop"]).cast<int>();
+    if (b.drop < 0) throw py::value_error("drop must be >= 0");
+  }
   return b;
 }
 
+// Plans of recent runs, for "warm_start": true.
+static engine::WarmStartCache& warm_starts() {
+  static engine::WarmStartCache c(64);
+  return c;
+}
+
+static engine::GaParams params_from_dict(const py::dict& params) {
+  engine::GaParams p;
+  if (params.contains("population")) p.population = py::int_(params["population"]).cast<int>();
+  if (params.contains("generations")) p.generations = py::int_(params["generations"]).cast<int>();
+  if (params.contains("mutation_rate")) p.mutation_rate = py::float_(params["mutation_rate"]).cast<double>();
+  if (params.contains("seed")) p.seed = py::int_(params["seed"]).cast<uint32_t>();
+  if (params.contains("slab_mode")) {
+    const std::string mode = py::str(params["slab_mode"]);
+    if (mode == "auto") {
+      p.slab_mode = engine::SlabMode::kAuto;
+    } else if (mode == "on") {
+      p.slab_mode = engine::SlabMode::kOn;
+    } else if (mode == "off") {
+      p.slab_mode = engine::SlabMode::kOff;
+    } else {
+      throw py::value_error("slab_mode must be 'auto', 'on' or 'off'");
+    }
+  }
+  if (params.contains("slab_boxes")) p.slab_boxes = py::int_(params["slab_boxes"]).cast<size_t>();
+  if (params.contains("blocks")) p.blocks = py::bool_(params["blocks"]).cast<bool>();
+  if (params.contains("block_boxes")) p.block_boxes = py::int_(params["block_boxes"]).cast<size_t>();
+  if (params.contains("decoder")) {
+    const std::string decoder = py::str(params["decoder"]);
+    if (decoder == "extreme_points") {
+      p.decoder = engine::DecoderKind::kExtremePoints;
+    } else if (decoder == "wall") {
+      p.decoder = engine::DecoderKind::kWallBuilding;
+    } else if (decoder == "ems") {
+      p.decoder = engine::DecoderKind::kEmptySpaces;
+    } else {
+      throw py::value_error("decoder must be 'extreme_points', 'wall' or 'ems'");
+    }
+  }
+  if (params.contains("local_search_elites")) {
+    p.local_search_elites = py::int_(params["local_search_elites"]).cast<int>();
+    if (p.local_search_elites < 0) throw py::value_error("local_search_elites must be >= 0");
+  }
+  if (params.contains("local_search_moves")) {
+    p.local_search_moves = py::int_(params["local_search_moves"]).cast<int>();
+    if (p.local_search_moves < 0) throw py::value_error("local_search_moves must be >= 0");
+  }
+  if (params.contains("fixed_unit")) {
+    p.fixed_unit = py::float_(params["fixed_unit"]).cast<double>();
+    if (!(p.fixed_unit >= 0)) throw py::value_error("fixed_unit must be >= 0");
+  }
+  if (params.contains("physics")) {
+    const std::string mode = py::str(params["physics"]);
+    if (mode == "full") {
+      p.physics.mode = engine::PhysicsMode::kFull;
+    } else if (mode == "support") {
+      p.physics.mode = engine::PhysicsMode::kSupportOnly;
+    } else if (mode == "none") {
+      p.physics.mode = engine::PhysicsMode::kNone;
+    } else {
+      throw py::value_error("physics must be 'full', 'support' or 'none'");
+    }
+  }
+  if (params.contains("min_support")) {
+    p.physics.min_support = py::float_(params["min_support"]).cast<double>();
+    if (!(p.physics.min_support >= 0 && p.physics.min_support <= 1)) throw py::value_error("min_support must be in [0, 1]");
+  }
+  if (params.contains("max_stack_multiplier")) {
+    p.physics.max_stack_multiplier = py::float_(params["max_stack_multiplier"]).cast<double>();
+    if (!(p.physics.max_stack_multiplier > 0)) throw py::value_error("max_stack_multiplier must be > 0");
+  }
+  if (params.contains("max_pressure")) {
+    p.physics.max_pressure = py::float_(params["max_pressure"]).cast<double>();
+    if (!(p.physics.max_pressure > 0)) throw py::value_error("max_pressure must be > 0");
+  }
+  // Warm start: "seed_orders" is a list of box-id lists; "previous_result" an earlier
+  // result, seeding its placed then unplaced ids.
+  const char* bad_seed = "seed_orders and previous_result must name boxes by id";
+  try {
+    if (params.contains("seed_orders")) {
+      p.seed_orders = params["seed_orders"].cast<std::vector<std::vector<std::string>>>();
+    }
+    if (params.contains("previous_result") && !params["previous_result"].is_none()) {
+      const auto prev = params["previous_result"].cast<py::dict>();
+      if (!prev.contains("placed")) throw py::value_error(bad_seed);
+      std::vector<std::string> order;
+      for (auto item : prev["placed"].cast<py::list>()) {
+        const auto placement = item.cast<py::dict>();
+        if (!placement.contains("id")) throw py::value_error(bad_seed);
+        order.push_back(placement["id"].cast<std::string>());
+      }
+      if (prev.contains("unplaced")) {
+        for (const auto& id : prev["unplaced"].cast<std::vector<std::string>>()) order.push_back(id);
+      }
+      p.seed_orders.push_back(std::move(order));
+    }
+  } catch (const py::cast_error&) {
+    throw py::value_error(bad_seed);
+  }
+  if (params.contains("warm_start") && py::bool_(params["warm_start"]).cast<bool>()) p.warm_start = &warm_starts();
+  return p;
+}
+
+// Large instances decode GA offspring and pack slabs on the batch pool; results are the
+// same either way.
+static void attach_pool(engine::GaParams& p, size_t boxes) {
+  if (boxes <= 150) return;
+  auto pool = batch_pool();
+  p.parallel_for = [pool](size_t n, const std::function<void(size_t)>& fn) { pool->parallel_for(n, fn); };
+}
+
+// Plans of the blocking optimize calls; jobs and streams report GA progress, so they run.
+static engine::ResultCache& results() {
+  static engine::ResultCache c(size_t{64} << 20);
+  return c;
+}
+
+static engine::Result run_optimize(const engine::PreparedInstance& inst, const py::dict& params) {
+  auto p = params_from_dict(params);
+  attach_pool(p, inst.boxes.size());
+  py::gil_scoped_release release;
+  const auto key = engine::ResultCache::key(inst, p);
+  if (key) {
+    if (auto hit = results().get(*key)) return *hit;
+  }
+  engine::Result r = engine::optimize_ga(inst, p);
+  if (key) results().put(*key, r);
+  return r;
+}
+
+static std::vector<engine::Box> boxes_from_list(const py::list& boxes) {
+  std::vector<engine::Box> b;
+  b.reserve(static_cast<size_t>(py::len(boxes)));
+  for (auto item : boxes) b.push_back(box_from_any(item));
+  return b;
+}
+
+static engine::wire::Request decode_wire(const py::bytes& data) {
+  char* buf = nullptr;
+  Py_ssize_t len = 0;
+  if (PyBytes_AsStringAndSize(data.ptr(), &buf, &len) != 0) throw py::error_already_set();
+  try {
+    return engine::wire::decode_request(reinterpret_cast<const uint8_t*>(buf), static_cast<size_t>(len));
+  } catch (const std::runtime_error& e) {
+    throw py::value_error(e.what());
+  }
+}
+
+static py::dict registered_info(const std::string& dataset_id, const engine::PreparedInstance& inst) {
+  py::dict out;
+  out["dataset_id"] = dataset_id;
+  out["count"] = inst.boxes.size();
+  out["types"] = inst.type_count;
+  out["bytes"] = inst.memory_bytes();
+  return out;
+}
+
+static py::dict register_instance(const std::string& dataset_id, engine::Truck truck, std::vector<engine::Box> boxes) {
+  std::shared_ptr<const engine::PreparedInstance> inst;
+  try {
+    py::gil_scoped_release release;
+    inst = registry().put(dataset_id, engine::prepare_instance(truck, std::move(boxes)));
+  } catch (const std::length_error& e) {
+    // Surfaced as MemoryError so the service can answer 413.
+    PyErr_SetString(PyExc_MemoryError, e.what());
+    throw py::error_already_set();
+  }
+  return registered_info(dataset_id, *inst);
+}
+
+static py::dict placement_to_dict(const engine::Placement& p) {
+  py::dict item;
+  item["id"] = p.id;
+  item["x"] = p.x;
+  item["y"] = p.y;
+  item["z"] = p.z;
+  item["w"] = p.w;
+  item["h"] = p.h;
+  item["d"] = p.d;
+  return item;
+}
+
+static py::dict result_to_dict(const engine::Result& r) {
+  py::list placed;
+  for (const auto& p : r.placed) placed.append(placement_to_dict(p));
+
+  py::dict out;
+  out["placed"] = placed;
+  out["unplaced"] = r.unplaced;
+  py::dict metrics;
+  metrics["used_volume"] = r.used_volume;
+  metrics["total_volume"] = r.total_volume;
+  metrics["utilization"] = r.utilization;
+  metrics["total_weight"] = r.total_weight;
+  metrics["cog_x"] = r.cog_x;
+  metrics["cog_y"] = r.cog_y;
+  metrics["cog_z"] = r.cog_z;
+  metrics["front_axle_load"] = r.front_axle_load;
+  metrics["rear_axle_load"] = r.rear_axle_load;
+  if (r.local_search_ms > 0) {
+    metrics["local_search_gain"] = r.local_search_gain;
+    metrics["local_search_ms"] = r.local_search_ms;
+  }
+  out["metrics"] = metrics;
+  return out;
+}
+
+static py::object result_out(const engine::Result& r, bool binary_result) {
+  if (!binary_result) return result_to_dict(r);
+  const auto encoded = engine::wire::encode_result(r);
+  return py::bytes(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+}
+
+static py::dict params_from_wire(const std::vector<engine::wire::Param>& params) {
+  py::dict d;
+  for (const auto& p : params) {
+    if (p.type == engine::wire::kParamString) {
+      d[py::str(p.key)] = py::str(p.text);
+    } else {
+      d[py::str(p.key)] = py::float_(p.number);
+    }
+  }
+  return d;
+}
+
+static uint64_t submit_instance(std::shared_ptr<const engine::PreparedInstance> inst,
+                                const py::dict& params,
+                                int priority,
+                                const std::string& label) {
+  // Params are parsed here, under the GIL; the task itself never touches Python.
+  engine::JobScheduler::Task task = [inst, p = params_from_dict(params)](
+                                        const std::function<void(const engine::GaProgress&)>& on_progress,
+                                        const std::atomic<bool>& cancel) {
+    engine::GaParams run = p;
+    run.on_progress = on_progress;
+    run.cancel = &cancel;
+    attach_pool(run, inst->boxes.size());
+    return engine::optimize_ga(*inst, run);
+  };
+  try {
+    return jobs().submit(priority, label, std::move(task));
+  } catch (const std::length_error& e) {
+    throw JobQueueFull(e.what());
+  }
+}
+
+static py::dict progress_to_dict(const engine::GaProgress& p) {
+  py::dict out;
+  out["generation"] = p.generation;
+  out["generations"] = p.generations;
+  out["best_score"] = p.best_score;
+  out["utilization"] = p.utilization;
+  out["placed"] = p.placed;
+  out["unplaced"] = p.unplaced;
+  out["local_search_gain"] = p.local_search_gain;
+  out["local_search_ms"] = p.local_search_ms;
+  return out;
+}
+
+// Runs the GA on the calling thread and hands `on_event` one dict per progress report:
+// the progress fields plus `improved` and `delta` ({upserts, removed}) against the
+// previous report. The diff is computed without the GIL; only changed placements become
+// Python objects. Returning False from `on_event` stops the run after the current
+// generation (e.g. the client went away).
+static py::dict stream_instance(const engine::PreparedInstance& inst,
+                                const py::dict& params,
+                                const py::function& on_event,
+                                int interval_ms) {
+  engine::GaParams p = params_from_dict(params);
+  std::atomic<bool> cancel{false};
+  engine::PlacementDiffer differ;
+  std::unique_ptr<py::error_already_set> failure;
+
+  p.progress_interval_ms = interval_ms;
+  p.cancel = &cancel;
+  attach_pool(p, inst.boxes.size());
+  p.on_progress = [&](const engine::GaProgress& g) {
+    if (cancel.load(std::memory_order_relaxed)) return;
+    const auto delta = differ.update(*g.incumbent);
+
+    py::gil_scoped_acquire gil;
+    try {
+      py::dict event = progress_to_dict(g);
+      event["improved"] = g.improved;
+      py::list upserts;
+      for (const auto& pl : delta.upserts) upserts.append(placement_to_dict(pl));
+      py::dict d;
+      d["upserts"] = upserts;
+      d["removed"] = delta.removed;
+      event["delta"] = d;
+      const py::object keep_going = on_event(event);
+      if (!keep_going.is_none() && !keep_going.cast<bool>()) cancel.store(true);
+    } catch (py::error_already_set& e) {
+      failure = std::make_unique<py::error_already_set>(std::move(e));
+      cancel.store(true);
+    }
+  };
+
+  engine::Result r;
+  {
+    py::gil_scoped_release release;
+    r = engine::optimize_ga(inst, p);
+  }
+  if (failure) {
+    failure->restore();
+    throw py::error_already_set();
+  }
+  return result_to_dict(r);
+}
+
+static std::vector<engine::TruckType> fleet_from_list(const py::list& fleet) {
+  std::vector<engine::TruckType> types;
+  for (auto item : fleet) {
+    const auto d = py::reinterpret_borrow<py::dict>(item);
+    engine::TruckType t;
+    t.truck = truck_from_dict(d);
+    t.id = d.contains("id") ? std::string(py::str(d["id"])) : "truck-" + std::to_string(types.size());
+    t.count = d.contains("count") ? py::int_(d["count"]).cast<int>() : 1;
+    types.push_back(std::move(t));
+  }
+  return types;
+}
+
+static py::dict run_fleet(const std::vector<engine::TruckType>& fleet,
+                          const std::vector<engine::Box>& boxes,
+                          const py::dict& params) {
+  engine::FleetParams p;
+  p.ga = params_from_dict(params);
+  if (params.contains("fill_target")) p.fill_target = py::float_(params["fill_target"]).cast<double>();
+
+  engine::FleetResult r;
+  {
+    const auto pool = batch_pool();
+    py::gil_scoped_release release;
+    r = engine::optimize_fleet(fleet, boxes, p, pool.get());
+  }
+
+  py::list trucks;
+  for (const auto& t : r.trucks) {
+    py::dict item = result_to_dict(t.result);
+    item["truck_type"] = t.type_id;
+    item["index"] = t.index;
+    py::dict dims;
+    dims["w"] = t.truck.w;
+    dims["h"] = t.truck.h;
+    dims["d"] = t.truck.d;
+    dims["max_weight"] = t.truck.max_weight;
+    item["truck"] = dims;
+    trucks.append(item);
+  }
+  py::dict out;
+  out["trucks"] = trucks;
+  out["unplaced"] = r.unplaced;
+  py::dict metrics;
+  metrics["trucks_used"] = r.trucks_used;
+  metrics["used_volume"] = r.used_volume;
+  metrics["capacity_volume"] = r.capacity_volume;
+  metrics["utilization"] = r.utilization;
+  metrics["total_weight"] = r.total_weight;
+  out["metrics"] = metrics;
+  return out;
+}
+
 PYBIND11_MODULE(engine_bindings, m) {
   m.doc() = "High-performance logistics optimization engine";
 
   m.def(
       "optimize",
       [](py::dict truck, py::list boxes, py::dict params) {
-        const auto t = truck_from_dict(truck);
-
-        std::vector<engine::Box> b;
-        b.reserve(static_cast<size_t>(py::len(boxes)));
-        for (auto item : boxes) b.push_back(box_from_any(item));
-
-        const int population = params.contains("population") ? py::int_(params["population"]).cast<int>() : 40;
-        const int generations = params.contains("generations") ? py::int_(params["generations"]).cast<int>() : 40;
-        const double mutation_rate = params.contains("mutation_rate") ? py::float_(params["mutation_rate"]).cast<double>() : 0.08;
-        const uint32_t seed = params.contains("seed") ? py::int_(params["seed"]).cast<uint32_t>() : 12345u;
-
-        const auto r = engine::optimize_ga(t, b, population, generations, mutation_rate, seed);
-
-        py::list placed;
-        for (const auto& p : r.placed) {
-          py::dict item;
-          item["id"] = p.id;
-          item["x"] = p.x;
-          item["y"] = p.y;
-          item["z"] = p.z;
-          item["w"] = p.w;
-          item["h"] = p.h;
-          item["d"] = p.d;
-          placed.append(item);
+        const auto inst = engine::prepare_instance(truck_from_dict(truck), boxes_from_list(boxes));
+        return result_to_dict(run_optimize(inst, params));
+      },
+      py::arg("truck"), py::arg("boxes"), py::arg("params") = py::dict());
+
+  m.attr("WIRE_CONTENT_TYPE") = engine::wire::kContentType;
+
+  m.def(
+      "optimize_wire",
+      [](py::bytes data, bool binary_result) -> py::object {
+        // Decode straight from the request body; no per-box Python objects are created.
+        auto req = decode_wire(data);
+        const auto inst = engine::prepare_instance(req.truck, std::move(req.boxes));
+        return result_out(run_optimize(inst, params_from_wire(req.params)), binary_result);
+      },
+      py::arg("data"), py::arg("binary_result") = true);
+
+  m.def(
+      "encode_result",
+      [](py::dict result) {
+        engine::Result r{};
+        for (auto item : py::reinterpret_borrow<py::list>(result["placed"])) {
+          auto d = py::reinterpret_borrow<py::dict>(item);
+          r.placed.push_back(engine::Placement{py::str(d["id"]), py::float_(d["x"]), py::float_(d["y"]),
+                                               py::float_(d["z"]), py::float_(d["w"]), py::float_(d["h"]),
+                                               py::float_(d["d"])});
+        }
+        r.unplaced = result["unplaced"].cast<std::vector<std::string>>();
+        auto metrics = py::reinterpret_borrow<py::dict>(result["metrics"]);
+        r.used_volume = py::float_(metrics["used_volume"]);
+        r.total_volume = py::float_(metrics["total_volume"]);
+        r.utilization = py::float_(metrics["utilization"]);
+        r.total_weight = py::float_(metrics["total_weight"]);
+        for (auto [key, field] : {std::pair{"cog_x", &engine::Result::cog_x}, std::pair{"cog_y", &engine::Result::cog_y},
+                                  std::pair{"cog_z", &engine::Result::cog_z},
+                                  std::pair{"front_axle_load", &engine::Result::front_axle_load},
+                                  std::pair{"rear_axle_load", &engine::Result::rear_axle_load},
+                                  std::pair{"local_search_gain", &engine::Result::local_search_gain},
+                                  std::pair{"local_search_ms", &engine::Result::local_search_ms}}) {
+          if (metrics.contains(key)) r.*field = py::float_(metrics[key]);
+        }
+
+        const auto encoded = engine::wire::encode_result(r);
+        return py::bytes(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+      },
+      py::arg("result"));
+
+  m.attr("DATASET_SUFFIX") = engine::kDatasetSuffix;
+
+  // Dataset registry: upload once, then optimize by id without re-sending or re-parsing.
+  m.def(
+      "configure_registry", [](size_t capacity_bytes) { registry().set_capacity(capacity_bytes); },
+      py::arg("capacity_bytes"));
+
+  m.def(
+      "register_dataset",
+      [](const std::string& dataset_id, py::dict truck, py::list boxes) {
+        return register_instance(dataset_id, truck_from_dict(truck), boxes_from_list(boxes));
+      },
+      py::arg("dataset_id"), py::arg("truck"), py::arg("boxes"));
+
+  m.def(
+      "register_dataset_wire",
+      [](const std::string& dataset_id, py::bytes data) {
+        auto req = decode_wire(data);
+        return register_instance(dataset_id, req.truck, std::move(req.boxes));
+      },
+      py::arg("dataset_id"), py::arg("data"));
+
+  m.def(
+      "register_dataset_file",
+      [](const std::string& dataset_id, const std::string& path) {
+        // The columnar file is mapped, not parsed; boxes are read straight from its columns.
+        engine::Truck truck;
+        std::vector<engine::Box> boxes;
+        try {
+          engine::MappedDataset ds(path);
+          truck = ds.truck();
+          boxes = ds.boxes();
+        } catch (const std::runtime_error& e) {
+          throw py::value_error(e.what());
+        }
+        return register_instance(dataset_id, truck, std::move(boxes));
+      },
+      py::arg("dataset_id"), py::arg("path"));
+
+  m.def(
+      "optimize_registered",
+      [](const std::string& dataset_id, py::dict params, bool binary_result) -> py::object {
+        const auto inst = registry().get(dataset_id);
+        if (!inst) throw py::key_error(dataset_id);
+        return result_out(run_optimize(*inst, params), binary_result);
+      },
+      py::arg("dataset_id"), py::arg("params") = py::dict(), py::arg("binary_result") = false);
+
+  m.def(
+      "dataset_info",
+      [](const std::string& dataset_id) -> py::object {
+        const auto inst = registry().get(dataset_id);
+        if (!inst) return py::none();
+        return registered_info(dataset_id, *inst);
+      },
+      py::arg("dataset_id"));
+
+  m.def(
+      "unregister_dataset", [](const std::string& dataset_id) { return registry().erase(dataset_id); },
+      py::arg("dataset_id"));
+
+  m.def("registry_stats", []() {
+    const auto s = registry().stats();
+    py::dict out;
+    out["entries"] = s.entries;
+    out["bytes"] = s.bytes;
+    out["capacity_bytes"] = s.capacity_bytes;
+    out["evictions"] = s.evictions;
+    return out;
+  });
+
+  m.def(
+      "configure_result_cache",
+      [](size_t capacity_bytes, const std::string& spill_dir) { results().configure(capacity_bytes, spill_dir); },
+      py::arg("capacity_bytes"), py::arg("spill_dir") = "");
+
+  m.def("result_cache_stats", []() {
+    const auto s = results().stats();
+    py::dict out;
+    out["entries"] = s.entries;
+    out["bytes"] = s.bytes;
+    out["capacity_bytes"] = s.capacity_bytes;
+    out["hits"] = s.hits;
+    out["disk_hits"] = s.disk_hits;
+    out["misses"] = s.misses;
+    out["evictions"] = s.evictions;
+    out["spilled"] = s.spilled;
+    return out;
+  });
+
+  // Streaming: best-so-far plans as they improve, for Server-Sent Events.
+  m.def(
+      "optimize_stream",
+      [](py::dict truck, py::list boxes, py::dict params, py::function on_event, int interval_ms) {
+        const auto inst = engine::prepare_instance(truck_from_dict(truck), boxes_from_list(boxes));
+        return stream_instance(inst, params, on_event, interval_ms);
+      },
+      py::arg("truck"), py::arg("boxes"), py::arg("params"), py::arg("on_event"), py::arg("interval_ms") = 250);
+
+  m.def(
+      "optimize_stream_wire",
+      [](py::bytes data, py::function on_event, int interval_ms) {
+        auto req = decode_wire(data);
+        const auto inst = engine::prepare_instance(req.truck, std::move(req.boxes));
+        return stream_instance(inst, params_from_wire(req.params), on_event, interval_ms);
+      },
+      py::arg("data"), py::arg("on_event"), py::arg("interval_ms") = 250);
+
+  m.def(
+      "optimize_stream_registered",
+      [](const std::string& dataset_id, py::dict params, py::function on_event, int interval_ms) {
+        const auto inst = registry().get(dataset_id);
+        if (!inst) throw py::key_error(dataset_id);
+        return stream_instance(*inst, params, on_event, interval_ms);
+      },
+      py::arg("dataset_id"), py::arg("params"), py::arg("on_event"), py::arg("interval_ms") = 250);
+
+  // Batches: many independent instances in one call, scheduled on a shared pool.
+  m.def(
+      "configure_batch",
+      [](size_t threads) {
+        std::shared_ptr<engine::WorkStealingPool> old;
+        {
+          std::lock_guard<std::mutex> lock(g_pool_mu);
+          old = std::move(g_pool);
+          g_pool = std::make_shared<engine::WorkStealingPool>(threads);
+        }
+        py::gil_scoped_release release;
+        old.reset();
+      },
+      py::arg("threads"));
+
+  m.def(
+      "optimize_batch",
+      [](py::list instances) {
+        // Each item is {truck, boxes, params?}, {dataset_id, params?} or a
+        // (truck, boxes[, params]) tuple. Conversion happens up front under the GIL;
+        // preparing and optimizing run without it.
+        const size_t count = static_cast<size_t>(py::len(instances));
+        std::vector<engine::BatchInstance> batch(count);
+        std::vector<std::pair<engine::Truck, std::vector<engine::Box>>> raw(count);
+        for (size_t i = 0; i < count; ++i) {
+          const py::handle item = instances[i];
+          py::dict params;
+          if (py::isinstance<py::dict>(item)) {
+            const auto d = py::reinterpret_borrow<py::dict>(item);
+            if (d.contains("params") && !d["params"].is_none()) params = d["params"].cast<py::dict>();
+            if (d.contains("dataset_id")) {
+              const std::string dataset_id = py::str(d["dataset_id"]);
+              batch[i].instance = registry().get(dataset_id);
+              if (!batch[i].instance) throw py::key_error(dataset_id);
+            }
+          }
+          try {
+            if (!batch[i].instance) {
+              if (py::isinstance<py::dict>(item)) {
+                const auto d = py::reinterpret_borrow<py::dict>(item);
+                raw[i].first = truck_from_dict(d["truck"].cast<py::dict>());
+                raw[i].second = boxes_from_list(d["boxes"].cast<py::list>());
+              } else {
+                const auto t = py::reinterpret_borrow<py::sequence>(item);
+                raw[i].first = truck_from_dict(t[0].cast<py::dict>());
+                raw[i].second = boxes_from_list(t[1].cast<py::list>());
+                if (py::len(t) > 2) params = t[2].cast<py::dict>();
+              }
+            }
+            batch[i].params = params_from_dict(params);
+          } catch (const std::exception& e) {
+            throw py::value_error("instance " + std::to_string(i) + ": " + e.what());
+          }
+        }
+
+        const auto pool = batch_pool();
+        std::vector<engine::BatchResult> results;
+        {
+          py::gil_scoped_release release;
+          for (size_t i = 0; i < count; ++i) {
+            if (batch[i].instance) continue;
+            batch[i].instance = std::make_shared<const engine::PreparedInstance>(
+                engine::prepare_instance(raw[i].first, std::move(raw[i].second)));
+          }
+          results = engine::optimize_batch(batch, *pool);
+        }
+
+        py::list out;
+        for (const auto& r : results) {
+          py::dict item = r.ok ? result_to_dict(r.result) : py::dict();
+          if (!r.ok) item["error"] = r.error;
+          item["elapsed_ms"] = r.elapsed_ms;
+          out.append(item);
+        }
+        return out;
+      },
+      py::arg("instances"));
+
+  // Fleet mode: assign boxes across several trucks and pack them in parallel.
+  m.def(
+      "optimize_fleet",
+      [](py::list fleet, py::list boxes, py::dict params) {
+        return run_fleet(fleet_from_list(fleet), boxes_from_list(boxes), params);
+      },
+      py::arg("fleet"), py::arg("boxes"), py::arg("params") = py::dict());
+
+  m.def(
+      "optimize_fleet_registered",
+      [](const std::string& dataset_id, py::list fleet, py::dict params) {
+        const auto inst = registry().get(dataset_id);
+        if (!inst) throw py::key_error(dataset_id);
+        return run_fleet(fleet_from_list(fleet), inst->boxes, params);
+      },
+      py::arg("dataset_id"), py::arg("fleet"), py::arg("params") = py::dict());
+
+  // Live loading: one Packer per dock session, boxes placed as they arrive.
+  py::class_<engine::Packer>(m, "Packer")
+      .def(py::init([](py::dict truck, py::dict params) {
+             return std::make_unique<engine::Packer>(truck_from_dict(truck), params_from_dict(params).physics);
+           }),
+           py::arg("truck"), py::arg("params") = py::dict())
+      .def(
+          "add_box",
+          [](engine::Packer& packer, py::dict box) -> py::object {
+            const engine::Box b = box_from_any(box);
+            std::optional<engine::Placement> placed;
+            {
+              py::gil_scoped_release release;
+              placed = packer.add_box(b);
+            }
+            if (!placed) return py::none();
+            return placement_to_dict(*placed);
+          },
+          py::arg("box"))
+      .def("remove_box", &engine::Packer::remove_box, py::arg("box_id"))
+      .def("snapshot", [](const engine::Packer& packer) { return result_to_dict(packer.snapshot()); })
+      .def("__len__", &engine::Packer::size);
+
+  // Asynchronous jobs: submit returns at once, workers run the GA, callers poll.
+  py::register_exception<JobQueueFull>(m, "QueueFullError");
+
+  m.def(
+      "configure_jobs",
+      [](size_t workers, size_t max_queued) {
+        std::unique_ptr<engine::JobScheduler> old;
+        {
+          std::lock_guard<std::mutex> lock(g_jobs_mu);
+          old = std::move(g_jobs);
+          g_jobs = std::make_unique<engine::JobScheduler>(workers, max_queued);
         }
+        py::gil_scoped_release release;
+        old.reset();
+      },
+      py::arg("workers"), py::arg("max_queued"));
+
+  m.def(
+      "submit_job",
+      [](py::dict truck, py::list boxes, py::dict params, int priority, const std::string& label) {
+        auto inst = std::make_shared<const engine::PreparedInstance>(
+            engine::prepare_instance(truck_from_dict(truck), boxes_from_list(boxes)));
+        return submit_instance(std::move(inst), params, priority, label);
+      },
+      py::arg("truck"), py::arg("boxes"), py::arg("params") = py::dict(), py::arg("priority") = 0,
+      py::arg("label") = "");
 
+  m.def(
+      "submit_job_wire",
+      [](py::bytes data, int priority, const std::string& label) {
+        auto req = decode_wire(data);
+        auto inst = std::make_shared<const engine::PreparedInstance>(
+            engine::prepare_instance(req.truck, std::move(req.boxes)));
+        return submit_instance(std::move(inst), params_from_wire(req.params), priority, label);
+      },
+      py::arg("data"), py::arg("priority") = 0, py::arg("label") = "");
+
+  m.def(
+      "submit_job_registered",
+      [](const std::string& dataset_id, py::dict params, int priority) {
+        auto inst = registry().get(dataset_id);
+        if (!inst) throw py::key_error(dataset_id);
+        return submit_instance(std::move(inst), params, priority, dataset_id);
+      },
+      py::arg("dataset_id"), py::arg("params") = py::dict(), py::arg("priority") = 0);
+
+  m.def(
+      "job_status",
+      [](uint64_t job_id, bool include_result) -> py::object {
+        engine::JobStatus st;
+        if (!jobs().status(job_id, &st)) return py::none();
         py::dict out;
-        out["placed"] = placed;
-        out["unplaced"] = r.unplaced;
-        py::dict metrics;
-        metrics["used_volume"] = r.used_volume;
-        metrics["total_volume"] = r.total_volume;
-        metrics["utilization"] = r.utilization;
-        metrics["total_weight"] = r.total_weight;
-        out["metrics"] = metrics;
+        out["job_id"] = st.id;
+        out["status"] = engine::job_state_name(st.state);
+        out["priority"] = st.priority;
+        out["label"] = st.label;
+        out["queued_ms"] = st.queued_ms;
+        out["run_ms"] = st.run_ms;
+        out["progress"] = st.has_progress ? py::object(progress_to_dict(st.progress)) : py::object(py::none());
+        if (!st.error.empty()) out["error"] = st.error;
+        if (include_result && st.result) out["result"] = result_to_dict(*st.result);
         return out;
       },
-      py::arg("truck"), py::arg("boxes"), py::arg("params") = py::dict());
+      py::arg("job_id"), py::arg("include_result") = true);
+
+  m.def(
+      "cancel_job", [](uint64_t job_id) { return jobs().cancel(job_id); }, py::arg("job_id"));
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+#include "instance.h"
+#include "optimizer.h"
+#include "thread_pool.h"
+
+namespace engine {
+
+struct BatchInstance {
+  std::shared_ptr<const PreparedInstance> instance;
+  GaParams params;
+};
+
+struct BatchResult {
+  Result result;
+  double elapsed_ms = 0.0;  // wall time of this instance's optimize
+  bool ok = true;
+  std::string error;
+};
+
+struct BatchOptions {
+  // Instances up to this many boxes run whole on one thread, grouped with other small
+  // ones until a group holds `group_boxes`; larger instances get their own task and
+  // decode offspring in parallel on the same pool.
+  size_t small_instance_boxes = 150;
+  size_t group_boxes = 600;
+};
+
+// Optimizes independent instances on a shared pool; results come back in input order.
+// A failing instance is reported in its BatchResult and does not affect the others.
+std::vector<BatchResult> optimize_batch(const std::vector<BatchInstance>& batch,
+                                        WorkStealingPool& pool,
+                                        const BatchOptions& options = BatchOptions{});
+
+}  // namespace engine
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "engine_types.h"
+#include "instance.h"
+#include "optimizer.h"
+
+namespace engine {
+
+// Block-building: identical boxes (same type id: dims, weight, orientation mask and load
+// limits) are
+// grouped into full nx × ny × nz stacks that the GA and decoders treat as one item.
+// Repetitive manifests then have far shorter chromosomes and far fewer candidate scans.
+//
+// Blocks only turn about the vertical axis, and only when their boxes' orientation masks
+// allow it, so the stack inside stays as built. ny is limited so the bottom units can
+// carry the units above them. What remains of their capacity becomes the block's max
+// load, assumed spread evenly over its top. A block's base needs the support its units
+// would; units left without it are placed again on their own when the block is expanded.
+struct Block {
+  std::vector<size_t> members;  // source box indices, filled bottom layer first
+  double unit_w = 0;            // member dims as oriented inside the block
+  double unit_h = 0;
+  double unit_d = 0;
+  int nx = 1;
+  int ny = 1;
+  int nz = 1;
+};
+
+struct BlockedInstance {
+  PreparedInstance instance;  // one item per block; boxes left alone are 1×1×1 blocks
+  std::vector<Block> blocks;  // parallel to instance.boxes
+  size_t grouped = 0;         // blocks with more than one member
+};
+
+// Stack heights respect crush limits only under PhysicsMode::kFull.
+BlockedInstance build_blocks(const PreparedInstance& instance, size_t max_block_boxes, const PhysicsModel& physics);
+
+// Replaces every block in `result` (a plan for blocked.instance) by its member boxes,
+// rebuilt on a `kind` decoder over `source`. Units that break a rule where their block
+// put them, and the members of unplaced blocks, are placed by that decoder wherever it
+// can; whatever still does not fit is listed as unplaced.
+Result expand_blocks(const BlockedInstance& blocked, const PreparedInstance& source, const Result& result,
+                     DecoderKind kind, const PhysicsModel& physics);
+
+}  // namespace engine
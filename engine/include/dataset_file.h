@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+#include "wire_format.h"
+
+namespace engine {
+
+// Columnar on-disk dataset written by the backend's `/api/simulate`.
+//
+//   dataset := header("VLDS"), f64 truck[4] (w, h, d, max_weight), box column block
+//
+// The box column block is the same one the wire format uses (see wire_format.h), so
+// columns are 8-byte aligned inside the file and can be read straight out of the
+// mapping without a parse step.
+constexpr char kDatasetMagic[4] = {'V', 'L', 'D', 'S'};
+constexpr const char* kDatasetSuffix = ".vlds";
+
+class MappedDataset {
+ public:
+  // Throws std::runtime_error if the file can't be mapped or isn't a valid dataset.
+  explicit MappedDataset(const std::string& path);
+  ~MappedDataset();
+
+  MappedDataset(const MappedDataset&) = delete;
+  MappedDataset& operator=(const MappedDataset&) = delete;
+
+  const Truck& truck() const { return truck_; }
+  size_t size() const { return columns_.rows; }
+  std::vector<Box> boxes() const { return wire::boxes_from_columns(columns_); }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+  Truck truck_{};
+  wire::ColumnBlock columns_;
+};
+
+std::vector<uint8_t> encode_dataset(const Truck& truck, const std::vector<Box>& boxes);
+
+}  // namespace engine
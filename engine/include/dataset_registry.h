@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "instance.h"
+
+namespace engine {
+
+// Prepared instances kept across optimize calls ("upload once, optimize many").
+//
+// Entries are shared_ptr so an optimize holding one survives a concurrent eviction.
+// Least-recently-used entries are evicted once the estimated footprint exceeds the cap.
+class DatasetRegistry {
+ public:
+  struct Stats {
+    size_t entries;
+    size_t bytes;
+    size_t capacity_bytes;
+    size_t evictions;
+  };
+
+  explicit DatasetRegistry(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+  // Replaces any entry with the same id. Throws std::length_error if the instance alone
+  // exceeds the cap.
+  std::shared_ptr<const PreparedInstance> put(const std::string& id, PreparedInstance instance);
+  // Returns nullptr when the id is unknown; a hit refreshes the entry's recency.
+  std::shared_ptr<const PreparedInstance> get(const std::string& id);
+  bool erase(const std::string& id);
+  void set_capacity(size_t capacity_bytes);
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const PreparedInstance> instance;
+    size_t bytes;
+    std::list<std::string>::iterator lru_pos;
+  };
+
+  void evict_to(size_t limit);
+
+  mutable std::mutex mu_;
+  size_t capacity_bytes_;
+  size_t bytes_ = 0;
+  size_t evictions_ = 0;
+  std::list<std::string> lru_;  // front = most recently used
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace engine
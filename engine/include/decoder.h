@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "engine_types.h"
+#include "instance.h"
+#include "optimizer.h"
+
+namespace engine {
+
+// What each placement rests on: result().placed[i] rests on result().placed[on[k]] for k
+// in [first[i], first[i + 1]), all placed earlier. Null when the physics skips support
+// checks, since boxes then need not rest on anything.
+struct SupportGraph {
+  const std::vector<uint32_t>* first = nullptr;
+  const std::vector<uint32_t>* on = nullptr;
+};
+
+// Places boxes one at a time. The GA only searches over box orders; the decoder decides
+// where each box goes, using the shared rules in packing_common.h. The instance must
+// outlive the decoder.
+class Decoder {
+ public:
+  virtual ~Decoder() = default;
+
+  // Forget every placement, as if freshly made.
+  virtual void reset() = 0;
+  // Place instance.boxes[box], or record it as unplaced. Returns whether it was placed.
+  virtual bool place(size_t box) = 0;
+  // Place instance.boxes[box] exactly at `at` (sides in one of its orientations) if every
+  // rule holds there, e.g. to rebuild a plan made on other items. Otherwise change nothing
+  // and return false; the box may still go through place() later.
+  virtual bool place_at(size_t box, const Placement& at) = 0;
+  // The plan so far; utilization is kept current.
+  virtual const Result& result() const = 0;
+  // The support DAG of result().placed, valid until the next change to the decoder.
+  virtual SupportGraph supports() const = 0;
+  // An independent copy in the current state, so a shared prefix of an order is placed
+  // once and each continuation resumes from the copy (memetic local search).
+  virtual std::unique_ptr<Decoder> clone() const = 0;
+};
+
+// Each factory builds the decoder specialised for physics.mode (see the policies in
+// packing_common.h); the other settings in `physics` are read at run time.
+std::unique_ptr<Decoder> make_decoder(const PreparedInstance& instance, DecoderKind kind,
+                                      const PhysicsModel& physics = {});
+
+std::unique_ptr<Decoder> make_extreme_point_decoder(const PreparedInstance& instance, const PhysicsModel& physics = {});
+std::unique_ptr<Decoder> make_wall_decoder(const PreparedInstance& instance, const PhysicsModel& physics = {});
+std::unique_ptr<Decoder> make_empty_space_decoder(const PreparedInstance& instance, const PhysicsModel& physics = {});
+
+// Lengths as whole multiples of `unit` metres (0.001 for millimetres), for decoders that
+// compare coordinates exactly. Box sides round up and the truck rounds down, so a plan
+// valid in units is valid in metres; inputs already on the grid convert exactly.
+struct FixedGeometry {
+  double unit = 0;
+  std::array<int32_t, 3> truck{};
+  // Per box, parallel to instance.orientations.
+  std::vector<std::array<std::array<int32_t, 3>, 6>> dims;
+};
+
+// Values within this many units below a grid line count as on it (decimal inputs such
+// as 0.3 m are not exact in binary).
+constexpr double kFixedSlack = 1e-6;
+// Truck sides stay below this many units so sums of two coordinates fit in int32_t.
+constexpr double kMaxFixedUnits = 1 << 30;
+
+int32_t fixed_units_up(double v, double unit);
+
+// Throws std::invalid_argument when unit is not positive or too fine for the truck.
+FixedGeometry make_fixed_geometry(const PreparedInstance& instance, double unit);
+
+// The extreme-point decoder on `geometry`'s integer grid. Placements are reported in
+// metres with the boxes' real sides; physics uses the real weights and footprints.
+// Both instance and geometry must outlive the decoder.
+std::unique_ptr<Decoder> make_fixed_point_decoder(const PreparedInstance& instance, const FixedGeometry& geometry,
+                                                  const PhysicsModel& physics = {});
+
+// Brings a finished plan within truck.max_lateral_offset. Decoders only hold that limit
+// once every planned box is on board (BalanceLimits), so when some stay out this takes
+// boxes nothing rests on (per `supports`, the graph of the decoder that made the plan;
+// any box when it is null) off the plan, most lopsided first, and lists them as unplaced.
+// It never takes off a box whose removal puts an axle over its limit; when every
+// candidate would, it stops and the plan stays past the lateral limit. A no-op for
+// trucks without the limit.
+void settle_lateral_offset(const PreparedInstance& instance, const SupportGraph& supports, Result* plan);
+
+// Runs a fresh decoder over `order`.
+Result decode_order(const PreparedInstance& instance, DecoderKind kind, const std::vector<size_t>& order,
+                    const PhysicsModel& physics = {});
+
+}  // namespace engine
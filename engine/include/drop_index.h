@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace packing {
+
+// Multi-drop accessibility: which placed boxes lie between a box and the door.
+//
+// The door is the truck's rear wall (z = depth) and goods leave through it one stop at a
+// time. A box is reachable at its stop when nothing still on board at that
+// stop, i.e. nothing unloaded at a later stop, sits behind it with an overlapping (x, y)
+// face. Placements keep every box reachable, so no later stop blocks an earlier one.
+//
+// The depth is cut into slabs, each listing the boxes crossing it with the earliest and
+// latest stop among them. A query only scans the slabs on either side of the box whose
+// stop range conflicts with its own, so loads with few stops per slab settle most
+// candidates from the slab summaries alone. Coordinates are the decoder's T.
+template <typename T>
+class DropIndex {
+ public:
+  // Lays the slabs over a truck this deep. Until then every box shares one slab.
+  void set_depth(T depth);
+  void clear();
+
+  // Whether a box over [x, x + w) × [y, y + h) × [z, z + d) unloaded at `stop` keeps every
+  // box, itself included, reachable at its own stop.
+  bool allows(T x, T y, T z, T w, T h, T d, int32_t stop) const;
+  void add(T x, T y, T z, T w, T h, T d, int32_t stop);
+
+ private:
+  struct Slab {
+    std::vector<uint32_t> boxes;
+    int32_t first_stop = 0;
+    int32_t last_stop = 0;
+  };
+
+  int slab(T z) const;
+
+  // Placed boxes by index.
+  std::vector<T> x0_, x1_, y0_, y1_, z0_, z1_;
+  std::vector<int32_t> stop_;
+
+  T cell_ = 0;
+  std::vector<Slab> slabs_ = std::vector<Slab>(1);
+};
+
+extern template class DropIndex<double>;
+extern template class DropIndex<int32_t>;
+
+}  // namespace packing
+}  // namespace engine
@@ -1,10 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace engine {
 
+// Orientation masks: bit i allows the i-th of (w,h,d), (w,d,h), (h,w,d), (h,d,w),
+// (d,w,h), (d,h,w) as the placed (x, y, z) extents.
+constexpr uint8_t kAnyOrientation = 0x3F;
+constexpr uint8_t kUprightOrientations = 0x21;  // h stays vertical ("this side up")
+
 struct Box {
   std::string id;
   double w;
@@ -12,6 +18,13 @@ struct Box {
   double d;
   double weight;
   int priority;
+  uint8_t orientations = kAnyOrientation;
+  // Load the box's top may carry, in kg; 0 derives it from the PhysicsModel.
+  double max_load = 0;
+  // Nothing may rest on it.
+  bool fragile = false;
+  // Delivery stop, 1 for the first one unloaded; 0 stays on board to the end.
+  int drop = 0;
 };
 
 struct Truck {
@@ -19,6 +32,31 @@ struct Truck {
   double h;
   double d;
   double max_weight;
+  // Balance limits on the payload, each off at 0. The load rests on two supports along
+  // the depth, front_axle_z and rear_axle_z metres behind the front wall (kingpin or front
+  // axle, rear axle group), and the lever rule splits its weight between them.
+  double front_axle_z = 0;
+  double rear_axle_z = 0;
+  double front_axle_max = 0;  // kg
+  double rear_axle_max = 0;   // kg
+  // How far, in metres, the centre of gravity may sit from the truck's centreline (x = w/2).
+  double max_lateral_offset = 0;
+};
+
+// Which placement rules the decoders enforce (packing_common.h).
+enum class PhysicsMode {
+  kFull,         // support and crush
+  kSupportOnly,  // supported base and centroid; tops carry any load
+  kNone,         // only the truck walls and other boxes constrain a position
+};
+
+// Physics settings for a whole run. Boxes override the derived max load through
+// Box::max_load and Box::fragile.
+struct PhysicsModel {
+  PhysicsMode mode = PhysicsMode::kFull;
+  double min_support = 0.90;          // share of a stacked box's base that must rest on something
+  double max_stack_multiplier = 6.0;  // derived max load, in multiples of the box's weight...
+  double max_pressure = 2500.0;       // ...and in kg per m^2 of its footprint; the lower one wins
 };
 
 struct Placement {
@@ -38,6 +76,17 @@ struct Result {
   double total_volume;
   double utilization;
   double total_weight;
+  // Centre of gravity of the placed load (0 when empty) and the share of its weight on
+  // each axle (0 unless the truck sets rear_axle_z).
+  double cog_x = 0;
+  double cog_y = 0;
+  double cog_z = 0;
+  double front_axle_load = 0;
+  double rear_axle_load = 0;
+  // Memetic local search over the run (GaParams::local_search_elites): score gained and
+  // thread CPU milliseconds spent; 0 when it is off.
+  double local_search_gain = 0;
+  double local_search_ms = 0;
 };
 
 }  // namespace engine
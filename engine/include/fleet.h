@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+#include "optimizer.h"
+#include "thread_pool.h"
+
+namespace engine {
+
+// A kind of truck and how many of them are available.
+struct TruckType {
+  std::string id;
+  Truck truck;
+  int count;
+};
+
+struct FleetParams {
+  GaParams ga;  // per-truck GA; each truck gets seed + its slot number
+  // Boxes are assigned to a truck until their volume reaches this share of its
+  // capacity; the packer rarely reaches 100%, and leftovers cost a re-pack round.
+  double fill_target = 0.85;
+};
+
+struct TruckLoad {
+  std::string type_id;
+  int index;  // n-th truck of its type
+  Truck truck;
+  Result result;
+};
+
+struct FleetResult {
+  std::vector<TruckLoad> trucks;  // used trucks only, in the order they were opened
+  std::vector<std::string> unplaced;
+  int trucks_used = 0;
+  double used_volume = 0;
+  double capacity_volume = 0;  // volume of the used trucks
+  double utilization = 0;
+  double total_weight = 0;
+};
+
+// Packs boxes into a fleet in one call.
+//
+// Boxes are assigned first-fit-decreasing by volume to truck slots (largest truck
+// types opened first), then every slot that received boxes is packed with the GA in
+// parallel. Boxes a truck could not place close that truck and are reassigned in
+// another round, until everything is placed or no truck can take the rest.
+FleetResult optimize_fleet(const std::vector<TruckType>& fleet,
+                           const std::vector<Box>& boxes,
+                           const FleetParams& params,
+                           WorkStealingPool* pool = nullptr);
+
+}  // namespace engine
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace engine {
+
+// 64-bit FNV-1a over raw bytes, for the content hashes and cache keys (warm_start.h,
+// result_cache.h). Not cryptographic.
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+inline void fnv(uint64_t* h, const void* data, size_t len) {
+  const auto* p = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < len; ++i) *h = (*h ^ p[i]) * kFnvPrime;
+}
+
+// Hashes v's object representation, so V must have no padding.
+template <typename V>
+void fnv_value(uint64_t* h, V v) {
+  fnv(h, &v, sizeof(v));
+}
+
+}  // namespace engine
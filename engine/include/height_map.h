@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace engine {
+namespace packing {
+
+// Top surface of the load seen from above: the truck floor (x, z) split into disjoint
+// rectangles, each at the height of the top of the box that owns it. Floor not covered by
+// any rectangle is at height 0. Boxes placed under an overhang stay hidden below the
+// higher top over them.
+//
+// Answers "what rests under this footprint" from the few rectangles near it instead of
+// every placed box: a coarse grid of buckets over the floor lists the rectangles crossing
+// each bucket. Coordinates are the decoder's T (metres, or FixedGeometry units).
+template <typename T>
+class HeightMap {
+ public:
+  // Lays the bucket grid over a floor this size. Until then all rectangles share one
+  // bucket, which is correct but scans them all.
+  void set_floor(T width, T depth);
+  void clear();
+  void reserve(size_t n);
+
+  // Raises the surface to top over [x, x + w) × [z, z + d) wherever it is lower.
+  void raise(T x, T z, T w, T d, T top, uint32_t owner);
+
+  // Drops the rectangles `owner` has over the footprint to the floor, for a box taken out
+  // of the load. The surface is too low there until the boxes beneath are raised again.
+  void lower(T x, T z, T w, T d, uint32_t owner);
+
+  // Height a box with this footprint comes to rest at when dropped from above.
+  T rest_height(T x, T z, T w, T d) const;
+
+  // The boxes whose top is level with `base` and overlaps the footprint, ascending, or
+  // false when a higher surface covers part of the footprint: a box under an overhang
+  // could then be hidden there, and only the full scan can tell.
+  bool level_owners(T x, T z, T w, T d, T base, std::vector<uint32_t>* owners) const;
+
+  size_t regions() const { return x0_.size() - free_.size(); }
+
+ private:
+  struct Buckets {
+    int x0, x1, z0, z1;  // inclusive
+  };
+
+  int bucket(T v, int n) const;
+  Buckets buckets_of(T x0, T x1, T z0, T z1) const;
+  // Calls visit(r) once for every rectangle r that may overlap the footprint.
+  template <typename Visit>
+  void for_each_near(T x0, T x1, T z0, T z1, Visit visit) const;
+  void push(T x0, T x1, T z0, T z1, T top, uint32_t owner);
+  void erase(uint32_t r);
+
+  // Rectangles by slot; erased slots go on free_ for reuse.
+  std::vector<T> x0_, x1_, z0_, z1_, top_;
+  std::vector<uint32_t> owner_;
+  std::vector<uint32_t> free_;
+
+  T cell_ = 0;
+  int nx_ = 1, nz_ = 1;
+  std::vector<std::vector<uint32_t>> buckets_ = std::vector<std::vector<uint32_t>>(1);
+
+  // Scratch for raise().
+  std::vector<uint32_t> near_;
+  std::vector<T> pieces_, next_;
+  // Set once a raise covers a top within the level tolerance below it: the hidden box may
+  // still count as level with a base, so from then on level_owners() defers to the scan.
+  bool exact_ = true;
+};
+
+extern template class HeightMap<double>;
+extern template class HeightMap<int32_t>;
+
+}  // namespace packing
+}  // namespace engine
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "engine_types.h"
+
+namespace engine {
+
+// Distinct (w, h, d) orientations a box may be placed in, in decoder preference order:
+// only those its mask allows and the truck can hold. count == 0 means it never fits.
+struct OrientationSet {
+  std::array<std::array<double, 3>, 6> dims;
+  uint8_t count;
+};
+
+// Per-item overrides of the packing rules in packing_common.h. Zero keeps the default.
+struct ItemRules {
+  double max_load = 0;     // load the item's top may carry, in kg
+  double min_support = 0;  // share of the base that must rest on something
+  bool fragile = false;    // nothing may rest on it
+};
+
+// A packing instance with the per-box data every decode needs computed once.
+//
+// Building this is O(n); the GA then reuses it for every individual, and the dataset
+// registry keeps it alive across optimize calls.
+struct PreparedInstance {
+  Truck truck;
+  std::vector<Box> boxes;
+  std::vector<double> volumes;
+  std::vector<OrientationSet> orientations;
+  // Boxes with identical dims, weight, orientation mask, load limits and drop share a type
+  // id in [0, type_count).
+  std::vector<uint32_t> type_of;
+  uint32_t type_count = 0;
+  // Empty, or one entry per box. prepare_instance fills it when some box sets max_load or
+  // fragile.
+  std::vector<ItemRules> rules;
+  // Empty, or one entry per box: the stop it comes off at, boxes without a drop after
+  // every numbered stop. prepare_instance fills it when some box sets a drop.
+  std::vector<int32_t> stop_of;
+  double total_volume = 0;
+
+  size_t memory_bytes() const;
+};
+
+PreparedInstance prepare_instance(const Truck& truck, std::vector<Box> boxes);
+
+// Distinct orientations the box may take that fit the truck, in canonical order. Cubes
+// and boxes with two equal sides collapse to fewer entries.
+OrientationSet orientations_for(const Box& box, const Truck& truck);
+
+}  // namespace engine
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "engine_types.h"
+#include "optimizer.h"
+
+namespace engine {
+
+enum class JobState { kQueued, kRunning, kDone, kCancelled, kFailed };
+
+const char* job_state_name(JobState s);
+
+struct JobStatus {
+  uint64_t id;
+  JobState state;
+  int priority;
+  std::string label;
+  bool has_progress;
+  GaProgress progress;
+  double queued_ms;
+  double run_ms;
+  std::shared_ptr<const Result> result;  // set once the job is done (or cancelled mid-run)
+  std::string error;
+};
+
+// Runs optimize jobs on a fixed pool of worker threads.
+//
+// Jobs are taken highest priority first, FIFO within a priority. The queue is bounded so
+// a burst of submissions fails fast instead of piling up; finished jobs are kept for
+// polling until `max_finished` newer ones have completed.
+class JobScheduler {
+ public:
+  // A job body: runs the optimizer, forwarding progress and honoring cancellation.
+  using Task = std::function<Result(const std::function<void(const GaProgress&)>& on_progress,
+                                    const std::atomic<bool>& cancel)>;
+
+  JobScheduler(size_t workers, size_t max_queued, size_t max_finished = 256);
+  ~JobScheduler();
+
+  JobScheduler(const JobScheduler&) = delete;
+  JobScheduler& operator=(const JobScheduler&) = delete;
+
+  // Throws std::length_error when the queue is full.
+  uint64_t submit(int priority, std::string label, Task task);
+  bool status(uint64_t id, JobStatus* out) const;
+  // Queued jobs are dropped right away; running jobs stop at the next generation.
+  bool cancel(uint64_t id);
+
+  size_t workers() const { return threads_.size(); }
+
+ private:
+  struct Job {
+    uint64_t id;
+    int priority;
+    std::string label;
+    Task task;
+    JobState state = JobState::kQueued;
+    std::atomic<bool> cancel{false};
+    bool has_progress = false;
+    GaProgress progress{};
+    std::chrono::steady_clock::time_point submitted;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point finished;
+    std::shared_ptr<const Result> result;
+    std::string error;
+  };
+
+  struct QueueOrder {
+    bool operator()(const std::shared_ptr<Job>& a, const std::shared_ptr<Job>& b) const {
+      if (a->priority != b->priority) return a->priority < b->priority;
+      return a->id > b->id;
+    }
+  };
+
+  void worker_loop();
+  void finish(const std::shared_ptr<Job>& job);
+
+  mutable std::mutex mu_;
+  std::condition_variable cv_;
+  bool stopping_ = false;
+  uint64_t next_id_ = 1;
+  size_t max_queued_;
+  size_t max_finished_;
+  size_t queued_ = 0;
+  std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>, QueueOrder> queue_;
+  std::unordered_map<uint64_t, std::shared_ptr<Job>> jobs_;
+  std::deque<uint64_t> finished_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace engine
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+#include "instance.h"
+
+namespace engine {
+
+class WarmStartCache;
+
+// Best individual so far, reported when a generation ends or the incumbent improves.
+struct GaProgress {
+  int generation;   // generations completed
+  int generations;  // effective total, after the instance-size caps
+  double best_score;
+  double utilization;
+  size_t placed;
+  size_t unplaced;
+  bool improved;             // best_score beats the previous report
+  const Result* incumbent;   // only valid during the callback; copy what you keep
+  // Memetic local search so far (GaParams::local_search_elites): score gained by its
+  // accepted moves and the thread CPU time it took.
+  double local_search_gain = 0;
+  double local_search_ms = 0;
+};
+
+// Large-instance mode: split the truck depth into slabs packed independently (slab.h).
+enum class SlabMode { kAuto, kOff, kOn };
+
+// kAuto switches to slabs above this many boxes; below it the GA sees the whole truck.
+constexpr size_t kSlabAutoThreshold = 1000;
+
+// How the GA turns a box order into a plan (decoder.h).
+enum class DecoderKind {
+  kExtremePoints,  // best position over the extreme points of the boxes placed so far
+  kWallBuilding,   // vertical walls across the truck width, filled front to back
+  kEmptySpaces,    // best position over the maximal empty spaces left so far
+};
+
+struct GaParams {
+  int population = 40;
+  int generations = 40;
+  double mutation_rate = 0.08;
+  uint32_t seed = 12345u;
+
+  DecoderKind decoder = DecoderKind::kExtremePoints;
+  // When positive, the extreme-point decoder runs on an integer grid of this many metres
+  // (0.001 for millimetres) instead of doubles; see FixedGeometry in decoder.h.
+  double fixed_unit = 0;
+
+  // Support and crush rules for every decoder; each PhysicsMode runs its own specialised
+  // decoder, so kSupportOnly and kNone skip the unused checks entirely.
+  PhysicsModel physics;
+
+  // Pack identical boxes as stacked blocks (blocks.h). When the expanded plan leaves
+  // boxes out, a single-box run seeded with it gets the generations the blocks saved,
+  // and the better plan is kept.
+  bool blocks = false;
+  size_t block_boxes = 8;  // most boxes per block
+
+  SlabMode slab_mode = SlabMode::kAuto;
+  size_t slab_boxes = 150;  // target boxes per slab
+
+  // Memetic step: every generation the best `local_search_elites` individuals get up to
+  // `local_search_moves` hill-climbing moves each (adjacent swaps, moving a block of boxes
+  // nearby, swaps with a nearby box of another type), kept when they raise the score. A
+  // move re-decodes only from a checkpoint at or before the first position it changes and
+  // stops once it cannot win. 0 turns it off.
+  int local_search_elites = 0;
+  int local_search_moves = 24;
+
+  // Box orders from earlier plans, as box ids (plan_order() in warm_start.h), each seeding
+  // the first population together with perturbed copies of it; the rest stays random.
+  // Ids the manifest lacks are dropped and new boxes merged in (warm_order()).
+  std::vector<std::vector<std::string>> seed_orders;
+  // Optional; when set, the cached plan for this or a similar manifest seeds the run as
+  // well, and the run's plan is stored back. Results then depend on what ran before.
+  WarmStartCache* warm_start = nullptr;
+
+  // Optional; invoked on the optimizing thread.
+  std::function<void(const GaProgress&)> on_progress;
+  // Minimum gap between on_progress calls; reports inside the window are dropped.
+  // The final report always fires.
+  int progress_interval_ms = 0;
+  // Optional; polled between generations. When set, the best plan so far is returned.
+  const std::atomic<bool>* cancel = nullptr;
+  // Optional; must call fn(0..n-1) and return once all calls finished. When set, each
+  // generation's offspring are decoded through it (e.g. on a thread pool). Results do
+  // not depend on it.
+  std::function<void(size_t n, const std::function<void(size_t)>& fn)> parallel_for;
+};
+
+Result optimize_ga(const PreparedInstance& instance, const GaParams& params);
+
+// The GA's objective, higher is better: utilization in percent, minus half a point per
+// unplaced box.
+double score_result(const Result& r);
+
+Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int population, int generations, double mutation_rate, uint32_t seed);
+
+}  // namespace engine
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "engine_types.h"
+
+namespace engine {
+
+// A live loading session for the dock: boxes arrive one at a time and each goes in as it
+// arrives, next to what is already in the truck. Placed boxes never move.
+//
+// The session keeps what the extreme-point decoder keeps between two boxes of an order
+// (the candidate points, the placed geometry, the top surface and the support DAG), so
+// a call costs one decoder step instead of a fresh decode. A box goes at the lowest, then
+// frontmost, then leftmost candidate where it fits and the physics rules hold. Each point
+// carries its free runs, as in the decoder; the next boxes are unknown, so a point too
+// tight for every box offered so far is set aside rather than dropped, until a smaller
+// box arrives or a removal frees room around it.
+//
+// Removing a box leaves a hole in the placed arrays rather than renumbering them, and
+// lowers the top surface over its footprint to what it covered; once holes outnumber the
+// boxes left, the state is rebuilt from the live boxes in placement order.
+//
+// A session has no planned load to balance against and no order to sequence, so it
+// refuses what would need one: trucks with axle or lateral limits, and boxes with a drop.
+//
+// Not thread-safe; callers serialise access to one session.
+class Packer {
+ public:
+  // Throws std::invalid_argument for a truck with axle or lateral limits.
+  explicit Packer(const Truck& truck, const PhysicsModel& physics = {});
+  ~Packer();
+  Packer(Packer&&) noexcept;
+  Packer& operator=(Packer&&) noexcept;
+
+  // Places box and returns where, or nullopt when no position takes it; the box is then
+  // listed as unplaced until a box with its id is placed. Throws std::invalid_argument
+  // when a placed box already has its id, or the box has a drop stop.
+  std::optional<Placement> add_box(const Box& box);
+
+  // Takes a placed box out of the truck. Throws std::invalid_argument for an id that is
+  // not placed, or a box something rests on.
+  void remove_box(const std::string& id);
+
+  // The current plan, placed boxes in placement order.
+  Result snapshot() const;
+
+  size_t size() const;
+
+  // One implementation per physics policy, in packer.cpp.
+  class Session;
+
+ private:
+  std::unique_ptr<Session> session_;
+};
+
+}  // namespace engine
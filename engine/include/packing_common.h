@@ -0,0 +1,569 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "engine_types.h"
+#include "height_map.h"
+#include "instance.h"
+
+namespace engine {
+namespace packing {
+
+// Geometry and physics rules shared by every decoder, so all of them accept exactly the
+// same placements.
+//
+// Coordinates are metres as double, or whole multiples of a fixed unit as int32_t
+// (FixedGeometry in decoder.h). Integer coordinates compare exactly; the double ones
+// allow kEps of slack.
+
+template <typename T>
+struct BasicAABB {
+  T x;
+  T y;
+  T z;
+  T w;
+  T h;
+  T d;
+};
+
+using AABB = BasicAABB<double>;
+using FixedAABB = BasicAABB<int32_t>;
+
+// Products of two integer sides need 64 bits.
+template <typename T>
+using AreaOf = std::conditional_t<std::is_integral_v<T>, int64_t, double>;
+
+// Faces of the boxes placed so far as structure-of-arrays (x1 = x0 + w, ...), so batch
+// scans stream only the coordinates they test.
+template <typename T>
+struct PlacedGeometry {
+  std::vector<T> x0, x1, y0, y1, z0, z1;
+
+  size_t size() const { return x0.size(); }
+  void clear() {
+    for (auto* v : {&x0, &x1, &y0, &y1, &z0, &z1}) v->clear();
+  }
+  void reserve(size_t n) {
+    for (auto* v : {&x0, &x1, &y0, &y1, &z0, &z1}) v->reserve(n);
+  }
+  void push_back(const BasicAABB<T>& b) {
+    x0.push_back(b.x);
+    x1.push_back(b.x + b.w);
+    y0.push_back(b.y);
+    y1.push_back(b.y + b.h);
+    z0.push_back(b.z);
+    z1.push_back(b.z + b.d);
+  }
+};
+
+// Batch kernels over PlacedGeometry (placed_kernels.cpp). On x86-64 with GCC or Clang the
+// AVX-512 or AVX2 version is picked at load time through function multiversioning;
+// otherwise, and on older CPUs, a scalar loop runs. All versions give identical results.
+
+// Whether `box` intersects any placed box (touching faces do not count).
+bool any_intersects(const PlacedGeometry<double>& placed, const AABB& box);
+bool any_intersects(const PlacedGeometry<int32_t>& placed, const FixedAABB& box);
+
+// The placed boxes whose top is level with box's base and that overlap it in plan: writes
+// their indices in ascending order with the x and z extents of each overlap, and returns
+// how many. Each output needs room for placed.size() values.
+size_t support_overlaps(const PlacedGeometry<double>& placed, const AABB& box, uint32_t* idx, double* ox, double* oz);
+size_t support_overlaps(const PlacedGeometry<int32_t>& placed, const FixedAABB& box, uint32_t* idx, int32_t* ox,
+                        int32_t* oz);
+
+// Name of the kernel set the multiversioned functions run ("avx512f", "avx2", "scalar").
+const char* placed_kernels_isa();
+
+// One version of the kernels above, callable whatever the loader picked, so each can be
+// checked against the scalar one.
+struct PlacedKernelSet {
+  const char* isa;
+  bool (*any_intersects)(const PlacedGeometry<double>&, const AABB&);
+  bool (*any_intersects_fixed)(const PlacedGeometry<int32_t>&, const FixedAABB&);
+  size_t (*support_overlaps)(const PlacedGeometry<double>&, const AABB&, uint32_t*, double*, double*);
+  size_t (*support_overlaps_fixed)(const PlacedGeometry<int32_t>&, const FixedAABB&, uint32_t*, int32_t*, int32_t*);
+};
+
+// "scalar", then each vector version built in that this CPU runs.
+std::vector<PlacedKernelSet> placed_kernel_sets();
+
+// Compile-time physics policies, one per PhysicsMode. Decoders and PlacedBoxes are
+// instantiated per policy, so the checks a mode turns off are not compiled in at all.
+struct FullPhysics {
+  static constexpr bool kSupport = true;
+  static constexpr bool kCrush = true;
+};
+struct SupportPhysics {
+  static constexpr bool kSupport = true;
+  static constexpr bool kCrush = false;
+};
+struct NoPhysics {
+  static constexpr bool kSupport = false;
+  static constexpr bool kCrush = false;
+};
+
+// Returns make(policy) for the policy matching mode; make must return the same type for
+// all three.
+template <typename Make>
+auto with_physics(PhysicsMode mode, Make&& make) {
+  switch (mode) {
+    case PhysicsMode::kNone:
+      return make(NoPhysics{});
+    case PhysicsMode::kSupportOnly:
+      return make(SupportPhysics{});
+    case PhysicsMode::kFull:
+      break;
+  }
+  return make(FullPhysics{});
+}
+
+// Boxes placed so far: geometry for the kernels, their top surface, the support DAG and
+// the crush state of each box. Policies without support checks keep only the geometry,
+// and those without crush checks skip the crush state.
+//
+// Box i rests on supporters[k] for k in [first_support[i], first_support[i + 1]). In the
+// crush state it passes share[k] of any load on its top down to each of them, so
+// load_on_top counts everything stacked above a box, not just the boxes touching it.
+// Supporters are always placed earlier, so a lower index is always further down the DAG.
+template <typename T, typename Physics = FullPhysics>
+struct PlacedBoxes {
+  PlacedGeometry<T> geometry;
+  HeightMap<T> surface;
+  std::vector<double> max_load;
+  std::vector<double> load_on_top;
+  std::vector<uint32_t> first_support{0};
+  std::vector<uint32_t> supporters;
+  std::vector<double> share;
+  // Scratch for support_ok_and_apply_load.
+  std::vector<uint32_t> hits;
+  std::vector<T> ox, oz;
+  std::vector<double> pending;
+  std::vector<uint32_t> frontier, touched;
+
+  size_t size() const { return geometry.size(); }
+  void set_floor(T width, T depth) {
+    if constexpr (Physics::kSupport) surface.set_floor(width, depth);
+  }
+  void clear() {
+    geometry.clear();
+    surface.clear();
+    max_load.clear();
+    load_on_top.clear();
+    first_support.assign(1, 0);
+    supporters.clear();
+    share.clear();
+    pending.clear();
+  }
+  void reserve(size_t n) {
+    geometry.reserve(n);
+    surface.reserve(n);
+    max_load.reserve(n);
+    load_on_top.reserve(n);
+    first_support.reserve(n + 1);
+  }
+  // Records b, which rests on the boxes level with its base. Call after its loads passed
+  // support_ok_and_apply_load.
+  void add(const BasicAABB<T>& b, double max_load_kg);
+};
+
+// (supporting index into placed, load added to it)
+using AppliedLoads = std::vector<std::pair<size_t, double>>;
+
+constexpr double kEps = 1e-8;
+constexpr double kLevelEps = 1e-6;  // a top this close to a base supports it
+
+inline double volume(double w, double h, double d) { return w * h * d; }
+
+template <typename T>
+inline bool level_with(T top, T base) {
+  if constexpr (std::is_integral_v<T>) {
+    return top == base;
+  } else {
+    return std::fabs(top - base) <= kLevelEps;
+  }
+}
+
+template <typename T>
+inline bool intersects(const BasicAABB<T>& a, const BasicAABB<T>& b) {
+  const bool sep_x = (a.x + a.w <= b.x) || (b.x + b.w <= a.x);
+  const bool sep_y = (a.y + a.h <= b.y) || (b.y + b.h <= a.y);
+  const bool sep_z = (a.z + a.d <= b.z) || (b.z + b.d <= a.z);
+  return !(sep_x || sep_y || sep_z);
+}
+
+inline bool inside_truck(const Truck& t, const AABB& b) {
+  return b.x >= 0 && b.y >= 0 && b.z >= 0 && (b.x + b.w) <= t.w && (b.y + b.h) <= t.h && (b.z + b.d) <= t.d;
+}
+
+template <typename T>
+inline T overlap_1d(T a0, T a1, T b0, T b1) {
+  const T lo = std::max(a0, b0);
+  const T hi = std::min(a1, b1);
+  return std::max(T{0}, hi - lo);
+}
+
+// Whether the centre of top's base lies over the bottom box with faces x0..x1, z0..z1.
+template <typename T>
+inline bool centroid_in_overlap_xz(const BasicAABB<T>& top, T x0, T x1, T z0, T z1) {
+  const T ox0 = std::max(top.x, x0);
+  const T ox1 = std::min(top.x + top.w, x1);
+  const T oz0 = std::max(top.z, z0);
+  const T oz1 = std::min(top.z + top.d, z1);
+  if constexpr (std::is_integral_v<T>) {
+    // Doubled coordinates keep the centre on the integer grid.
+    const int64_t cx = int64_t{2} * top.x + top.w;
+    const int64_t cz = int64_t{2} * top.z + top.d;
+    return int64_t{2} * ox0 <= cx && cx <= int64_t{2} * ox1 && int64_t{2} * oz0 <= cz && cz <= int64_t{2} * oz1;
+  } else {
+    const double cx = top.x + top.w / 2.0;
+    const double cz = top.z + top.d / 2.0;
+    return (cx + kEps) >= ox0 && (cx - kEps) <= ox1 && (cz + kEps) >= oz0 && (cz - kEps) <= oz1;
+  }
+}
+
+inline double max_load_for(const PhysicsModel& physics, double weight, double base_area) {
+  // Capacity is limited by BOTH a weight-proportional heuristic and a simple
+  // pressure proxy; use the stricter one.
+  const double by_weight = weight * physics.max_stack_multiplier;
+  const double by_pressure = base_area * physics.max_pressure;
+  return std::max(kEps, std::min(by_weight, by_pressure));
+}
+
+// Crush capacity of box `idx` placed with the given footprint.
+inline double max_load_of(const PreparedInstance& inst, const PhysicsModel& physics, size_t idx, double base_area) {
+  if (!inst.rules.empty()) {
+    if (inst.rules[idx].fragile) return 0;
+    if (inst.rules[idx].max_load > 0) return inst.rules[idx].max_load;
+  }
+  return max_load_for(physics, inst.boxes[idx].weight, base_area);
+}
+
+inline double min_support_of(const PreparedInstance& inst, const PhysicsModel& physics, size_t idx) {
+  if (!inst.rules.empty() && inst.rules[idx].min_support > 0) return inst.rules[idx].min_support;
+  return physics.min_support;
+}
+
+constexpr uint8_t kNoOrientation = 0xff;
+
+// b pulled in by kEps on every side (unchanged in integer units), so a position computed
+// elsewhere is not rejected for rounding against a box it only touches.
+template <typename T>
+BasicAABB<T> shrunk(const BasicAABB<T>& b) {
+  if constexpr (std::is_integral_v<T>) {
+    return b;
+  } else {
+    return BasicAABB<T>{b.x + kEps, b.y + kEps, b.z + kEps, b.w - 2 * kEps, b.h - 2 * kEps, b.d - 2 * kEps};
+  }
+}
+
+// The orientation in `rots` with p's sides, or kNoOrientation.
+inline uint8_t orientation_of(const OrientationSet& rots, const Placement& p) {
+  auto same = [](double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); };
+  for (uint8_t ri = 0; ri < rots.count; ++ri) {
+    const auto& r = rots.dims[ri];
+    if (same(r[0], p.w) && same(r[1], p.h) && same(r[2], p.d)) return ri;
+  }
+  return kNoOrientation;
+}
+
+// The placed boxes whose top is level with box's base and that overlap it in plan, into
+// placed.hits with the x and z extents of each overlap in placed.ox and placed.oz.
+template <typename T, typename Physics>
+size_t support_contacts(const BasicAABB<T>& box, PlacedBoxes<T, Physics>& placed) {
+  // The top surface names the supporters directly unless an overhang covers part of the
+  // footprint; then every placed box is scanned.
+  const PlacedGeometry<T>& g = placed.geometry;
+  if (placed.surface.level_owners(box.x, box.z, box.w, box.d, box.y, &placed.hits)) {
+    const size_t hits = placed.hits.size();
+    placed.ox.resize(hits);
+    placed.oz.resize(hits);
+    for (size_t h = 0; h < hits; ++h) {
+      const size_t i = placed.hits[h];
+      placed.ox[h] = overlap_1d(box.x, box.x + box.w, g.x0[i], g.x1[i]);
+      placed.oz[h] = overlap_1d(box.z, box.z + box.d, g.z0[i], g.z1[i]);
+    }
+    return hits;
+  }
+  const size_t n = placed.size();
+  placed.hits.resize(n);
+  placed.ox.resize(n);
+  placed.oz.resize(n);
+  return support_overlaps(g, box, placed.hits.data(), placed.ox.data(), placed.oz.data());
+}
+
+template <typename T>
+double base_area_of(const BasicAABB<T>& box) {
+  return std::max(kEps, static_cast<double>(AreaOf<T>(box.w) * box.d));
+}
+
+// Whether the placed boxes hold up `candidate` under the policy's rules; under
+// FullPhysics its weight is then applied to every box below it.
+template <typename T, typename Physics>
+bool support_ok_and_apply_load(const BasicAABB<T>& candidate,
+                               double weight,
+                               PlacedBoxes<T, Physics>& placed,
+                               AppliedLoads* applied,
+                               double min_support) {
+  if constexpr (!Physics::kSupport) {
+    return true;
+  }
+  if (candidate.y <= static_cast<T>(kEps)) {
+    return true;
+  }
+
+  const double base_area = base_area_of(candidate);
+
+  double supported_area = 0.0;
+  bool centroid_supported = false;
+
+  AppliedLoads supports;
+
+  const size_t hits = support_contacts(candidate, placed);
+  const PlacedGeometry<T>& g = placed.geometry;
+  for (size_t h = 0; h < hits; ++h) {
+    const size_t i = placed.hits[h];
+    const AreaOf<T> area = AreaOf<T>(placed.ox[h]) * placed.oz[h];
+    if (area <= static_cast<AreaOf<T>>(kEps)) {
+      continue;
+    }
+    supported_area += static_cast<double>(area);
+    supports.push_back({i, static_cast<double>(area)});
+    if (!centroid_supported && centroid_in_overlap_xz(candidate, g.x0[i], g.x1[i], g.z0[i], g.z1[i])) {
+      centroid_supported = true;
+    }
+  }
+
+  if (!centroid_supported) {
+    return false;
+  }
+
+  if (supported_area + 1e-9 < min_support * base_area) {
+    return false;
+  }
+
+  if constexpr (!Physics::kCrush) {
+    return true;
+  }
+
+  // Push the weight down the DAG, deepest-placed box last: every box's added load is
+  // complete before it is passed on, and each box is checked against its crush limit as
+  // soon as anything reaches it. Nothing is applied until every box has passed.
+  placed.pending.resize(placed.size(), 0.0);
+  placed.frontier.clear();
+  placed.touched.clear();
+  auto reset_pending = [&]() {
+    for (uint32_t k : placed.touched) placed.pending[k] = 0.0;
+  };
+  auto add_load = [&](uint32_t k, double added) {
+    if (!(added > 0)) return true;
+    if (placed.pending[k] == 0.0) {
+      placed.touched.push_back(k);
+      placed.frontier.push_back(k);
+      std::push_heap(placed.frontier.begin(), placed.frontier.end());
+    }
+    placed.pending[k] += added;
+    return placed.load_on_top[k] + placed.pending[k] <= placed.max_load[k] + 1e-9;
+  };
+
+  for (const auto& [idx, area] : supports) {
+    const double share = std::min(1.0, std::max(0.0, area / base_area));
+    if (!add_load(static_cast<uint32_t>(idx), weight * share)) {
+      reset_pending();
+      return false;
+    }
+  }
+  while (!placed.frontier.empty()) {
+    std::pop_heap(placed.frontier.begin(), placed.frontier.end());
+    const uint32_t k = placed.frontier.back();
+    placed.frontier.pop_back();
+    const double load = placed.pending[k];
+    for (uint32_t e = placed.first_support[k]; e < placed.first_support[k + 1]; ++e) {
+      if (!add_load(placed.supporters[e], load * placed.share[e])) {
+        reset_pending();
+        return false;
+      }
+    }
+  }
+
+  for (uint32_t k : placed.touched) {
+    placed.load_on_top[k] += placed.pending[k];
+    if (applied) {
+      applied->push_back({k, placed.pending[k]});
+    }
+  }
+  reset_pending();
+
+  return true;
+}
+
+template <typename T, typename Physics>
+void PlacedBoxes<T, Physics>::add(const BasicAABB<T>& b, double max_load_kg) {
+  if constexpr (Physics::kSupport) {
+    if (b.y > static_cast<T>(kEps)) {
+      const double base_area = base_area_of(b);
+      const size_t n = support_contacts(b, *this);
+      for (size_t h = 0; h < n; ++h) {
+        const AreaOf<T> area = AreaOf<T>(ox[h]) * oz[h];
+        if (area <= static_cast<AreaOf<T>>(kEps)) continue;
+        supporters.push_back(hits[h]);
+        if constexpr (Physics::kCrush) {
+          share.push_back(std::min(1.0, std::max(0.0, static_cast<double>(area) / base_area)));
+        }
+      }
+    }
+    first_support.push_back(static_cast<uint32_t>(supporters.size()));
+    surface.raise(b.x, b.z, b.w, b.d, b.y + b.h, static_cast<uint32_t>(size()));
+  }
+  if constexpr (Physics::kCrush) {
+    max_load.push_back(max_load_kg);
+    load_on_top.push_back(0.0);
+  }
+  geometry.push_back(b);
+}
+
+template <typename T, typename Physics>
+void rollback_loads(PlacedBoxes<T, Physics>& placed, const AppliedLoads& applied) {
+  for (const auto& [idx, added] : applied) {
+    placed.load_on_top[idx] -= added;
+  }
+}
+
+// An extreme point and the free run from it along +x, +y and +z, to the truck walls or
+// the nearest box in the way. A box at the point needs each run to cover its side.
+template <typename T>
+struct Candidate {
+  T x;
+  T y;
+  T z;
+  T rx;
+  T ry;
+  T rz;
+
+  T shortest_run() const { return std::min({rx, ry, rz}); }
+};
+
+// Shortens c's runs by a box in their way; false when c lies inside it.
+template <typename T>
+bool clip_runs(Candidate<T>& c, T x0, T x1, T y0, T y1, T z0, T z1) {
+  const T eps = static_cast<T>(kEps);
+  const bool in_x = x0 <= c.x + eps && c.x < x1 - eps;
+  const bool in_y = y0 <= c.y + eps && c.y < y1 - eps;
+  const bool in_z = z0 <= c.z + eps && c.z < z1 - eps;
+  if (in_x && in_y && in_z) return false;
+  if (in_y && in_z && x0 > c.x) c.rx = std::min(c.rx, x0 - c.x);
+  if (in_x && in_z && y0 > c.y) c.ry = std::min(c.ry, y0 - c.y);
+  if (in_x && in_y && z0 > c.z) c.rz = std::min(c.rz, z0 - c.z);
+  return true;
+}
+
+// Shortest side of every box not yet offered to a decoder. Space that cannot hold the
+// smallest of them along some axis can never be used again and may be dropped for good.
+class RemainingSides {
+ public:
+  void reset(const PreparedInstance& inst) {
+    sides_.clear();
+    for (const auto& b : inst.boxes) sides_.insert(std::min({b.w, b.h, b.d}));
+  }
+  void take(const Box& b) {
+    const auto it = sides_.find(std::min({b.w, b.h, b.d}));
+    if (it != sides_.end()) sides_.erase(it);
+  }
+  double smallest() const { return sides_.empty() ? std::numeric_limits<double>::infinity() : *sides_.begin(); }
+
+ private:
+  std::multiset<double> sides_;
+};
+
+
+// Weight moments of a load about the truck's front-left floor corner: each box adds its
+// weight times its centroid, so the centre of gravity and the axle loads follow in O(1).
+struct LoadMoments {
+  double weight = 0;
+  double x = 0;  // kg·m
+  double y = 0;
+  double z = 0;
+
+  void add(double w, double cx, double cy, double cz) {
+    weight += w;
+    x += w * cx;
+    y += w * cy;
+    z += w * cz;
+  }
+};
+
+inline bool has_axles(const Truck& t) { return t.rear_axle_z > t.front_axle_z; }
+
+inline bool has_balance_limits(const Truck& t) {
+  return (has_axles(t) && (t.front_axle_max > 0 || t.rear_axle_max > 0)) || t.max_lateral_offset > 0;
+}
+
+// Load on the rear support; the front one carries the rest.
+inline double rear_axle_load(const Truck& t, double weight, double moment_z) {
+  return (moment_z - t.front_axle_z * weight) / (t.rear_axle_z - t.front_axle_z);
+}
+
+// Writes the centre of gravity and axle loads of `m` into r.
+inline void report_balance(const Truck& t, const LoadMoments& m, Result* r) {
+  const bool empty = !(m.weight > 0);
+  r->cog_x = empty ? 0 : m.x / m.weight;
+  r->cog_y = empty ? 0 : m.y / m.weight;
+  r->cog_z = empty ? 0 : m.z / m.weight;
+  r->rear_axle_load = has_axles(t) ? rear_axle_load(t, m.weight, m.z) : 0;
+  r->front_axle_load = has_axles(t) ? m.weight - r->rear_axle_load : 0;
+}
+
+// The truck's axle and lateral limits, checked against the running moments of a decode.
+//
+// Axle loads are checked as they would stand after each placement, so the final plan
+// keeps within them. The lateral offset cannot be: the first box always sits against a
+// wall. Its moment about the centreline may instead exceed the final allowance by what
+// the rest of the planned load (every box in the instance, capped at max_weight) could
+// still offset from the far wall, so it holds exactly once that load is placed; when
+// some of it stays out, settle_lateral_offset (decoder.h) trims the finished plan.
+class BalanceLimits {
+ public:
+  explicit BalanceLimits(const PreparedInstance& inst) : truck_(inst.truck) {
+    axles_ = has_axles(truck_) && (truck_.front_axle_max > 0 || truck_.rear_axle_max > 0);
+    if (truck_.max_lateral_offset > 0) {
+      double planned = 0;
+      for (const auto& b : inst.boxes) planned += b.weight;
+      planned_ = std::min(planned, truck_.max_weight);
+    }
+    active_ = has_balance_limits(truck_);
+  }
+
+  // Whether adding `weight` with its centroid at (cx, cz) keeps m within the limits.
+  bool allows(const LoadMoments& m, double weight, double cx, double cz) const {
+    if (!active_) return true;
+    const double total = m.weight + weight;
+    if (truck_.max_lateral_offset > 0) {
+      const double moment = std::fabs(m.x + weight * cx - total * truck_.w / 2);
+      const double slack = std::max(0.0, planned_ - total) * truck_.w / 2;
+      if (moment > truck_.max_lateral_offset * planned_ + slack + kEps) return false;
+    }
+    if (axles_) {
+      const double rear = rear_axle_load(truck_, total, m.z + weight * cz);
+      if (truck_.rear_axle_max > 0 && rear > truck_.rear_axle_max + kEps) return false;
+      if (truck_.front_axle_max > 0 && total - rear > truck_.front_axle_max + kEps) return false;
+    }
+    return true;
+  }
+
+ private:
+  Truck truck_;
+  bool axles_ = false;
+  bool active_ = false;
+  double planned_ = 0;  // kg
+};
+
+}  // namespace packing
+}  // namespace engine
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine_types.h"
+
+namespace engine {
+
+// Placements that changed between two successive incumbents.
+struct PlacementDelta {
+  std::vector<Placement> upserts;    // new boxes, or boxes that moved/rotated
+  std::vector<std::string> removed;  // ids no longer placed
+};
+
+// Turns a sequence of full results into deltas, so streaming consumers only receive
+// what changed. Box ids are assumed unique within an instance (as the UI does).
+class PlacementDiffer {
+ public:
+  // Diff against the previously seen result; the first call returns every placement.
+  PlacementDelta update(const Result& r);
+  void reset() { last_.clear(); }
+  size_t size() const { return last_.size(); }
+
+ private:
+  std::unordered_map<std::string, Placement> last_;
+};
+
+}  // namespace engine
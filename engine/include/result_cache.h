@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "engine_types.h"
+#include "instance.h"
+#include "optimizer.h"
+
+namespace engine {
+
+// Finished plans by content, so asking again for the same manifest, truck and params
+// returns the stored plan instead of rerunning the GA.
+//
+// Least-recently-used plans leave memory once the estimated footprint exceeds the cap.
+// With a spill directory they are written there in the wire result format
+// (<key>.vlrs) and read back on a later miss; the directory is never pruned. Each file
+// starts with a header naming the spill format, kPlanVersion and the key, and a file
+// whose header does not match this build and key is a miss, so a directory kept across
+// upgrades never serves a plan the running engine would not make.
+// Thread-safe.
+class ResultCache {
+ public:
+  // Bump whenever a change to the decoders, the GA or the physics may plan the same
+  // request differently.
+  static constexpr uint32_t kPlanVersion = 1;
+
+  struct Stats {
+    size_t entries;
+    size_t bytes;
+    size_t capacity_bytes;
+    size_t hits;       // answered from memory
+    size_t disk_hits;  // answered from the spill directory
+    size_t misses;
+    size_t evictions;
+    size_t spilled;  // evictions written to the spill directory
+  };
+
+  explicit ResultCache(size_t capacity_bytes, std::string spill_dir = "")
+      : capacity_bytes_(capacity_bytes), spill_dir_(std::move(spill_dir)) {}
+
+  // The run's key: instance_hash() combined with every param that changes the plan
+  // (parallel_for does not). nullopt for runs that cannot be cached: warm
+  // starts depend on what ran before.
+  static std::optional<uint64_t> key(const PreparedInstance& instance, const GaParams& params);
+
+  // nullptr on a miss. A hit refreshes the entry's recency.
+  std::shared_ptr<const Result> get(uint64_t key);
+  void put(uint64_t key, const Result& result);
+  // A capacity of 0 turns the cache off; an empty directory turns spilling off.
+  void configure(size_t capacity_bytes, std::string spill_dir);
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const Result> result;
+    size_t bytes;
+    std::list<uint64_t>::iterator lru_pos;
+  };
+  using Evicted = std::list<std::pair<uint64_t, std::shared_ptr<const Result>>>;
+
+  void insert(uint64_t key, std::shared_ptr<const Result> result, Evicted* evicted);
+  void evict_to(size_t limit, Evicted* evicted);
+  void spill(const std::string& dir, const Evicted& evicted);
+  std::shared_ptr<const Result> read_spilled(const std::string& dir, uint64_t key) const;
+
+  mutable std::mutex mu_;
+  size_t capacity_bytes_;
+  std::string spill_dir_;
+  size_t bytes_ = 0;
+  Stats counts_{};
+  std::list<uint64_t> lru_;  // front = most recently used
+  std::unordered_map<uint64_t, Entry> entries_;
+};
+
+}  // namespace engine
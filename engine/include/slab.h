@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+#include "engine_types.h"
+#include "instance.h"
+#include "optimizer.h"
+
+namespace engine {
+
+// Large-instance mode: pack a long truck as a row of independent slabs along its depth.
+//
+// A pre-pass deals boxes (largest first, snake order) into slabs of roughly
+// `slab_boxes` boxes, each slab is a full-width, full-height sub-truck packed by the
+// regular GA (concurrently through `params.parallel_for` when set), and the slabs are
+// then stitched front to back, each shifted forward by the depth the previous ones
+// actually used. No box spans a slab boundary, so support and crush state need no
+// cross-slab bookkeeping. Leftovers get one extra pass in the depth freed at the back.
+//
+// params.on_progress gets one step per finished slab plus one for the leftover pass; the
+// incumbent is the stitched run of finished slabs from the front of the truck.
+//
+// Cost grows with slab count times a bounded per-slab GA, i.e. roughly linearly in the
+// number of boxes instead of quadratically.
+Result optimize_slabs(const PreparedInstance& instance, const GaParams& params);
+
+// Whether params.slab_mode sends this instance through optimize_slabs. kAuto keeps trucks
+// with balance limits or several stops whole: slabs would be packed without them.
+bool use_slabs(const GaParams& params, const PreparedInstance& instance);
+
+}  // namespace engine
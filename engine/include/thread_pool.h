@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace engine {
+
+// Fork-join pool with per-worker deques and work stealing.
+//
+// Workers pop from the back of their own deque and steal from the front of others', so
+// nested parallel_for calls (a batch task fanning out its GA decodes) stay local while
+// idle workers pick up whatever is left. A caller waiting in parallel_for runs pending
+// tasks instead of blocking, which keeps nesting deadlock-free.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t threads);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Calls fn(0..n-1), possibly concurrently, and returns when all calls are done.
+  // The first exception thrown by fn is rethrown here after the others finish.
+  void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+  size_t size() const { return threads_.size(); }
+
+ private:
+  using Task = std::function<void()>;
+
+  struct Deque {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  void push(Task task);
+  bool try_run_one();
+  void worker_loop(size_t index);
+
+  std::vector<std::unique_ptr<Deque>> deques_;
+  std::vector<std::thread> threads_;
+  std::mutex sleep_mu_;
+  std::condition_variable wake_;
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> next_deque_{0};
+  bool stopping_ = false;
+};
+
+}  // namespace engine
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+#include "instance.h"
+
+namespace engine {
+
+// Warm starts: a re-optimization after a small manifest change begins from the box order
+// of the earlier plan instead of from scratch.
+
+// Content hash of the truck and boxes (ids included), the same for any order of the
+// boxes. Not cryptographic.
+uint64_t instance_hash(const PreparedInstance& instance);
+
+// The order of the GA's heuristic first individual: boxes for later stops first, then
+// larger volume, then higher priority.
+bool packs_before(const PreparedInstance& instance, size_t a, size_t b);
+
+// A plan's box order as a seed: placed ids in placement order, then the unplaced ones.
+std::vector<std::string> plan_order(const Result& result);
+
+// The order `ids` names, as indices into instance.boxes. Ids the instance lacks are
+// dropped; a repeated id takes the next box carrying it. Boxes the order lacks are merged
+// in by packs_before, each going before the first box of the order that it packs before,
+// so a manifest that gained a few boxes keeps its old sequence around them.
+std::vector<size_t> warm_order(const PreparedInstance& instance, const std::vector<std::string>& ids);
+
+// Box orders of recent plans, to seed the next run on the same manifest or a slightly
+// changed one (GaParams::warm_start). Thread-safe; least-recently-used entries go first.
+class WarmStartCache {
+ public:
+  explicit WarmStartCache(size_t capacity) : capacity_(capacity) {}
+
+  // The order of the cached plan for this instance; failing that, of the cached plan on
+  // the same truck (sides, payload and balance limits) sharing the most box ids, if it
+  // shares at least half of this instance's. Empty when there is none.
+  std::vector<std::string> lookup(const PreparedInstance& instance);
+  void store(const PreparedInstance& instance, const Result& result);
+  size_t size() const;
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    Truck truck;
+    std::vector<std::string> ids;  // sorted
+    std::vector<std::string> order;
+  };
+
+  mutable std::mutex mu_;
+  size_t capacity_;
+  std::list<Entry> entries_;  // front = most recently used
+};
+
+}  // namespace engine
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "wire format assumes a little-endian host"
+#endif
+
+namespace engine {
+namespace wire {
+
+// Binary request/result format shared by the backend and the engine service.
+//
+// Every message starts with an 8-byte header: 4-byte magic, u16 version, u16 flags.
+// Numbers are little-endian. Bulk data lives in "column blocks" so large manifests
+// are a handful of contiguous arrays instead of one JSON object per box:
+//
+//   column block := u32 row_count, u32 column_count, column*
+//   column       := u16 tag, u16 dtype, u32 reserved, u64 byte_len, data, pad to 8
+//
+// Strings columns hold u32 offsets[row_count + 1] followed by the UTF-8 bytes.
+// Readers skip unknown tags, so new columns don't need a version bump.
+//
+//   request := header("VLRQ"), f64 truck[4] (w, h, d, max_weight),
+//              box column block, param block
+//   result  := header("VLRS"), placement column block,
+//              unplaced column block (ids only), metric block
+//
+// Param block: u32 count, then per entry u16 key_len, u8 type, u8 reserved, key bytes,
+// then either an f64 (type 1) or u32 len + bytes (type 2).
+// Metric block: u32 count, then per entry u16 key_len, key bytes, f64 value.
+
+constexpr char kRequestMagic[4] = {'V', 'L', 'R', 'Q'};
+constexpr char kResultMagic[4] = {'V', 'L', 'R', 'S'};
+constexpr uint16_t kVersion = 1;
+constexpr const char* kContentType = "application/x-vectorload";
+
+enum ColumnTag : uint16_t {
+  kColId = 1,
+  kColW = 2,
+  kColH = 3,
+  kColD = 4,
+  kColWeight = 5,
+  kColPriority = 6,
+  kColX = 7,
+  kColY = 8,
+  kColZ = 9,
+  kColOrientations = 10,  // i32 orientation mask; only written when some box restricts it
+  kColMaxLoad = 11,       // f64 Box::max_load; only written when some box sets it
+  kColFragile = 12,       // i32 Box::fragile (0/1); only written when some box is fragile
+  kColDrop = 13,          // i32 Box::drop; only written when some box sets a stop
+};
+
+enum DType : uint16_t {
+  kF64 = 1,
+  kI32 = 2,
+  kStrings = 3,
+};
+
+enum ParamType : uint8_t {
+  kParamNumber = 1,
+  kParamString = 2,
+};
+
+struct Param {
+  std::string key;
+  ParamType type;
+  double number;
+  std::string text;
+};
+
+struct Request {
+  Truck truck;
+  std::vector<Box> boxes;
+  std::vector<Param> params;
+};
+
+class ByteWriter {
+ public:
+  void bytes(const void* p, size_t n) {
+    const auto* b = static_cast<const uint8_t*>(p);
+    buf_.insert(buf_.end(), b, b + n);
+  }
+  template <typename T>
+  void put(T v) {
+    bytes(&v, sizeof(T));
+  }
+  void pad_to(size_t align) {
+    while (buf_.size() % align != 0) buf_.push_back(0);
+  }
+  size_t size() const { return buf_.size(); }
+  std::vector<uint8_t>& buffer() { return buf_; }
+
+ private:
+  std::vector<uint8_t> buf_;
+};
+
+class ByteReader {
+ public:
+  ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  const uint8_t* take(size_t n) {
+    if (n > size_ - pos_) throw std::runtime_error("wire: truncated message");
+    const uint8_t* p = data_ + pos_;
+    pos_ += n;
+    return p;
+  }
+  template <typename T>
+  T get() {
+    T v;
+    std::memcpy(&v, take(sizeof(T)), sizeof(T));
+    return v;
+  }
+  void align_to(size_t align) {
+    const size_t rem = pos_ % align;
+    if (rem != 0) take(align - rem);
+  }
+  size_t pos() const { return pos_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+// A decoded column; `data` points into the reader's buffer (no copy).
+struct Column {
+  uint16_t tag;
+  uint16_t dtype;
+  const uint8_t* data;
+  uint64_t byte_len;
+};
+
+struct ColumnBlock {
+  uint32_t rows = 0;
+  std::vector<Column> columns;
+
+  const Column* find(uint16_t tag, uint16_t dtype) const;
+  double f64(const Column& c, size_t row) const;
+  int32_t i32(const Column& c, size_t row) const;
+  std::string str(const Column& c, size_t row) const;
+};
+
+void write_header(ByteWriter& out, const char magic[4]);
+void read_header(ByteReader& in, const char magic[4]);
+
+void begin_column_block(ByteWriter& out, uint32_t rows, uint32_t columns);
+void write_f64_column(ByteWriter& out, uint16_t tag, const std::vector<double>& values);
+void write_i32_column(ByteWriter& out, uint16_t tag, const std::vector<int32_t>& values);
+void write_strings_column(ByteWriter& out, uint16_t tag, const std::vector<std::string>& values);
+ColumnBlock read_column_block(ByteReader& in);
+
+void write_box_columns(ByteWriter& out, const std::vector<Box>& boxes);
+std::vector<Box> boxes_from_columns(const ColumnBlock& block);
+
+std::vector<uint8_t> encode_request(const Request& req);
+Request decode_request(const uint8_t* data, size_t size);
+
+std::vector<uint8_t> encode_result(const Result& r);
+Result decode_result(const uint8_t* data, size_t size);
+
+}  // namespace wire
+}  // namespace engine
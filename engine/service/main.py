@@ -5,16 +5,55 @@ Keeps the backend thin and gives me a process boundary for timeouts/crashes.
 
 from __future__ import annotations
 
+import json
 import os
-from typing import Any
+import queue
+import re
+import threading
+import time
+import uuid
+from pathlib import Path
+from typing import Any, Callable
 
 import engine_bindings
-from flask import Flask, jsonify, request
+from flask import Flask, Response, jsonify, request
 
 app = Flask(__name__)
 
 DEFAULT_HOST = "0.0.0.0"
 DEFAULT_PORT = 6000
+WIRE_CONTENT_TYPE = engine_bindings.WIRE_CONTENT_TYPE
+DATA_DIR = Path(os.environ.get("DATA_DIR", "/app/data"))
+DATASET_ID_RE = re.compile(r"^[A-Za-z0-9_-]+$")
+REGISTRY_MB = int(os.environ.get("ENGINE_REGISTRY_MB", "512"))
+JOB_WORKERS = int(os.environ.get("ENGINE_JOB_WORKERS", str(max(1, (os.cpu_count() or 2) // 2))))
+JOB_QUEUE = int(os.environ.get("ENGINE_JOB_QUEUE", "64"))
+STREAM_INTERVAL_MS = int(os.environ.get("ENGINE_STREAM_INTERVAL_MS", "250"))
+BATCH_THREADS = int(os.environ.get("ENGINE_BATCH_THREADS", "0"))
+MAX_SESSIONS = int(os.environ.get("ENGINE_MAX_SESSIONS", "256"))
+RESULT_CACHE_MB = int(os.environ.get("ENGINE_RESULT_CACHE_MB", "64"))
+RESULT_CACHE_DIR = os.environ.get("ENGINE_RESULT_CACHE_DIR", "")
+
+engine_bindings.configure_registry(REGISTRY_MB << 20)
+engine_bindings.configure_jobs(JOB_WORKERS, JOB_QUEUE)
+engine_bindings.configure_result_cache(RESULT_CACHE_MB << 20, RESULT_CACHE_DIR)
+if BATCH_THREADS > 0:
+    engine_bindings.configure_batch(BATCH_THREADS)
+
+
+def _dataset_path(dataset_id: str) -> Path | None:
+    """Resolve a dataset id to its columnar file under DATA_DIR (ids never contain paths)."""
+    if not DATASET_ID_RE.match(dataset_id):
+        return None
+    path = DATA_DIR / f"{dataset_id}{engine_bindings.DATASET_SUFFIX}"
+    return path if path.is_file() else None
+
+
+def _wants_wire() -> bool:
+    """True when the client prefers the binary result format over JSON."""
+    # `*/*` (the default for most HTTP clients) ties and keeps JSON.
+    accept = request.accept_mimetypes
+    return accept[WIRE_CONTENT_TYPE] > accept["application/json"]
 
 
 @app.get("/health")
@@ -23,26 +62,457 @@ def health() -> Any:
     return jsonify({"status": "ok"})
 
 
+def _with_dataset(dataset_id: str, call: Callable[[], Any]) -> Any | None:
+    """Run `call` against a registered dataset, registering it from DATA_DIR on a miss.
+
+    `call` raises KeyError for unregistered ids. Returns None when the id is neither
+    registered nor a dataset file.
+    """
+    try:
+        return call()
+    except KeyError:
+        pass
+    path = _dataset_path(dataset_id)
+    if path is None:
+        return None
+    engine_bindings.register_dataset_file(dataset_id, str(path))
+    return call()
+
+
+@app.get("/datasets")
+def dataset_stats() -> Any:
+    """Registry occupancy: entry count, estimated bytes, capacity and evictions so far."""
+    return jsonify(engine_bindings.registry_stats())
+
+
+@app.get("/metrics")
+def metrics() -> Any:
+    """Result cache counters (hits from memory and from the spill directory, misses,
+    evictions) and dataset registry occupancy."""
+    return jsonify(
+        {
+            "result_cache": engine_bindings.result_cache_stats(),
+            "registry": engine_bindings.registry_stats(),
+        }
+    )
+
+
+@app.put("/datasets/<dataset_id>")
+def register_dataset(dataset_id: str) -> Any:
+    """Upload a manifest once so later `/optimize` calls can reference it by `dataset_id`.
+
+    Body is either the binary wire request (params are ignored) or JSON `{truck, boxes}`.
+    The engine keeps the parsed boxes plus per-box precomputation (volumes, orientation
+    tables, type grouping) in memory, evicting least-recently-used datasets beyond
+    `ENGINE_REGISTRY_MB`.
+    """
+    if not DATASET_ID_RE.match(dataset_id):
+        return jsonify({"error": "invalid_request", "message": "invalid dataset id"}), 400
+    try:
+        if request.mimetype == WIRE_CONTENT_TYPE:
+            info = engine_bindings.register_dataset_wire(dataset_id, request.get_data())
+        else:
+            payload = request.get_json(silent=True) or {}
+            info = engine_bindings.register_dataset(
+                dataset_id, payload.get("truck") or {}, payload.get("boxes") or []
+            )
+    except MemoryError as exc:
+        return jsonify({"error": "dataset_too_large", "message": str(exc)}), 413
+    except (KeyError, TypeError, ValueError) as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+    return jsonify(info), 201
+
+
+@app.delete("/datasets/<dataset_id>")
+def unregister_dataset(dataset_id: str) -> Any:
+    if not engine_bindings.unregister_dataset(dataset_id):
+        return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+    return jsonify({"deleted": dataset_id})
+
+
 @app.post("/optimize")
 def optimize() -> Any:
     """Optimize a packing instance.
 
     The heavy work is delegated to the native optimizer; this route keeps request/response
     small and focused so the backend can treat it like an RPC call.
+
+    Content negotiation: a `Content-Type: application/x-vectorload` body is decoded natively
+    (see `engine/include/wire_format.h`); `Accept: application/x-vectorload` gets a binary
+    result back. Everything else stays JSON, and errors are always JSON.
+
+    A JSON body of `{dataset_id, params?}` optimizes a registered dataset (see
+    `PUT /datasets/<id>`), or a columnar dataset the backend wrote to the shared DATA_DIR,
+    which is memory-mapped and registered on first use. Unknown ids get 404
+    `dataset_not_found`.
     """
-    payload = request.get_json(silent=True) or {}
-    truck = payload.get("truck") or {}
-    boxes = payload.get("boxes") or []
-    params = payload.get("params") or {}
+    binary_out = _wants_wire()
 
     try:
-        out = engine_bindings.optimize(truck, boxes, params)
+        if request.mimetype == WIRE_CONTENT_TYPE:
+            try:
+                out = engine_bindings.optimize_wire(request.get_data(), binary_out)
+            except ValueError as exc:
+                return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+        else:
+            payload = request.get_json(silent=True) or {}
+            params = payload.get("params") or {}
+            dataset_id = payload.get("dataset_id")
+            if dataset_id:
+                dataset_id = str(dataset_id)
+                out = _with_dataset(
+                    dataset_id,
+                    lambda: engine_bindings.optimize_registered(dataset_id, params, binary_out),
+                )
+                if out is None:
+                    return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            else:
+                truck = payload.get("truck") or {}
+                boxes = payload.get("boxes") or []
+                out = engine_bindings.optimize(truck, boxes, params)
+                if binary_out:
+                    out = engine_bindings.encode_result(out)
+
+        if binary_out:
+            return Response(out, mimetype=WIRE_CONTENT_TYPE)
         return jsonify(out)
+    except ValueError as exc:
+        # Invalid params (e.g. an unknown slab_mode).
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
     except Exception as exc:
         app.logger.exception("Engine optimize failed")
         return jsonify({"error": "engine_error", "message": str(exc)}), 500
 
 
+@app.post("/optimize/batch")
+def optimize_batch() -> Any:
+    """Optimize many independent instances in one call.
+
+    Body: `{"instances": [...]}` where each item is `{truck, boxes, params?}` or
+    `{dataset_id, params?}`. Instances share one native work-stealing pool: small ones
+    are grouped onto threads, large ones also decode GA offspring in parallel.
+
+    Response: `{"results": [...], "elapsed_ms"}`, results in input order, each shaped like
+    `/optimize` plus `elapsed_ms`, or `{error, elapsed_ms}` if that instance failed.
+    400 for a malformed instance, 404 when a `dataset_id` is unknown.
+    """
+    payload = request.get_json(silent=True) or {}
+    instances = payload.get("instances")
+    if not isinstance(instances, list):
+        return jsonify({"error": "invalid_request", "message": "instances must be a list"}), 400
+
+    for item in instances:
+        dataset_id = item.get("dataset_id") if isinstance(item, dict) else None
+        if dataset_id and engine_bindings.dataset_info(str(dataset_id)) is None:
+            path = _dataset_path(str(dataset_id))
+            if path is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            engine_bindings.register_dataset_file(str(dataset_id), str(path))
+
+    start = time.perf_counter()
+    try:
+        results = engine_bindings.optimize_batch(instances)
+    except KeyError as exc:
+        # Evicted between the check above and the call; rare enough to just report.
+        return jsonify({"error": "dataset_not_found", "dataset_id": exc.args[0]}), 404
+    except ValueError as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+    except Exception as exc:
+        app.logger.exception("Engine batch failed")
+        return jsonify({"error": "engine_error", "message": str(exc)}), 500
+
+    elapsed_ms = (time.perf_counter() - start) * 1000.0
+    return jsonify({"results": results, "elapsed_ms": elapsed_ms})
+
+
+@app.post("/optimize/fleet")
+def optimize_fleet() -> Any:
+    """Pack one manifest into a fleet of trucks in a single call.
+
+    Body: `{fleet, boxes, params?}` or `{fleet, dataset_id, params?}` where `fleet` is a
+    list of truck types `{id?, w, h, d, max_weight?, count}`. `params` takes the GA params
+    plus `fill_target` (share of a truck's volume assigned before opening the next one).
+
+    Response: `{trucks: [{truck_type, index, truck, placed, unplaced, metrics}],
+    unplaced, metrics: {trucks_used, used_volume, capacity_volume, utilization,
+    total_weight}}`. Trucks are packed in parallel on the batch pool.
+    """
+    payload = request.get_json(silent=True) or {}
+    fleet = payload.get("fleet")
+    params = payload.get("params") or {}
+    if not isinstance(fleet, list) or not fleet:
+        message = "fleet must be a non-empty list"
+        return jsonify({"error": "invalid_request", "message": message}), 400
+
+    try:
+        dataset_id = payload.get("dataset_id")
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            out = _with_dataset(
+                dataset_id,
+                lambda: engine_bindings.optimize_fleet_registered(dataset_id, fleet, params),
+            )
+            if out is None:
+                return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+        else:
+            out = engine_bindings.optimize_fleet(fleet, payload.get("boxes") or [], params)
+    except (KeyError, TypeError, ValueError) as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+    except Exception as exc:
+        app.logger.exception("Engine fleet optimize failed")
+        return jsonify({"error": "engine_error", "message": str(exc)}), 500
+    return jsonify(out)
+
+
+def _sse(event: str, data: Any) -> str:
+    return f"event: {event}\ndata: {json.dumps(data, separators=(',', ':'))}\n\n"
+
+
+@app.post("/optimize/stream")
+def optimize_stream() -> Any:
+    """Optimize while streaming best-so-far plans as Server-Sent Events.
+
+    Takes the same bodies as `/optimize`; `?interval_ms=` overrides the minimum gap between
+    events (`ENGINE_STREAM_INTERVAL_MS`, default 250). Events:
+
+    - `progress`: `{generation, generations, best_score, utilization, placed, unplaced,
+      improved, delta: {upserts, removed}}`; `delta` is relative to the previous event,
+      so a client rebuilds the incumbent without receiving the full plan each time.
+    - `result`: the final result, same shape as `/optimize`.
+    - `error`: `{error, message}` if the run fails after the stream has started.
+
+    Closing the connection cancels the run after its current generation.
+    """
+    try:
+        interval_ms = int(request.args.get("interval_ms", STREAM_INTERVAL_MS))
+    except ValueError:
+        message = "interval_ms must be an integer"
+        return jsonify({"error": "invalid_request", "message": message}), 400
+
+    if request.mimetype == WIRE_CONTENT_TYPE:
+        data = request.get_data()
+
+        def run(on_event: Callable[[dict[str, Any]], bool]) -> Any:
+            return engine_bindings.optimize_stream_wire(data, on_event, interval_ms)
+
+    else:
+        payload = request.get_json(silent=True) or {}
+        params = payload.get("params") or {}
+        dataset_id = payload.get("dataset_id")
+        if dataset_id:
+            dataset_id = str(dataset_id)
+            if engine_bindings.dataset_info(dataset_id) is None:
+                path = _dataset_path(dataset_id)
+                if path is None:
+                    return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+                engine_bindings.register_dataset_file(dataset_id, str(path))
+
+            def run(on_event: Callable[[dict[str, Any]], bool]) -> Any:
+                return _with_dataset(
+                    dataset_id,
+                    lambda: engine_bindings.optimize_stream_registered(
+                        dataset_id, params, on_event, interval_ms
+                    ),
+                )
+
+        else:
+            truck = payload.get("truck") or {}
+            boxes = payload.get("boxes") or []
+
+            def run(on_event: Callable[[dict[str, Any]], bool]) -> Any:
+                return engine_bindings.optimize_stream(truck, boxes, params, on_event, interval_ms)
+
+    def events() -> Any:
+        # The GA runs on its own thread so a slow client never stalls it; progress
+        # events are queued and written out here.
+        out: queue.Queue[tuple[str, Any] | None] = queue.Queue()
+        closed = threading.Event()
+
+        def on_event(event: dict[str, Any]) -> bool:
+            out.put(("progress", event))
+            return not closed.is_set()
+
+        def worker() -> None:
+            try:
+                out.put(("result", run(on_event)))
+            except Exception as exc:
+                app.logger.exception("Engine stream failed")
+                out.put(("error", {"error": "engine_error", "message": str(exc)}))
+            finally:
+                out.put(None)
+
+        threading.Thread(target=worker, daemon=True).start()
+        try:
+            while (item := out.get()) is not None:
+                yield _sse(*item)
+        finally:
+            closed.set()
+
+    return Response(
+        events(),
+        mimetype="text/event-stream",
+        headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"},
+    )
+
+
+@app.post("/jobs")
+def submit_job() -> Any:
+    """Queue an optimize job and return its id right away (202).
+
+    Accepts the same bodies as `/optimize` (wire, JSON inline or `{dataset_id}`); the
+    optional `?priority=<int>` query param picks the queue (higher runs first) and `?label=`
+    tags the job (dataset jobs are labelled with their id). A bounded
+    native worker pool runs jobs, so long optimizations never hold the HTTP connection.
+
+    Failure modes: 400 invalid body, 404 unknown dataset, 503 `queue_full`.
+    """
+    try:
+        priority = int(request.args.get("priority", "0"))
+    except ValueError:
+        return jsonify({"error": "invalid_request", "message": "priority must be an integer"}), 400
+    label = request.args.get("label", "")
+
+    try:
+        if request.mimetype == WIRE_CONTENT_TYPE:
+            job_id = engine_bindings.submit_job_wire(request.get_data(), priority, label)
+        else:
+            payload = request.get_json(silent=True) or {}
+            params = payload.get("params") or {}
+            dataset_id = payload.get("dataset_id")
+            if dataset_id:
+                dataset_id = str(dataset_id)
+                job_id = _with_dataset(
+                    dataset_id,
+                    lambda: engine_bindings.submit_job_registered(dataset_id, params, priority),
+                )
+                if job_id is None:
+                    return jsonify({"error": "dataset_not_found", "dataset_id": dataset_id}), 404
+            else:
+                job_id = engine_bindings.submit_job(
+                    payload.get("truck") or {}, payload.get("boxes") or [], params, priority, label
+                )
+    except engine_bindings.QueueFullError as exc:
+        return jsonify({"error": "queue_full", "message": str(exc)}), 503
+    except (KeyError, TypeError, ValueError) as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+
+    return jsonify({"job_id": job_id, "status": "queued"}), 202
+
+
+@app.get("/jobs/<int:job_id>")
+def job_status(job_id: int) -> Any:
+    """Job status, best-so-far progress (generation, score, utilization) and, once
+    finished, the result. `?result=0` skips the result payload for cheap polling.
+    """
+    include_result = request.args.get("result", "1") != "0"
+    status = engine_bindings.job_status(job_id, include_result)
+    if status is None:
+        return jsonify({"error": "job_not_found", "job_id": job_id}), 404
+    return jsonify(status)
+
+
+@app.delete("/jobs/<int:job_id>")
+def cancel_job(job_id: int) -> Any:
+    """Cancel a job. Queued jobs are dropped; running ones stop after the current
+    generation and keep their best plan so far."""
+    status = engine_bindings.job_status(job_id, False)
+    if status is None:
+        return jsonify({"error": "job_not_found", "job_id": job_id}), 404
+    if not engine_bindings.cancel_job(job_id):
+        return jsonify({"error": "job_finished", "job_id": job_id, "status": status["status"]}), 409
+    return jsonify({"job_id": job_id, "status": "cancelling"})
+
+
+# Live loading sessions: id -> (lock, Packer). Each session serialises its own calls.
+_sessions: dict[str, tuple[threading.Lock, Any]] = {}
+_sessions_mu = threading.Lock()
+
+
+def _session(session_id: str) -> tuple[threading.Lock, Any] | None:
+    with _sessions_mu:
+        return _sessions.get(session_id)
+
+
+def _session_not_found(session_id: str) -> Any:
+    return jsonify({"error": "session_not_found", "session_id": session_id}), 404
+
+
+@app.post("/sessions")
+def create_session() -> Any:
+    """Open a live loading session on one truck: JSON `{truck, params?}` (only the physics
+    params apply). Boxes are then added one at a time as they reach the dock.
+
+    Failure modes: 400 invalid body or a truck with axle or lateral limits, 503
+    `too_many_sessions` beyond `ENGINE_MAX_SESSIONS`.
+    """
+    payload = request.get_json(silent=True) or {}
+    try:
+        packer = engine_bindings.Packer(payload.get("truck") or {}, payload.get("params") or {})
+    except (KeyError, TypeError, ValueError) as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+    session_id = uuid.uuid4().hex
+    with _sessions_mu:
+        if len(_sessions) >= MAX_SESSIONS:
+            return jsonify({"error": "too_many_sessions", "limit": MAX_SESSIONS}), 503
+        _sessions[session_id] = (threading.Lock(), packer)
+    return jsonify({"session_id": session_id}), 201
+
+
+@app.post("/sessions/<session_id>/boxes")
+def add_session_box(session_id: str) -> Any:
+    """Place one box (the box object as JSON) next to those already loaded. Placed boxes
+    never move; a box that fits nowhere is listed as unplaced and `placement` is null.
+    400 for a box with a `drop` stop.
+    """
+    session = _session(session_id)
+    if session is None:
+        return _session_not_found(session_id)
+    box = request.get_json(silent=True)
+    if not isinstance(box, dict):
+        return jsonify({"error": "invalid_request", "message": "body must be a box object"}), 400
+    lock, packer = session
+    try:
+        with lock:
+            placement = packer.add_box(box)
+    except (KeyError, TypeError, ValueError) as exc:
+        return jsonify({"error": "invalid_request", "message": str(exc)}), 400
+    return jsonify({"placed": placement is not None, "placement": placement})
+
+
+@app.delete("/sessions/<session_id>/boxes/<box_id>")
+def remove_session_box(session_id: str, box_id: str) -> Any:
+    """Take a placed box back out. 409 when the box is not placed or others rest on it."""
+    session = _session(session_id)
+    if session is None:
+        return _session_not_found(session_id)
+    lock, packer = session
+    try:
+        with lock:
+            packer.remove_box(box_id)
+    except ValueError as exc:
+        return jsonify({"error": "cannot_remove", "message": str(exc)}), 409
+    return jsonify({"removed": box_id})
+
+
+@app.get("/sessions/<session_id>")
+def session_snapshot(session_id: str) -> Any:
+    """The session's current plan, in the `/optimize` result shape."""
+    session = _session(session_id)
+    if session is None:
+        return _session_not_found(session_id)
+    lock, packer = session
+    with lock:
+        return jsonify(packer.snapshot())
+
+
+@app.delete("/sessions/<session_id>")
+def close_session(session_id: str) -> Any:
+    with _sessions_mu:
+        if _sessions.pop(session_id, None) is None:
+            return _session_not_found(session_id)
+    return jsonify({"deleted": session_id})
+
+
 def main() -> None:
     host = os.environ.get("HOST", DEFAULT_HOST)
     port = int(os.environ.get("PORT", str(DEFAULT_PORT)))
@@ -0,0 +1,69 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <utility>
+
+namespace engine {
+
+namespace {
+
+void run_one(const BatchInstance& item, BatchResult& out, WorkStealingPool* intra) {
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    GaParams params = item.params;
+    if (intra) {
+      params.parallel_for = [intra](size_t n, const std::function<void(size_t)>& fn) { intra->parallel_for(n, fn); };
+    }
+    out.result = optimize_ga(*item.instance, params);
+  } catch (const std::exception& e) {
+    out.ok = false;
+    out.error = e.what();
+  }
+  out.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+std::vector<BatchResult> optimize_batch(const std::vector<BatchInstance>& batch,
+                                        WorkStealingPool& pool,
+                                        const BatchOptions& options) {
+  std::vector<BatchResult> results(batch.size());
+
+  // Large instances first (longest-processing-time order), each on its own.
+  std::vector<size_t> order(batch.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return batch[a].instance->boxes.size() > batch[b].instance->boxes.size();
+  });
+
+  struct Unit {
+    std::vector<size_t> members;
+    bool large;
+  };
+  std::vector<Unit> units;
+  size_t group_size = 0;
+  for (const size_t idx : order) {
+    const size_t boxes = batch[idx].instance->boxes.size();
+    if (boxes > options.small_instance_boxes) {
+      units.push_back(Unit{{idx}, true});
+      continue;
+    }
+    // Small instances share a task so a thousand tiny trucks don't become a thousand tasks.
+    if (units.empty() || units.back().large || group_size >= options.group_boxes) {
+      units.push_back(Unit{{}, false});
+      group_size = 0;
+    }
+    units.back().members.push_back(idx);
+    group_size += boxes;
+  }
+
+  pool.parallel_for(units.size(), [&](size_t u) {
+    const Unit& unit = units[u];
+    for (const size_t idx : unit.members) run_one(batch[idx], results[idx], unit.large ? &pool : nullptr);
+  });
+  return results;
+}
+
+}  // namespace engine
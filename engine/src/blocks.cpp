@@ -0,0 +1,220 @@
+#include "blocks.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "decoder.h"
+#include "packing_common.h"
+
+namespace engine {
+
+namespace {
+
+constexpr double kFitEps = 1e-9;
+
+struct Shape {
+  int nx = 0;
+  int ny = 0;
+  int nz = 0;
+  std::array<double, 3> unit{};
+
+  int count() const { return nx * ny * nz; }
+};
+
+// Largest full stack of at most `limit` units of one type; lower, then wider, on ties.
+Shape best_shape(const PreparedInstance& inst, const PhysicsModel& physics, size_t idx, size_t limit) {
+  const Truck& t = inst.truck;
+  const Box& box = inst.boxes[idx];
+  const OrientationSet& rots = inst.orientations[idx];
+  Shape best;
+  for (uint8_t ri = 0; ri < rots.count; ++ri) {
+    const auto& u = rots.dims[ri];
+    if (u[0] <= 0 || u[1] <= 0 || u[2] <= 0) continue;
+    const int max_x = static_cast<int>(std::floor(t.w / u[0] + kFitEps));
+    const int max_z = static_cast<int>(std::floor(t.d / u[2] + kFitEps));
+    int max_y = static_cast<int>(std::floor(t.h / u[1] + kFitEps));
+    // The bottom unit carries the ny - 1 above it.
+    if (physics.mode == PhysicsMode::kFull && box.weight > 0) {
+      const double capacity = packing::max_load_of(inst, physics, idx, u[0] * u[2]);
+      max_y = std::min(max_y, 1 + static_cast<int>(std::floor(capacity / box.weight + kFitEps)));
+    }
+    for (int ny = 1; ny <= max_y && static_cast<size_t>(ny) <= limit; ++ny) {
+      for (int nx = 1; nx <= max_x && static_cast<size_t>(nx * ny) <= limit; ++nx) {
+        const int nz = std::min(max_z, static_cast<int>(limit / static_cast<size_t>(nx * ny)));
+        if (nz < 1) continue;
+        Shape s{nx, ny, nz, u};
+        const bool wins = s.count() > best.count() ||
+                          (s.count() == best.count() &&
+                           (ny * u[1] < best.ny * best.unit[1] - kFitEps ||
+                            (std::fabs(ny * u[1] - best.ny * best.unit[1]) <= kFitEps &&
+                             nx * u[0] > best.nx * best.unit[0] + kFitEps)));
+        if (wins) best = s;
+      }
+    }
+  }
+  return best;
+}
+
+bool near(double a, double b) { return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b)); }
+
+}  // namespace
+
+BlockedInstance build_blocks(const PreparedInstance& inst, size_t max_block_boxes, const PhysicsModel& physics) {
+  const size_t n = inst.boxes.size();
+  const size_t limit = std::max<size_t>(max_block_boxes, 1);
+
+  std::vector<std::vector<size_t>> by_type(inst.type_count);
+  for (size_t i = 0; i < n; ++i) by_type[inst.type_of[i]].push_back(i);
+
+  BlockedInstance out;
+  std::vector<Box> items;
+  std::vector<char> emitted(inst.type_count, 0);
+  // Walk boxes in input order so items keep the manifest's order.
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t type = inst.type_of[i];
+    if (emitted[type]) continue;
+    emitted[type] = 1;
+    const auto& members = by_type[type];
+    size_t next = 0;
+    while (members.size() - next >= 2) {
+      const Shape s = best_shape(inst, physics, members[next], std::min(limit, members.size() - next));
+      if (s.count() < 2) break;
+      Block b;
+      b.members.assign(members.begin() + static_cast<std::ptrdiff_t>(next),
+                       members.begin() + static_cast<std::ptrdiff_t>(next + static_cast<size_t>(s.count())));
+      b.unit_w = s.unit[0];
+      b.unit_h = s.unit[1];
+      b.unit_d = s.unit[2];
+      b.nx = s.nx;
+      b.ny = s.ny;
+      b.nz = s.nz;
+      next += static_cast<size_t>(s.count());
+
+      const Box& unit = inst.boxes[b.members.front()];
+      items.push_back(Box{unit.id, b.nx * b.unit_w, b.ny * b.unit_h, b.nz * b.unit_d,
+                          unit.weight * static_cast<double>(s.count()), unit.priority});
+      items.back().drop = unit.drop;
+      out.blocks.push_back(std::move(b));
+      ++out.grouped;
+    }
+    for (; next < members.size(); ++next) {
+      const Box& unit = inst.boxes[members[next]];
+      items.push_back(unit);
+      Block b;
+      b.members = {members[next]};
+      b.unit_w = unit.w;
+      b.unit_h = unit.h;
+      b.unit_d = unit.d;
+      out.blocks.push_back(std::move(b));
+    }
+  }
+
+  // Single boxes keep the limits prepare_instance read from them.
+  out.instance = prepare_instance(inst.truck, std::move(items));
+  out.instance.rules.resize(out.blocks.size());
+  for (size_t k = 0; k < out.blocks.size(); ++k) {
+    const Block& b = out.blocks[k];
+    if (b.members.size() < 2) continue;
+    const Box& item = out.instance.boxes[k];
+    OrientationSet& rots = out.instance.orientations[k];
+    rots.dims[0] = {item.w, item.h, item.d};
+    rots.dims[1] = {item.d, item.h, item.w};
+    // Yawing the block yaws every unit; only allowed if the units may turn that way and
+    // the turned block still fits the truck, as best_shape made sure the unturned one does.
+    const OrientationSet& unit_rots = inst.orientations[b.members.front()];
+    const std::array<double, 3> yawed{b.unit_d, b.unit_h, b.unit_w};
+    const bool can_yaw =
+        std::find(unit_rots.dims.begin(), unit_rots.dims.begin() + unit_rots.count, yawed) !=
+            unit_rots.dims.begin() + unit_rots.count &&
+        item.d <= inst.truck.w + kFitEps && item.w <= inst.truck.d + kFitEps;
+    rots.count = (near(item.w, item.d) || !can_yaw) ? 1 : 2;
+
+    const size_t unit = b.members.front();
+    const double unit_weight = inst.boxes[unit].weight;
+    const double per_column = packing::max_load_of(inst, physics, unit, b.unit_w * b.unit_d) - (b.ny - 1) * unit_weight;
+    ItemRules& r = out.instance.rules[k];
+    r.max_load = std::max(packing::kEps, per_column) * b.nx * b.nz;
+    r.fragile = inst.boxes[unit].fragile;
+    r.min_support = inst.rules.empty() ? 0 : inst.rules[unit].min_support;
+  }
+  return out;
+}
+
+Result expand_blocks(const BlockedInstance& blocked, const PreparedInstance& source, const Result& result,
+                     DecoderKind kind, const PhysicsModel& physics) {
+  const auto& items = blocked.instance.boxes;
+  std::unordered_map<std::string, std::vector<size_t>> by_id;
+  for (size_t k = 0; k < items.size(); ++k) by_id[items[k].id].push_back(k);
+  std::vector<char> used(items.size(), 0);
+
+  // Ids only clash when the manifest repeats them; the volume then tells items apart.
+  auto take = [&](const std::string& id, double vol) -> const Block* {
+    auto it = by_id.find(id);
+    if (it == by_id.end()) return nullptr;
+    for (size_t k : it->second) {
+      if (used[k]) continue;
+      if (vol >= 0 && !near(blocked.instance.volumes[k], vol)) continue;
+      used[k] = 1;
+      return &blocked.blocks[k];
+    }
+    return nullptr;
+  };
+
+  // The plan is rebuilt box by box on a decoder over the source boxes, bottom layers of
+  // each block first, so every unit meets the per-box rules. A block's max load assumes
+  // an even spread over its top, and its base only had to meet one unit's support rule,
+  // so some units may not hold where the block put them; those, and the members of
+  // blocks that never fit, then go through the decoder one by one.
+  const std::unique_ptr<Decoder> decoder = make_decoder(source, kind, physics);
+  std::vector<size_t> retry;
+  std::vector<std::string> unknown;
+  for (const auto& p : result.placed) {
+    const Block* b = take(p.id, p.w * p.h * p.d);
+    if (!b) {
+      unknown.push_back(p.id);
+      continue;
+    }
+    if (b->members.size() == 1) {
+      if (!decoder->place_at(b->members.front(), p)) retry.push_back(b->members.front());
+      continue;
+    }
+    // Yawed blocks swap the x and z runs.
+    const bool yawed = !near(p.w, b->nx * b->unit_w) || !near(p.d, b->nz * b->unit_d);
+    const int cx = yawed ? b->nz : b->nx;
+    const int cz = yawed ? b->nx : b->nz;
+    const double uw = yawed ? b->unit_d : b->unit_w;
+    const double ud = yawed ? b->unit_w : b->unit_d;
+    size_t m = 0;
+    for (int iy = 0; iy < b->ny; ++iy) {
+      for (int iz = 0; iz < cz; ++iz) {
+        for (int ix = 0; ix < cx; ++ix) {
+          const size_t idx = b->members[m++];
+          const Placement unit{source.boxes[idx].id, p.x + ix * uw, p.y + iy * b->unit_h, p.z + iz * ud, uw, b->unit_h, ud};
+          if (!decoder->place_at(idx, unit)) retry.push_back(idx);
+        }
+      }
+    }
+  }
+  for (const auto& id : result.unplaced) {
+    const Block* b = take(id, -1);
+    if (!b) {
+      unknown.push_back(id);
+      continue;
+    }
+    retry.insert(retry.end(), b->members.begin(), b->members.end());
+  }
+  for (size_t idx : retry) decoder->place(idx);
+
+  // Items the blocked instance does not know cannot be placed here; report them.
+  Result out = decoder->result();
+  out.unplaced.insert(out.unplaced.end(), unknown.begin(), unknown.end());
+  settle_lateral_offset(source, decoder->supports(), &out);
+  return out;
+}
+
+}  // namespace engine
@@ -0,0 +1,59 @@
+#include "dataset_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace engine {
+
+MappedDataset::MappedDataset(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("dataset: cannot open " + path);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    throw std::runtime_error("dataset: cannot stat " + path);
+  }
+  length_ = static_cast<size_t>(st.st_size);
+
+  void* p = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::runtime_error("dataset: cannot map " + path);
+  data_ = static_cast<const uint8_t*>(p);
+  ::madvise(p, length_, MADV_SEQUENTIAL);
+
+  try {
+    wire::ByteReader in(data_, length_);
+    wire::read_header(in, kDatasetMagic);
+    truck_.w = in.get<double>();
+    truck_.h = in.get<double>();
+    truck_.d = in.get<double>();
+    truck_.max_weight = in.get<double>();
+    columns_ = wire::read_column_block(in);
+  } catch (...) {
+    ::munmap(const_cast<uint8_t*>(data_), length_);
+    throw;
+  }
+}
+
+MappedDataset::~MappedDataset() {
+  if (data_) ::munmap(const_cast<uint8_t*>(data_), length_);
+}
+
+std::vector<uint8_t> encode_dataset(const Truck& truck, const std::vector<Box>& boxes) {
+  wire::ByteWriter out;
+  wire::write_header(out, kDatasetMagic);
+  out.put<double>(truck.w);
+  out.put<double>(truck.h);
+  out.put<double>(truck.d);
+  out.put<double>(truck.max_weight);
+  wire::write_box_columns(out, boxes);
+  return std::move(out.buffer());
+}
+
+}  // namespace engine
@@ -0,0 +1,70 @@
+#include "dataset_registry.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace engine {
+
+std::shared_ptr<const PreparedInstance> DatasetRegistry::put(const std::string& id, PreparedInstance instance) {
+  const size_t bytes = instance.memory_bytes();
+  auto shared = std::make_shared<const PreparedInstance>(std::move(instance));
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (bytes > capacity_bytes_) {
+    throw std::length_error("dataset exceeds registry capacity");
+  }
+
+  const auto it = entries_.find(id);
+  if (it != entries_.end()) {
+    bytes_ -= it->second.bytes;
+    lru_.erase(it->second.lru_pos);
+    entries_.erase(it);
+  }
+
+  evict_to(capacity_bytes_ - bytes);
+  lru_.push_front(id);
+  entries_.emplace(id, Entry{shared, bytes, lru_.begin()});
+  bytes_ += bytes;
+  return shared;
+}
+
+std::shared_ptr<const PreparedInstance> DatasetRegistry::get(const std::string& id) {
+  std::lock_guard<std::mutex> lock(mu_);
+  const auto it = entries_.find(id);
+  if (it == entries_.end()) return nullptr;
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+  return it->second.instance;
+}
+
+bool DatasetRegistry::erase(const std::string& id) {
+  std::lock_guard<std::mutex> lock(mu_);
+  const auto it = entries_.find(id);
+  if (it == entries_.end()) return false;
+  bytes_ -= it->second.bytes;
+  lru_.erase(it->second.lru_pos);
+  entries_.erase(it);
+  return true;
+}
+
+void DatasetRegistry::set_capacity(size_t capacity_bytes) {
+  std::lock_guard<std::mutex> lock(mu_);
+  capacity_bytes_ = capacity_bytes;
+  evict_to(capacity_bytes_);
+}
+
+DatasetRegistry::Stats DatasetRegistry::stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return Stats{entries_.size(), bytes_, capacity_bytes_, evictions_};
+}
+
+void DatasetRegistry::evict_to(size_t limit) {
+  while (bytes_ > limit && !lru_.empty()) {
+    const auto it = entries_.find(lru_.back());
+    bytes_ -= it->second.bytes;
+    entries_.erase(it);
+    lru_.pop_back();
+    ++evictions_;
+  }
+}
+
+}  // namespace engine
@@ -0,0 +1,444 @@
+#include "decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "drop_index.h"
+#include "packing_common.h"
+
+namespace engine {
+
+namespace {
+
+using namespace packing;
+
+constexpr size_t kMaxCandidates = 350;
+
+// Lengths the decoder works in: metres as given, or integer units of a FixedGeometry.
+struct RealLengths {
+  using Coord = double;
+
+  explicit RealLengths(const PreparedInstance& inst) : inst_(inst) {}
+
+  std::array<double, 3> truck() const { return {inst_.truck.w, inst_.truck.h, inst_.truck.d}; }
+  const std::array<double, 3>& dims(size_t idx, uint8_t ri) const { return inst_.orientations[idx].dims[ri]; }
+  double from_metres(double v) const { return v; }
+  double to_metres(double v) const { return v; }
+
+  // quantize for de-dup
+  static long long key(double v) { return static_cast<long long>(std::llround(v * 100000.0)); }
+
+  const PreparedInstance& inst_;
+};
+
+struct FixedLengths {
+  using Coord = int32_t;
+
+  explicit FixedLengths(const FixedGeometry& geometry) : geometry_(geometry) {}
+
+  const std::array<int32_t, 3>& truck() const { return geometry_.truck; }
+  const std::array<int32_t, 3>& dims(size_t idx, uint8_t ri) const { return geometry_.dims[idx][ri]; }
+  // Rounded up like the box sides, so a run is long enough exactly when the box fits.
+  int32_t from_metres(double v) const {
+    return std::isfinite(v) ? fixed_units_up(v, geometry_.unit) : std::numeric_limits<int32_t>::max();
+  }
+  double to_metres(int32_t v) const { return v * geometry_.unit; }
+
+  static long long key(int32_t v) { return v; }
+
+  const FixedGeometry& geometry_;
+};
+
+template <typename Lengths, typename Physics>
+class ExtremePointDecoder final : public Decoder {
+  using T = typename Lengths::Coord;
+  using Box3 = BasicAABB<T>;
+
+ public:
+  ExtremePointDecoder(const PreparedInstance& inst, Lengths lengths, const PhysicsModel& physics)
+      : inst_(inst), lengths_(lengths), physics_(physics), balance_(inst) {
+    if (!inst_.stop_of.empty()) drops_.emplace();
+    reset();
+  }
+
+  void reset() override {
+    result_ = Result{};
+    result_.used_volume = 0;
+    result_.total_volume = inst_.total_volume;
+    result_.utilization = 0;
+    result_.total_weight = 0;
+    remaining_weight_ = inst_.truck.max_weight;
+    moments_ = LoadMoments{};
+    placed_.clear();
+    placed_.reserve(inst_.boxes.size());
+    placed_.set_floor(lengths_.truck()[0], lengths_.truck()[2]);
+    candidates_.clear();
+    candidates_.reserve(inst_.boxes.size() * 3 + 8);
+    add_candidate(0, 0, 0);
+    remaining_.reset(inst_);
+    if (drops_) drops_->set_depth(lengths_.truck()[2]);
+  }
+
+  bool place(size_t idx) override {
+    const auto& box = inst_.boxes[idx];
+    remaining_.take(box);
+
+    // No point is left that any box fits: the rest of the order is unplaced outright.
+    if (box.weight > remaining_weight_ + 1e-9 || candidates_.empty()) {
+      result_.unplaced.push_back(box.id);
+      return false;
+    }
+
+    const OrientationSet& rots = inst_.orientations[idx];
+    const double min_support = min_support_of(inst_, physics_, idx);
+    const T box_side = lengths_.from_metres(std::min({box.w, box.h, box.d}));
+    const auto limit = lengths_.truck();
+    const T eps = static_cast<T>(kEps);
+
+    bool found = false;
+    Box3 best{};
+    uint8_t best_ri = 0;
+    AppliedLoads best_loads;
+
+    // Score: prefer lower Y (gravity), then lower Z, then lower X.
+    auto better = [&](const Box3& a, const Box3& b) {
+      if (a.y != b.y) return a.y < b.y;
+      if (a.z != b.z) return a.z < b.z;
+      return a.x < b.x;
+    };
+
+    unique_candidates();
+
+    for (const auto& cand : candidates_) {
+      if (cand.shortest_run() + eps < box_side) continue;
+      for (uint8_t ri = 0; ri < rots.count; ++ri) {
+        const auto& r = lengths_.dims(idx, ri);
+        if (r[0] > cand.rx + eps || r[1] > cand.ry + eps || r[2] > cand.rz + eps) continue;
+        Box3 candidate{cand.x, cand.y, cand.z, r[0], r[1], r[2]};
+
+        if (!inside(limit, candidate)) continue;
+        const auto& real = rots.dims[ri];
+        if (!balance_.allows(moments_, box.weight, lengths_.to_metres(cand.x) + real[0] / 2,
+                             lengths_.to_metres(cand.z) + real[2] / 2)) {
+          continue;
+        }
+        if (!reachable(candidate, idx)) continue;
+        if (collides(candidate)) continue;
+
+        AppliedLoads applied;
+        if (!support_ok_and_apply_load(candidate, box.weight, placed_, &applied, min_support)) {
+          rollback_loads(placed_, applied);
+          continue;
+        }
+
+        if (!found || better(candidate, best)) {
+          if (found) {
+            rollback_loads(placed_, best_loads);
+          }
+          found = true;
+          best = candidate;
+          best_ri = ri;
+          best_loads = std::move(applied);
+        } else {
+          rollback_loads(placed_, applied);
+        }
+      }
+    }
+
+    if (!found) {
+      result_.unplaced.push_back(box.id);
+      drop_dead_candidates();
+      return false;
+    }
+    // best_loads already applied in placed states.
+    commit(best, best_ri, idx);
+    return true;
+  }
+
+  bool place_at(size_t idx, const Placement& at) override {
+    const auto& box = inst_.boxes[idx];
+    const uint8_t ri = orientation_of(inst_.orientations[idx], at);
+    if (ri == kNoOrientation || box.weight > remaining_weight_ + 1e-9) return false;
+    const auto& r = lengths_.dims(idx, ri);
+    const Box3 b{lengths_.from_metres(at.x), lengths_.from_metres(at.y), lengths_.from_metres(at.z), r[0], r[1], r[2]};
+    if (!inside(lengths_.truck(), shrunk(b)) || !balance_.allows(moments_, box.weight, at.x + at.w / 2, at.z + at.d / 2) ||
+        !reachable(b, idx) || collides(shrunk(b))) {
+      return false;
+    }
+    if (!support_ok_and_apply_load(b, box.weight, placed_, nullptr, min_support_of(inst_, physics_, idx))) return false;
+    remaining_.take(box);
+    commit(b, ri, idx);
+    return true;
+  }
+
+  const Result& result() const override { return result_; }
+  SupportGraph supports() const override {
+    if constexpr (!Physics::kSupport) return {};
+    return {&placed_.first_support, &placed_.supporters};
+  }
+  std::unique_ptr<Decoder> clone() const override { return std::make_unique<ExtremePointDecoder>(*this); }
+
+ private:
+  // Records box idx at b, whose loads are already applied, and opens the points around it.
+  void commit(const Box3& best, uint8_t best_ri, size_t idx) {
+    const Truck& truck = inst_.truck;
+    const auto& box = inst_.boxes[idx];
+    // Physics and the reported plan use the real sides; only positions come from T.
+    const auto& real = inst_.orientations[idx].dims[best_ri];
+
+    placed_.add(best, max_load_of(inst_, physics_, idx, real[0] * real[2]));
+    if (drops_) drops_->add(best.x, best.y, best.z, best.w, best.h, best.d, inst_.stop_of[idx]);
+
+    result_.placed.push_back(Placement{box.id, lengths_.to_metres(best.x), lengths_.to_metres(best.y),
+                                       lengths_.to_metres(best.z), real[0], real[1], real[2]});
+    const Placement& p = result_.placed.back();
+    result_.used_volume += volume(real[0], real[1], real[2]);
+    result_.total_weight += box.weight;
+    remaining_weight_ -= box.weight;
+    moments_.add(box.weight, p.x + p.w / 2, p.y + p.h / 2, p.z + p.d / 2);
+    report_balance(truck, moments_, &result_);
+    const double truck_volume = truck.w * truck.h * truck.d;
+    result_.utilization = truck_volume > 0 ? (result_.used_volume / truck_volume) : 0;
+
+    shorten_runs(best);
+
+    // Add new candidate points around placed box (extreme points).
+    add_candidate(best.x + best.w, best.y, best.z);
+    add_candidate(best.x, best.y, best.z + best.d);
+    add_candidate(best.x, best.y + best.h, best.z);
+    drop_dead_candidates();
+  }
+
+  bool collides(const Box3& b) const { return any_intersects(placed_.geometry, b); }
+
+  bool reachable(const Box3& b, size_t idx) const {
+    return !drops_ || drops_->allows(b.x, b.y, b.z, b.w, b.h, b.d, inst_.stop_of[idx]);
+  }
+
+  static bool inside(const std::array<T, 3>& t, const Box3& b) {
+    return b.x >= 0 && b.y >= 0 && b.z >= 0 && (b.x + b.w) <= t[0] && (b.y + b.h) <= t[1] && (b.z + b.d) <= t[2];
+  }
+
+  void add_candidate(T x, T y, T z) {
+    const T eps = static_cast<T>(kEps);
+    if (x < -eps || y < -eps || z < -eps) return;
+    const auto t = lengths_.truck();
+    Candidate<T> c{x, y, z, t[0] - x, t[1] - y, t[2] - z};
+    const PlacedGeometry<T>& g = placed_.geometry;
+    for (size_t i = 0; i < g.size(); ++i) {
+      if (!clip_runs(c, g.x0[i], g.x1[i], g.y0[i], g.y1[i], g.z0[i], g.z1[i])) return;
+    }
+    candidates_.push_back(c);
+  }
+
+  void shorten_runs(const Box3& b) {
+    const T x1 = b.x + b.w;
+    const T y1 = b.y + b.h;
+    const T z1 = b.z + b.d;
+    candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(),
+                                     [&](Candidate<T>& c) { return !clip_runs(c, b.x, x1, b.y, y1, b.z, z1); }),
+                      candidates_.end());
+  }
+
+  // Runs only shrink and the smallest remaining box only grows, so a point too tight for
+  // every remaining box stays useless.
+  void drop_dead_candidates() {
+    const T need = lengths_.from_metres(remaining_.smallest());
+    const T eps = static_cast<T>(kEps);
+    candidates_.erase(std::remove_if(candidates_.begin(), candidates_.end(),
+                                     [&](const Candidate<T>& c) { return c.shortest_run() + eps < need; }),
+                      candidates_.end());
+  }
+
+  void unique_candidates() {
+    auto key = [](const Candidate<T>& c) {
+      return std::tuple<long long, long long, long long>(Lengths::key(c.x), Lengths::key(c.y), Lengths::key(c.z));
+    };
+    std::sort(candidates_.begin(), candidates_.end(), [&](const Candidate<T>& a, const Candidate<T>& b) { return key(a) < key(b); });
+    candidates_.erase(std::unique(candidates_.begin(), candidates_.end(),
+                                  [&](const Candidate<T>& a, const Candidate<T>& b) { return key(a) == key(b); }),
+                      candidates_.end());
+
+    if (candidates_.size() > kMaxCandidates) {
+      std::stable_sort(candidates_.begin(), candidates_.end(), [](const Candidate<T>& a, const Candidate<T>& b) {
+        if (a.y != b.y) return a.y < b.y;
+        if (a.z != b.z) return a.z < b.z;
+        return a.x < b.x;
+      });
+      candidates_.resize(kMaxCandidates);
+    }
+  }
+
+  const PreparedInstance& inst_;
+  Lengths lengths_;
+  const PhysicsModel physics_;
+  Result result_;
+  double remaining_weight_ = 0;
+  const BalanceLimits balance_;
+  LoadMoments moments_;
+  PlacedBoxes<T, Physics> placed_;
+  std::vector<Candidate<T>> candidates_;
+  RemainingSides remaining_;
+  std::optional<DropIndex<T>> drops_;
+};
+
+}  // namespace
+
+std::unique_ptr<Decoder> make_extreme_point_decoder(const PreparedInstance& instance, const PhysicsModel& physics) {
+  return with_physics(physics.mode, [&](auto policy) -> std::unique_ptr<Decoder> {
+    using Impl = ExtremePointDecoder<RealLengths, decltype(policy)>;
+    return std::make_unique<Impl>(instance, RealLengths(instance), physics);
+  });
+}
+
+int32_t fixed_units_up(double v, double unit) {
+  return static_cast<int32_t>(std::ceil(v / unit - kFixedSlack));
+}
+
+FixedGeometry make_fixed_geometry(const PreparedInstance& instance, double unit) {
+  const Truck& t = instance.truck;
+  if (!(unit > 0) || std::max({t.w, t.h, t.d}) / unit >= kMaxFixedUnits) {
+    throw std::invalid_argument("fixed_unit must be positive and leave the truck under 2^30 units");
+  }
+  // The truck rounds down and box sides round up, so an integer plan fits in metres too.
+  auto down = [&](double v) { return static_cast<int32_t>(std::floor(v / unit + kFixedSlack)); };
+
+  FixedGeometry g;
+  g.unit = unit;
+  g.truck = {down(t.w), down(t.h), down(t.d)};
+  g.dims.resize(instance.orientations.size());
+  for (size_t i = 0; i < instance.orientations.size(); ++i) {
+    const OrientationSet& rots = instance.orientations[i];
+    for (uint8_t ri = 0; ri < rots.count; ++ri) {
+      for (int k = 0; k < 3; ++k) {
+        g.dims[i][ri][k] = fixed_units_up(rots.dims[ri][k], unit);
+      }
+    }
+  }
+  return g;
+}
+
+std::unique_ptr<Decoder> make_fixed_point_decoder(const PreparedInstance& instance, const FixedGeometry& geometry,
+                                                  const PhysicsModel& physics) {
+  return with_physics(physics.mode, [&](auto policy) -> std::unique_ptr<Decoder> {
+    using Impl = ExtremePointDecoder<FixedLengths, decltype(policy)>;
+    return std::make_unique<Impl>(instance, FixedLengths(geometry), physics);
+  });
+}
+
+std::unique_ptr<Decoder> make_decoder(const PreparedInstance& instance, DecoderKind kind, const PhysicsModel& physics) {
+  switch (kind) {
+    case DecoderKind::kWallBuilding:
+      return make_wall_decoder(instance, physics);
+    case DecoderKind::kEmptySpaces:
+      return make_empty_space_decoder(instance, physics);
+    case DecoderKind::kExtremePoints:
+      break;
+  }
+  return make_extreme_point_decoder(instance, physics);
+}
+
+void settle_lateral_offset(const PreparedInstance& instance, const SupportGraph& supports, Result* plan) {
+  const Truck& t = instance.truck;
+  if (!(t.max_lateral_offset > 0) || plan->placed.empty()) return;
+  if (std::fabs(plan->cog_x - t.w / 2) <= t.max_lateral_offset + kEps) return;
+
+  std::unordered_map<std::string, size_t> index;
+  index.reserve(instance.boxes.size());
+  for (size_t i = 0; i < instance.boxes.size(); ++i) index.emplace(instance.boxes[i].id, i);
+
+  const size_t n = plan->placed.size();
+  std::vector<double> weight(n);
+  LoadMoments m;
+  for (size_t i = 0; i < n; ++i) {
+    const Placement& p = plan->placed[i];
+    weight[i] = instance.boxes[index.at(p.id)].weight;
+    m.add(weight[i], p.x + p.w / 2, p.y + p.h / 2, p.z + p.d / 2);
+  }
+  // Only boxes nothing rests on may go, so every box left keeps its support. Without a
+  // graph support is no rule and any box may go.
+  std::vector<uint32_t> resting(n, 0);
+  const bool graph = supports.first && supports.first->size() == n + 1;
+  if (graph) {
+    for (uint32_t s : *supports.on) ++resting[s];
+  }
+
+  // An axle limit already exceeded stays a fault of the plan; a removal may not add one.
+  const bool axles = has_axles(t) && (t.front_axle_max > 0 || t.rear_axle_max > 0);
+  auto axles_over = [&](double w, double moment_z) {
+    if (!axles) return 0;
+    const double rear = rear_axle_load(t, w, moment_z);
+    return (t.rear_axle_max > 0 && rear > t.rear_axle_max + kEps ? 1 : 0) |
+           (t.front_axle_max > 0 && w - rear > t.front_axle_max + kEps ? 2 : 0);
+  };
+  auto lateral_excess = [&](double w, double moment_x) {
+    return std::fabs(moment_x - w * t.w / 2) - t.max_lateral_offset * w;
+  };
+  const int over_before = axles_over(m.weight, m.z);
+
+  std::vector<char> gone(n, 0);
+  while (lateral_excess(m.weight, m.x) > kEps) {
+    // The most balanced result, then the smaller box, among removals that keep the axles
+    // within limits. When none does the lateral limit stays unmet.
+    size_t best = n;
+    std::pair<double, double> best_key{};
+    for (size_t i = 0; i < n; ++i) {
+      if (gone[i] || resting[i] > 0) continue;
+      const Placement& p = plan->placed[i];
+      const double w = m.weight - weight[i];
+      if (axles_over(w, m.z - weight[i] * (p.z + p.d / 2)) & ~over_before) continue;
+      const std::pair<double, double> key{std::max(0.0, lateral_excess(w, m.x - weight[i] * (p.x + p.w / 2))),
+                                          p.w * p.h * p.d};
+      if (best == n || key < best_key) {
+        best = i;
+        best_key = key;
+      }
+    }
+    if (best == n) break;
+    const Placement& p = plan->placed[best];
+    gone[best] = 1;
+    m.add(-weight[best], p.x + p.w / 2, p.y + p.h / 2, p.z + p.d / 2);
+    if (graph) {
+      const std::vector<uint32_t>& first = *supports.first;
+      for (uint32_t k = first[best]; k < first[best + 1]; ++k) --resting[(*supports.on)[k]];
+    }
+  }
+
+  std::vector<Placement> kept;
+  kept.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const Placement& p = plan->placed[i];
+    if (!gone[i]) {
+      kept.push_back(p);
+      continue;
+    }
+    plan->unplaced.push_back(p.id);
+    plan->used_volume -= p.w * p.h * p.d;
+    plan->total_weight -= weight[i];
+  }
+  plan->placed = std::move(kept);
+  const double truck_volume = t.w * t.h * t.d;
+  plan->utilization = truck_volume > 0 ? plan->used_volume / truck_volume : 0;
+  report_balance(t, m, plan);
+}
+
+Result decode_order(const PreparedInstance& instance, DecoderKind kind, const std::vector<size_t>& order,
+                    const PhysicsModel& physics) {
+  auto decoder = make_decoder(instance, kind, physics);
+  for (size_t idx : order) decoder->place(idx);
+  Result r = decoder->result();
+  settle_lateral_offset(instance, decoder->supports(), &r);
+  return r;
+}
+
+}  // namespace engine
@@ -0,0 +1,307 @@
+#include "decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <optional>
+
+#include "drop_index.h"
+#include "packing_common.h"
+
+namespace engine {
+
+namespace {
+
+using namespace packing;
+
+// Empty maximal spaces: free volume is kept as the set of largest empty cuboids, which
+// may overlap each other. A box goes inside a space that holds it, so it cannot collide
+// with anything: at the space's near-bottom-left corner, or, above the floor where that
+// corner often hangs in the air, flush with a corner of a box whose top is the space's
+// floor. Placing it splits every space it cuts
+// into at most six, and new spaces inside another space, or too thin for every box still
+// to come, are dropped. Spaces are indexed
+// by their shortest side; a box fits only spaces whose sides, sorted, all cover its own
+// sorted sides, so queries start at the box's shortest side.
+struct Space {
+  AABB box;
+  std::array<double, 3> sides;  // ascending
+  std::multimap<double, size_t>::iterator slot;
+  bool alive;
+};
+
+std::array<double, 3> sorted_sides(const AABB& b) {
+  std::array<double, 3> s{b.w, b.h, b.d};
+  std::sort(s.begin(), s.end());
+  return s;
+}
+
+bool contains(const AABB& outer, const AABB& inner) {
+  return inner.x >= outer.x - kEps && inner.y >= outer.y - kEps && inner.z >= outer.z - kEps &&
+         inner.x + inner.w <= outer.x + outer.w + kEps && inner.y + inner.h <= outer.y + outer.h + kEps &&
+         inner.z + inner.d <= outer.z + outer.d + kEps;
+}
+
+template <typename Physics>
+class EmptySpaceDecoder final : public Decoder {
+ public:
+  EmptySpaceDecoder(const PreparedInstance& inst, const PhysicsModel& physics)
+      : inst_(inst), physics_(physics), balance_(inst) {
+    if (!inst_.stop_of.empty()) drops_.emplace();
+    reset();
+  }
+
+  // Every Space::slot points into by_side_, so the copy rebuilds its own index, in the
+  // source's order so equal sides are still scanned alike.
+  EmptySpaceDecoder(const EmptySpaceDecoder& other)
+      : inst_(other.inst_),
+        physics_(other.physics_),
+        result_(other.result_),
+        remaining_weight_(other.remaining_weight_),
+        balance_(other.balance_),
+        moments_(other.moments_),
+        drops_(other.drops_),
+        placed_(other.placed_),
+        spaces_(other.spaces_),
+        free_(other.free_),
+        remaining_(other.remaining_) {
+    for (const auto& [side, id] : other.by_side_) spaces_[id].slot = by_side_.emplace_hint(by_side_.end(), side, id);
+  }
+  EmptySpaceDecoder& operator=(const EmptySpaceDecoder&) = delete;
+
+  void reset() override {
+    result_ = Result{};
+    result_.used_volume = 0;
+    result_.total_volume = inst_.total_volume;
+    result_.utilization = 0;
+    result_.total_weight = 0;
+    remaining_weight_ = inst_.truck.max_weight;
+    moments_ = LoadMoments{};
+    placed_.clear();
+    placed_.reserve(inst_.boxes.size());
+    placed_.set_floor(inst_.truck.w, inst_.truck.d);
+    spaces_.clear();
+    free_.clear();
+    by_side_.clear();
+    remaining_.reset(inst_);
+    const Truck& t = inst_.truck;
+    add_space(AABB{0, 0, 0, t.w, t.h, t.d});
+    if (drops_) drops_->set_depth(t.d);
+  }
+
+  bool place(size_t idx) override {
+    const auto& box = inst_.boxes[idx];
+    remaining_.take(box);
+
+    if (box.weight > remaining_weight_ + 1e-9 || by_side_.empty()) {
+      result_.unplaced.push_back(box.id);
+      return false;
+    }
+
+    const OrientationSet& rots = inst_.orientations[idx];
+    const double min_support = min_support_of(inst_, physics_, idx);
+    std::array<double, 3> need{box.w, box.h, box.d};
+    std::sort(need.begin(), need.end());
+
+    // Deepest-bottom-left: lower Z, then lower Y, then lower X.
+    auto better = [](const AABB& a, const AABB& b) {
+      if (a.z != b.z) return a.z < b.z;
+      if (a.y != b.y) return a.y < b.y;
+      return a.x < b.x;
+    };
+
+    // Every fit is collision-free, so rank the fits first and run the support and crush
+    // checks only until one passes.
+    fits_.clear();
+    for (auto it = by_side_.lower_bound(need[0] - kEps); it != by_side_.end(); ++it) {
+      const Space& s = spaces_[it->second];
+      if (s.sides[1] + kEps < need[1] || s.sides[2] + kEps < need[2]) continue;
+      // The boxes the space's floor rests on, when it is not the truck's.
+      size_t supporters = 0;
+      if constexpr (Physics::kSupport) {
+        if (s.box.y > kEps) supporters = support_contacts(AABB{s.box.x, s.box.y, s.box.z, s.box.w, 0, s.box.d}, placed_);
+      }
+      for (uint8_t ri = 0; ri < rots.count; ++ri) {
+        const auto& r = rots.dims[ri];
+        if (r[0] > s.box.w + kEps || r[1] > s.box.h + kEps || r[2] > s.box.d + kEps) continue;
+        fits_.push_back(AABB{s.box.x, s.box.y, s.box.z, r[0], r[1], r[2]});
+        const double x_max = s.box.x + s.box.w - r[0], z_max = s.box.z + s.box.d - r[2];
+        for (size_t h = 0; h < supporters; ++h) {
+          const uint32_t i = placed_.hits[h];
+          const auto& g = placed_.geometry;
+          for (const double x : {g.x0[i], g.x1[i] - r[0]}) {
+            for (const double z : {g.z0[i], g.z1[i] - r[2]}) {
+              const AABB c{std::clamp(x, s.box.x, std::max(s.box.x, x_max)), s.box.y,
+                           std::clamp(z, s.box.z, std::max(s.box.z, z_max)), r[0], r[1], r[2]};
+              if (c.x != s.box.x || c.z != s.box.z) fits_.push_back(c);
+            }
+          }
+        }
+      }
+    }
+    std::stable_sort(fits_.begin(), fits_.end(), better);
+
+    bool found = false;
+    AABB best{};
+    for (const auto& candidate : fits_) {
+      if (!balance_.allows(moments_, box.weight, candidate.x + candidate.w / 2, candidate.z + candidate.d / 2)) continue;
+      if (drops_ && !drops_->allows(candidate.x, candidate.y, candidate.z, candidate.w, candidate.h, candidate.d,
+                                    inst_.stop_of[idx])) {
+        continue;
+      }
+      if (support_ok_and_apply_load(candidate, box.weight, placed_, nullptr, min_support)) {
+        found = true;
+        best = candidate;
+        break;
+      }
+    }
+
+    if (!found) {
+      result_.unplaced.push_back(box.id);
+      drop_dead_spaces();
+      return false;
+    }
+
+    commit(best, idx);
+    return true;
+  }
+
+  bool place_at(size_t idx, const Placement& at) override {
+    const auto& box = inst_.boxes[idx];
+    if (orientation_of(inst_.orientations[idx], at) == kNoOrientation || box.weight > remaining_weight_ + 1e-9) {
+      return false;
+    }
+    const AABB b{at.x, at.y, at.z, at.w, at.h, at.d};
+    if (!inside_truck(inst_.truck, shrunk(b)) || !balance_.allows(moments_, box.weight, b.x + b.w / 2, b.z + b.d / 2)) return false;
+    if (drops_ && !drops_->allows(b.x, b.y, b.z, b.w, b.h, b.d, inst_.stop_of[idx])) return false;
+    // Spaces only say where boxes fit whole; anywhere else the placed boxes decide.
+    if (any_intersects(placed_.geometry, shrunk(b))) return false;
+    if (!support_ok_and_apply_load(b, box.weight, placed_, nullptr, min_support_of(inst_, physics_, idx))) return false;
+    remaining_.take(box);
+    commit(b, idx);
+    return true;
+  }
+
+  const Result& result() const override { return result_; }
+  SupportGraph supports() const override {
+    if constexpr (!Physics::kSupport) return {};
+    return {&placed_.first_support, &placed_.supporters};
+  }
+  std::unique_ptr<Decoder> clone() const override { return std::make_unique<EmptySpaceDecoder>(*this); }
+
+ private:
+  // Records box idx at best, whose loads are already applied, and carves the spaces it cuts.
+  void commit(const AABB& best, size_t idx) {
+    const auto& box = inst_.boxes[idx];
+    placed_.add(best, max_load_of(inst_, physics_, idx, best.w * best.d));
+    if (drops_) drops_->add(best.x, best.y, best.z, best.w, best.h, best.d, inst_.stop_of[idx]);
+
+    result_.placed.push_back(Placement{box.id, best.x, best.y, best.z, best.w, best.h, best.d});
+    result_.used_volume += volume(best.w, best.h, best.d);
+    result_.total_weight += box.weight;
+    remaining_weight_ -= box.weight;
+    moments_.add(box.weight, best.x + best.w / 2, best.y + best.h / 2, best.z + best.d / 2);
+    const Truck& truck = inst_.truck;
+    report_balance(truck, moments_, &result_);
+    const double truck_volume = truck.w * truck.h * truck.d;
+    result_.utilization = truck_volume > 0 ? (result_.used_volume / truck_volume) : 0;
+
+    carve(best);
+    drop_dead_spaces();
+  }
+
+  void add_space(const AABB& b) {
+    size_t id;
+    if (!free_.empty()) {
+      id = free_.back();
+      free_.pop_back();
+    } else {
+      id = spaces_.size();
+      spaces_.emplace_back();
+    }
+    Space& s = spaces_[id];
+    s.box = b;
+    s.sides = sorted_sides(b);
+    s.slot = by_side_.emplace(s.sides[0], id);
+    s.alive = true;
+  }
+
+  void remove_space(size_t id) {
+    Space& s = spaces_[id];
+    by_side_.erase(s.slot);
+    s.alive = false;
+    free_.push_back(id);
+  }
+
+  // Splits every space the placed box cuts into the (up to six) slabs around it.
+  void carve(const AABB& b) {
+    fresh_.clear();
+    for (size_t id = 0; id < spaces_.size(); ++id) {
+      if (!spaces_[id].alive || !intersects(spaces_[id].box, b)) continue;
+      const AABB s = spaces_[id].box;
+      remove_space(id);
+      const double sx1 = s.x + s.w, sy1 = s.y + s.h, sz1 = s.z + s.d;
+      const double bx1 = b.x + b.w, by1 = b.y + b.h, bz1 = b.z + b.d;
+      keep_if_usable(AABB{s.x, s.y, s.z, b.x - s.x, s.h, s.d});
+      keep_if_usable(AABB{bx1, s.y, s.z, sx1 - bx1, s.h, s.d});
+      keep_if_usable(AABB{s.x, s.y, s.z, s.w, b.y - s.y, s.d});
+      keep_if_usable(AABB{s.x, by1, s.z, s.w, sy1 - by1, s.d});
+      keep_if_usable(AABB{s.x, s.y, s.z, s.w, s.h, b.z - s.z});
+      keep_if_usable(AABB{s.x, s.y, bz1, s.w, s.h, sz1 - bz1});
+    }
+
+    // Only new spaces can be redundant: they are pieces of maximal spaces, so none of
+    // them contains a space that survived.
+    for (size_t i = 0; i < fresh_.size(); ++i) {
+      const AABB& f = fresh_[i];
+      bool redundant = false;
+      for (size_t j = 0; j < fresh_.size() && !redundant; ++j) {
+        if (j == i || !contains(fresh_[j], f)) continue;
+        // Equal pieces: keep the first.
+        redundant = !contains(f, fresh_[j]) || j < i;
+      }
+      const double shortest = std::min({f.w, f.h, f.d});
+      for (auto it = by_side_.lower_bound(shortest - kEps); it != by_side_.end() && !redundant; ++it) {
+        redundant = contains(spaces_[it->second].box, f);
+      }
+      if (!redundant) add_space(f);
+    }
+  }
+
+  void keep_if_usable(const AABB& s) {
+    if (std::min({s.w, s.h, s.d}) + kEps < remaining_.smallest()) return;
+    fresh_.push_back(s);
+  }
+
+  // Spaces only shrink and the smallest remaining box only grows, so a space thinner than
+  // it is gone for good; the index hands those out first.
+  void drop_dead_spaces() {
+    const double need = remaining_.smallest();
+    while (!by_side_.empty() && by_side_.begin()->first + kEps < need) remove_space(by_side_.begin()->second);
+  }
+
+  const PreparedInstance& inst_;
+  const PhysicsModel physics_;
+  Result result_;
+  double remaining_weight_ = 0;
+  const BalanceLimits balance_;
+  LoadMoments moments_;
+  std::optional<DropIndex<double>> drops_;
+  PlacedBoxes<double, Physics> placed_;
+  std::vector<Space> spaces_;
+  std::vector<size_t> free_;
+  std::multimap<double, size_t> by_side_;
+  std::vector<AABB> fresh_;
+  std::vector<AABB> fits_;
+  RemainingSides remaining_;
+};
+
+}  // namespace
+
+std::unique_ptr<Decoder> make_empty_space_decoder(const PreparedInstance& instance, const PhysicsModel& physics) {
+  return with_physics(physics.mode, [&](auto policy) -> std::unique_ptr<Decoder> {
+    return std::make_unique<EmptySpaceDecoder<decltype(policy)>>(instance, physics);
+  });
+}
+
+}  // namespace engine
@@ -0,0 +1,182 @@
+#include "fleet.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "instance.h"
+
+namespace engine {
+
+namespace {
+
+constexpr double kFitEps = 1e-9;
+
+// Whether some axis-aligned rotation of the box fits the truck's extents.
+bool fits_extents(const Box& b, const Truck& t) {
+  std::array<double, 3> box{b.w, b.h, b.d};
+  std::array<double, 3> truck{t.w, t.h, t.d};
+  std::sort(box.begin(), box.end());
+  std::sort(truck.begin(), truck.end());
+  for (size_t i = 0; i < 3; ++i) {
+    if (box[i] > truck[i] + kFitEps) return false;
+  }
+  return true;
+}
+
+struct Slot {
+  size_t type = 0;
+  int index = 0;
+  double volume_cap = 0;
+  std::vector<size_t> boxes;
+  double volume = 0;
+  double weight = 0;
+  bool closed = false;
+  bool dirty = false;
+  Result result{};
+};
+
+}  // namespace
+
+FleetResult optimize_fleet(const std::vector<TruckType>& fleet,
+                           const std::vector<Box>& boxes,
+                           const FleetParams& params,
+                           WorkStealingPool* pool) {
+  FleetResult out;
+  const double fill = std::clamp(params.fill_target, 0.05, 1.0);
+
+  std::vector<double> volume(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) volume[i] = boxes[i].w * boxes[i].h * boxes[i].d;
+
+  // Larger trucks first, so a manifest needs as few trucks as possible.
+  std::vector<size_t> type_order(fleet.size());
+  for (size_t i = 0; i < type_order.size(); ++i) type_order[i] = i;
+  std::stable_sort(type_order.begin(), type_order.end(), [&](size_t a, size_t b) {
+    const Truck& ta = fleet[a].truck;
+    const Truck& tb = fleet[b].truck;
+    return ta.w * ta.h * ta.d > tb.w * tb.h * tb.d;
+  });
+  std::vector<int> available(fleet.size());
+  for (size_t i = 0; i < fleet.size(); ++i) available[i] = std::max(0, fleet[i].count);
+  std::vector<int> opened(fleet.size(), 0);
+
+  std::vector<size_t> pending(boxes.size());
+  for (size_t i = 0; i < pending.size(); ++i) pending[i] = i;
+  std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b) {
+    if (std::fabs(volume[a] - volume[b]) > 1e-12) return volume[a] > volume[b];
+    return boxes[a].priority > boxes[b].priority;
+  });
+
+  std::vector<Slot> slots;
+  std::vector<size_t> unplaced;
+
+  while (!pending.empty()) {
+    // Assignment: first open slot with room, else open the largest available type.
+    for (const size_t idx : pending) {
+      const Box& b = boxes[idx];
+      Slot* target = nullptr;
+      for (auto& s : slots) {
+        const Truck& t = fleet[s.type].truck;
+        if (s.closed || !fits_extents(b, t)) continue;
+        if (s.volume + volume[idx] > s.volume_cap || s.weight + b.weight > t.max_weight) continue;
+        target = &s;
+        break;
+      }
+      if (!target) {
+        for (const size_t ti : type_order) {
+          const Truck& t = fleet[ti].truck;
+          if (available[ti] == 0 || !fits_extents(b, t) || b.weight > t.max_weight) continue;
+          --available[ti];
+          Slot slot;
+          slot.type = ti;
+          slot.index = opened[ti]++;
+          slot.volume_cap = t.w * t.h * t.d * fill;
+          slots.push_back(std::move(slot));
+          target = &slots.back();
+          break;
+        }
+      }
+      if (!target) {
+        unplaced.push_back(idx);
+        continue;
+      }
+      target->boxes.push_back(idx);
+      target->volume += volume[idx];
+      target->weight += b.weight;
+      target->dirty = true;
+    }
+    pending.clear();
+
+    std::vector<size_t> dirty;
+    for (size_t s = 0; s < slots.size(); ++s) {
+      if (slots[s].dirty) dirty.push_back(s);
+    }
+    if (dirty.empty()) break;
+
+    // Trucks are independent, so they pack concurrently.
+    auto pack_slot = [&](size_t k) {
+      Slot& s = slots[dirty[k]];
+      std::vector<Box> assigned;
+      assigned.reserve(s.boxes.size());
+      for (const size_t idx : s.boxes) assigned.push_back(boxes[idx]);
+      GaParams ga = params.ga;
+      ga.seed = params.ga.seed + static_cast<uint32_t>(dirty[k]);
+      s.result = optimize_ga(prepare_instance(fleet[s.type].truck, std::move(assigned)), ga);
+    };
+    if (pool) {
+      pool->parallel_for(dirty.size(), pack_slot);
+    } else {
+      for (size_t k = 0; k < dirty.size(); ++k) pack_slot(k);
+    }
+
+    // Leftovers close their truck (it is as full as it gets) and go round again.
+    for (const size_t si : dirty) {
+      Slot& s = slots[si];
+      s.dirty = false;
+      if (s.result.unplaced.empty()) continue;
+      s.closed = true;
+
+      std::unordered_map<std::string, std::vector<size_t>> by_id;
+      for (const size_t idx : s.boxes) by_id[boxes[idx].id].push_back(idx);
+      std::unordered_set<size_t> left;
+      for (const auto& id : s.result.unplaced) {
+        auto& candidates = by_id[id];
+        if (candidates.empty()) continue;
+        left.insert(candidates.back());
+        candidates.pop_back();
+      }
+      std::vector<size_t> kept;
+      for (const size_t idx : s.boxes) {
+        if (left.count(idx)) {
+          pending.push_back(idx);
+        } else {
+          kept.push_back(idx);
+        }
+      }
+      s.boxes = std::move(kept);
+      s.result.unplaced.clear();
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&](size_t a, size_t b) { return volume[a] > volume[b]; });
+  }
+
+  for (auto& s : slots) {
+    if (s.boxes.empty()) continue;
+    const TruckType& type = fleet[s.type];
+    out.used_volume += s.result.used_volume;
+    out.capacity_volume += type.truck.w * type.truck.h * type.truck.d;
+    out.total_weight += s.result.total_weight;
+    out.trucks.push_back(TruckLoad{type.id, s.index, type.truck, std::move(s.result)});
+  }
+  out.trucks_used = static_cast<int>(out.trucks.size());
+  out.utilization = out.capacity_volume > 0 ? out.used_volume / out.capacity_volume : 0.0;
+
+  std::sort(unplaced.begin(), unplaced.end());
+  for (const size_t idx : unplaced) out.unplaced.push_back(boxes[idx].id);
+  return out;
+}
+
+}  // namespace engine
@@ -1,301 +1,49 @@
-#include "engine_types.h"
+#include "optimizer.h"
 
 #include <algorithm>
-#include <array>
+#include <chrono>
 #include <cmath>
+#include <ctime>
+#include <limits>
+#include <memory>
 #include <random>
-#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
+#include "blocks.h"
+#include "decoder.h"
+#include "slab.h"
+#include "warm_start.h"
+
 namespace engine {
 
 namespace {
 
-double volume(double w, double h, double d) { return w * h * d; }
-
-struct AABB {
-  double x;
-  double y;
-  double z;
-  double w;
-  double h;
-  double d;
-};
-
-struct Candidate {
-  double x;
-  double y;
-  double z;
-};
-
-struct PlacedState {
-  AABB box;
-  std::string id;
-  double weight;
-  double max_load;
-  double load_on_top;
-};
-
-constexpr double kEps = 1e-8;
-constexpr double kMinSupportRatio = 0.90;      // >= 90% of base area must be supported
-constexpr double kMaxStackMultiplier = 6.0;    // max load proportional to box weight
-constexpr double kMaxPressure = 2500.0;        // kg per m^2 (simple crush proxy)
-
-bool intersects(const AABB& a, const AABB& b) {
-  const bool sep_x = (a.x + a.w <= b.x) || (b.x + b.w <= a.x);
-  const bool sep_y = (a.y + a.h <= b.y) || (b.y + b.h <= a.y);
-  const bool sep_z = (a.z + a.d <= b.z) || (b.z + b.d <= a.z);
-  return !(sep_x || sep_y || sep_z);
-}
-
-bool inside_truck(const Truck& t, const AABB& b) {
-  return b.x >= 0 && b.y >= 0 && b.z >= 0 && (b.x + b.w) <= t.w && (b.y + b.h) <= t.h && (b.z + b.d) <= t.d;
-}
-
-double overlap_1d(double a0, double a1, double b0, double b1) {
-  const double lo = std::max(a0, b0);
-  const double hi = std::min(a1, b1);
-  return std::max(0.0, hi - lo);
-}
-
-double overlap_area_xz(const AABB& top, const AABB& bottom) {
-  const double ox = overlap_1d(top.x, top.x + top.w, bottom.x, bottom.x + bottom.w);
-  const double oz = overlap_1d(top.z, top.z + top.d, bottom.z, bottom.z + bottom.d);
-  return ox * oz;
-}
-
-bool point_in_overlap_xz(double px, double pz, const AABB& top, const AABB& bottom) {
-  const double x0 = std::max(top.x, bottom.x);
-  const double x1 = std::min(top.x + top.w, bottom.x + bottom.w);
-  const double z0 = std::max(top.z, bottom.z);
-  const double z1 = std::min(top.z + top.d, bottom.z + bottom.d);
-  return (px + kEps) >= x0 && (px - kEps) <= x1 && (pz + kEps) >= z0 && (pz - kEps) <= z1;
-}
-
-double max_load_for(double weight, double base_area) {
-  // Capacity is limited by BOTH a weight-proportional heuristic and a simple
-  // pressure proxy; use the stricter one.
-  const double by_weight = weight * kMaxStackMultiplier;
-  const double by_pressure = base_area * kMaxPressure;
-  return std::max(kEps, std::min(by_weight, by_pressure));
-}
-
-bool support_ok_and_apply_load(const AABB& candidate,
-                               double weight,
-                               std::vector<PlacedState>& placed,
-                               std::vector<std::pair<size_t, double>>* applied) {
-  if (candidate.y <= kEps) {
-    return true;
-  }
-
-  const double base_area = std::max(kEps, candidate.w * candidate.d);
-  const double cx = candidate.x + candidate.w / 2.0;
-  const double cz = candidate.z + candidate.d / 2.0;
-
-  double supported_area = 0.0;
-  bool centroid_supported = false;
-
-  std::vector<std::pair<size_t, double>> supports;
-
-  for (size_t i = 0; i < placed.size(); ++i) {
-    const auto& s = placed[i];
-    const double top_y = s.box.y + s.box.h;
-    if (std::fabs(top_y - candidate.y) > 1e-6) {
-      continue;
-    }
-    const double area = overlap_area_xz(candidate, s.box);
-    if (area <= kEps) {
-      continue;
-    }
-    supported_area += area;
-    supports.push_back({i, area});
-    if (!centroid_supported && point_in_overlap_xz(cx, cz, candidate, s.box)) {
-      centroid_supported = true;
-    }
-  }
-
-  if (!centroid_supported) {
-    return false;
-  }
-
-  if (supported_area + 1e-9 < kMinSupportRatio * base_area) {
-    return false;
-  }
-
-  // Check crush limits for each supporting box using area-weight share.
-  for (const auto& [idx, area] : supports) {
-    const double share = std::min(1.0, std::max(0.0, area / base_area));
-    const double added = weight * share;
-    if (placed[idx].load_on_top + added > placed[idx].max_load + 1e-9) {
-      return false;
-    }
-  }
-
-  // Apply loads.
-  for (const auto& [idx, area] : supports) {
-    const double share = std::min(1.0, std::max(0.0, area / base_area));
-    const double added = weight * share;
-    placed[idx].load_on_top += added;
-    if (applied) {
-      applied->push_back({idx, added});
-    }
-  }
-
-  return true;
-}
-
-void rollback_loads(std::vector<PlacedState>& placed, const std::vector<std::pair<size_t, double>>& applied) {
-  for (const auto& [idx, added] : applied) {
-    placed[idx].load_on_top -= added;
-  }
-}
-
-Result pack_by_order(const Truck& truck, const std::vector<Box>& boxes, const std::vector<size_t>& order) {
-  Result result;
-  result.used_volume = 0;
-  result.total_volume = 0;
-  result.total_weight = 0;
-  for (const auto& box : boxes) {
-    result.total_volume += volume(box.w, box.h, box.d);
-  }
-
-  std::vector<PlacedState> placed;
-  placed.reserve(order.size());
-
-  std::vector<Candidate> candidates;
-  candidates.reserve(order.size() * 3 + 8);
-  candidates.push_back(Candidate{0, 0, 0});
-
-  constexpr size_t kMaxCandidates = 350;
-
-  auto add_candidate = [&](double x, double y, double z) {
-    if (x < -kEps || y < -kEps || z < -kEps) return;
-    candidates.push_back(Candidate{x, y, z});
-  };
-
-  auto unique_candidates = [&]() {
-    auto key = [](const Candidate& c) {
-      // quantize for de-dup
-      const auto q = [](double v) { return static_cast<long long>(std::llround(v * 100000.0)); };
-      return std::tuple<long long, long long, long long>(q(c.x), q(c.y), q(c.z));
-    };
-    std::sort(candidates.begin(), candidates.end(), [&](const Candidate& a, const Candidate& b) { return key(a) < key(b); });
-    candidates.erase(std::unique(candidates.begin(), candidates.end(), [&](const Candidate& a, const Candidate& b) { return key(a) == key(b); }),
-                     candidates.end());
-
-    if (candidates.size() > kMaxCandidates) {
-      std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
-        if (a.y != b.y) return a.y < b.y;
-        if (a.z != b.z) return a.z < b.z;
-        return a.x < b.x;
-      });
-      candidates.resize(kMaxCandidates);
-    }
-  };
-
-  double remaining_weight = truck.max_weight;
-
-  auto collides_any = [&](const AABB& a) {
-    for (const auto& p : placed) {
-      if (intersects(a, p.box)) return true;
-    }
-    return false;
-  };
-
-  for (size_t idx : order) {
-    const auto& box = boxes[idx];
-
-    if (box.weight > remaining_weight + 1e-9) {
-      result.unplaced.push_back(box.id);
-      continue;
-    }
-
-    // 6 orientations
-    const std::array<std::array<double, 3>, 6> rots = {
-        std::array<double, 3>{box.w, box.h, box.d},
-        std::array<double, 3>{box.w, box.d, box.h},
-        std::array<double, 3>{box.h, box.w, box.d},
-        std::array<double, 3>{box.h, box.d, box.w},
-        std::array<double, 3>{box.d, box.w, box.h},
-        std::array<double, 3>{box.d, box.h, box.w},
-    };
-
-    bool found = false;
-    AABB best{};
-    std::vector<std::pair<size_t, double>> best_loads;
-
-    // Score: prefer lower Y (gravity), then lower Z, then lower X.
-    auto better = [&](const AABB& a, const AABB& b) {
-      if (a.y != b.y) return a.y < b.y;
-      if (a.z != b.z) return a.z < b.z;
-      return a.x < b.x;
-    };
-
-    unique_candidates();
-
-    for (const auto& cand : candidates) {
-      for (const auto& r : rots) {
-        AABB candidate{cand.x, cand.y, cand.z, r[0], r[1], r[2]};
-
-        if (!inside_truck(truck, candidate)) continue;
-        if (collides_any(candidate)) continue;
-
-        std::vector<std::pair<size_t, double>> applied;
-        if (!support_ok_and_apply_load(candidate, box.weight, placed, &applied)) {
-          rollback_loads(placed, applied);
-          continue;
-        }
-
-        if (!found || better(candidate, best)) {
-          if (found) {
-            rollback_loads(placed, best_loads);
-          }
-          found = true;
-          best = candidate;
-          best_loads = std::move(applied);
-        } else {
-          rollback_loads(placed, applied);
-        }
-      }
-    }
-
-    if (!found) {
-      result.unplaced.push_back(box.id);
-      continue;
-    }
-
-    // best_loads already applied in placed states.
-    placed.push_back(PlacedState{best, box.id, box.weight, max_load_for(box.weight, best.w * best.d), 0.0});
-
-    result.placed.push_back(Placement{box.id, best.x, best.y, best.z, best.w, best.h, best.d});
-    result.used_volume += volume(best.w, best.h, best.d);
-    result.total_weight += box.weight;
-    remaining_weight -= box.weight;
-
-    // Add new candidate points around placed box (extreme points).
-    add_candidate(best.x + best.w, best.y, best.z);
-    add_candidate(best.x, best.y, best.z + best.d);
-    add_candidate(best.x, best.y + best.h, best.z);
-  }
-
-  result.utilization = (truck.w * truck.h * truck.d) > 0 ? (result.used_volume / (truck.w * truck.h * truck.d)) : 0;
-  return result;
-}
-
 struct Individual {
   std::vector<size_t> order;
   double score;
   Result result;
 };
 
+// CPU time of the calling thread, so work on other pool threads is not counted.
+double thread_cpu_ms() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+}  // namespace
+
 double score_result(const Result& r) {
-  // Higher is better. Prefer utilization; penalize unplaced.
   return r.utilization * 100.0 - static_cast<double>(r.unplaced.size()) * 0.5;
 }
 
-}  // namespace
+Result optimize_ga(const PreparedInstance& inst, const GaParams& params) {
+  const std::vector<Box>& boxes = inst.boxes;
+  int population = params.population;
+  int generations = params.generations;
+  const double mutation_rate = params.mutation_rate;
 
-Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int population, int generations, double mutation_rate, uint32_t seed) {
   if (boxes.empty()) {
     Result r;
     r.used_volume = 0;
@@ -305,7 +53,89 @@ Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int popula
     return r;
   }
 
-  std::mt19937 rng(seed);
+  if (params.warm_start) {
+    GaParams run = params;
+    run.warm_start = nullptr;
+    std::vector<std::string> cached = params.warm_start->lookup(inst);
+    if (!cached.empty()) run.seed_orders.push_back(std::move(cached));
+    Result r = optimize_ga(inst, run);
+    params.warm_start->store(inst, r);
+    return r;
+  }
+
+  if (use_slabs(params, inst)) return optimize_slabs(inst, params);
+
+  if (params.blocks) {
+    const BlockedInstance blocked = build_blocks(inst, params.block_boxes, params.physics);
+    if (blocked.grouped > 0) {
+      GaParams sub = params;
+      sub.blocks = false;
+      sub.slab_mode = SlabMode::kOff;
+      if (!params.seed_orders.empty()) {
+        // A block goes where the first of its members does.
+        std::unordered_map<std::string, size_t> block_of;
+        for (size_t b = 0; b < blocked.blocks.size(); ++b) {
+          for (size_t m : blocked.blocks[b].members) block_of.emplace(inst.boxes[m].id, b);
+        }
+        for (auto& ids : sub.seed_orders) {
+          std::vector<char> seen(blocked.blocks.size(), 0);
+          std::vector<std::string> order;
+          for (const auto& id : ids) {
+            const auto it = block_of.find(id);
+            if (it == block_of.end() || seen[it->second]) continue;
+            seen[it->second] = 1;
+            order.push_back(blocked.instance.boxes[it->second].id);
+          }
+          ids = std::move(order);
+        }
+      }
+      int blocked_generations = 0;
+      if (params.on_progress) {
+        // Callers see boxes, not blocks.
+        sub.on_progress = [&](const GaProgress& g) {
+          const Result expanded = expand_blocks(blocked, inst, *g.incumbent, params.decoder, params.physics);
+          GaProgress out = g;
+          out.placed = expanded.placed.size();
+          out.unplaced = expanded.unplaced.size();
+          out.incumbent = &expanded;
+          blocked_generations = g.generations;
+          params.on_progress(out);
+        };
+      }
+      const Result packed = optimize_ga(blocked.instance, sub);
+      Result out = expand_blocks(blocked, inst, packed, params.decoder, params.physics);
+      out.local_search_gain = packed.local_search_gain;
+      out.local_search_ms = packed.local_search_ms;
+      if (out.unplaced.empty()) return out;
+
+      // Blocks leave gaps single boxes would fill, which only costs boxes once the truck
+      // is full. A single-box run seeded with the expanded plan's order then looks for
+      // them, and the better plan is kept. It gets only the generations the blocks saved,
+      // so with blocks the whole run costs about what a single-box one does.
+      const double saved = 1.0 - static_cast<double>(blocked.instance.boxes.size()) / static_cast<double>(boxes.size());
+      GaParams single = params;
+      single.blocks = false;
+      single.generations = std::max(1, static_cast<int>(std::lround(params.generations * saved)));
+      single.seed_orders.insert(single.seed_orders.begin(), plan_order(out));
+      if (params.on_progress) {
+        single.on_progress = [&](const GaProgress& g) {
+          GaProgress next = g;
+          next.generation += blocked_generations;
+          next.generations += blocked_generations;
+          params.on_progress(next);
+        };
+      }
+      Result searched = optimize_ga(inst, single);
+      searched.local_search_gain += out.local_search_gain;
+      searched.local_search_ms += out.local_search_ms;
+      if (score_result(searched) > score_result(out)) return searched;
+      out.local_search_gain = searched.local_search_gain;
+      out.local_search_ms = searched.local_search_ms;
+      return out;
+    }
+  }
+
+  std::mt19937 rng(params.seed);
   std::uniform_real_distribution<double> uni(0.0, 1.0);
 
   const size_t n = boxes.size();
@@ -331,30 +161,161 @@ Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int popula
     if (shuffle) {
       std::shuffle(ind.order.begin(), ind.order.end(), rng);
     } else {
-      // Seed with a reasonable heuristic: sort by volume desc then priority.
-      std::stable_sort(ind.order.begin(), ind.order.end(), [&](size_t a, size_t b) {
-        const auto& A = boxes[a];
-        const auto& B = boxes[b];
-        const double va = volume(A.w, A.h, A.d);
-        const double vb = volume(B.w, B.h, B.d);
-        if (std::fabs(va - vb) > 1e-12) return va > vb;
-        return A.priority > B.priority;
-      });
+      // Seed with a reasonable heuristic: sort by volume desc then priority. With several
+      // stops, the last stop's boxes go first, to the front.
+      std::stable_sort(ind.order.begin(), ind.order.end(),
+                       [&](size_t a, size_t b) { return packs_before(inst, a, b); });
     }
-    ind.result = pack_by_order(truck, boxes, ind.order);
-    ind.score = score_result(ind.result);
     return ind;
   };
 
+  // Converted once per run; every decode shares it.
+  const bool fixed = params.fixed_unit > 0 && params.decoder == DecoderKind::kExtremePoints;
+  const FixedGeometry geometry = fixed ? make_fixed_geometry(inst, params.fixed_unit) : FixedGeometry{};
+
+  auto new_decoder = [&]() -> std::unique_ptr<Decoder> {
+    if (fixed) return make_fixed_point_decoder(inst, geometry, params.physics);
+    return make_decoder(inst, params.decoder, params.physics);
+  };
+
+  auto decode = [&](Individual& ind) {
+    std::unique_ptr<Decoder> decoder = new_decoder();
+    for (size_t idx : ind.order) decoder->place(idx);
+    ind.result = decoder->result();
+    settle_lateral_offset(inst, decoder->supports(), &ind.result);
+    ind.score = score_result(ind.result);
+  };
+
+  // Decoding is pure, so fanning it out through parallel_for gives the same results.
+  auto decode_from = [&](std::vector<Individual>& v, size_t from) {
+    if (!params.parallel_for) {
+      for (size_t i = from; i < v.size(); ++i) decode(v[i]);
+      return;
+    }
+    params.parallel_for(v.size() - from, [&](size_t i) { decode(v[from + i]); });
+  };
+
+  // Memetic local search on one individual. Its order is decoded once, keeping a copy of
+  // the decoder every `stride` positions; a move resumes from the last copy at or before
+  // the first position it changes. The score can then only fall as boxes fail to place,
+  // so a move is dropped as soon as the boxes it has lost make beating the individual
+  // impossible. Moves are kept when they raise the score (first improvement).
+  const size_t stride = std::max<size_t>(4, n / 16);
+  // Utilization is measured against the truck, as in score_result, not the manifest.
+  const double truck_volume = inst.truck.w * inst.truck.h * inst.truck.d;
+  auto local_search = [&](Individual& ind, uint32_t seed) {
+    // With every box placed each order scores the same.
+    if (ind.result.unplaced.empty()) return;
+    std::mt19937 lrng(seed);
+    std::uniform_int_distribution<size_t> pos(0, n - 1);
+    // marks[k] has placed order[0, k * stride).
+    std::vector<std::unique_ptr<Decoder>> marks;
+    std::vector<std::unique_ptr<Decoder>> fresh;
+    // nullptr once the continuation cannot score above `beat`.
+    auto resume = [&](const std::vector<size_t>& order, size_t k, double beat) -> std::unique_ptr<Decoder> {
+      fresh.clear();
+      std::unique_ptr<Decoder> d = marks[k]->clone();
+      const Result& at = d->result();
+      double reachable = at.used_volume;
+      for (size_t p = k * stride; p < n; ++p) reachable += inst.volumes[order[p]];
+      size_t lost = at.unplaced.size();
+      for (size_t p = k * stride; p < n; ++p) {
+        if (p % stride == 0 && p > k * stride) fresh.push_back(d->clone());
+        if (d->place(order[p])) continue;
+        reachable -= inst.volumes[order[p]];
+        ++lost;
+        const double utilization = truck_volume > 0 ? reachable / truck_volume : 0;
+        if (utilization * 100.0 - static_cast<double>(lost) * 0.5 <= beat) return nullptr;
+      }
+      return d;
+    };
+    marks.push_back(new_decoder());
+    resume(ind.order, 0, -std::numeric_limits<double>::infinity());
+    for (auto& d : fresh) marks.push_back(std::move(d));
+
+    const auto& type = inst.type_of;
+    // Partners stay within `stride` positions, so a move changes one neighbourhood of the
+    // order rather than reshuffling it.
+    auto near = [&](size_t i) {
+      const size_t lo = i > stride ? i - stride : 0;
+      return lo + lrng() % (std::min(n - 1, i + stride) - lo + 1);
+    };
+    std::vector<size_t> trial;
+    for (int m = 0; m < params.local_search_moves; ++m) {
+      trial = ind.order;
+      size_t first = 0;
+      const size_t i = pos(lrng);
+      switch (lrng() % 3) {
+        case 0: {  // adjacent swap
+          const size_t a = std::min(i, n - 2);
+          if (type[trial[a]] == type[trial[a + 1]]) continue;
+          std::swap(trial[a], trial[a + 1]);
+          first = a;
+          break;
+        }
+        case 1: {  // move a block of up to 8 boxes nearby
+          const size_t len = 1 + lrng() % std::min<size_t>(8, n - i);
+          const size_t to = std::min(near(i), n - len);
+          if (to == i) continue;
+          std::vector<size_t> segment(trial.begin() + static_cast<std::ptrdiff_t>(i),
+                                      trial.begin() + static_cast<std::ptrdiff_t>(i + len));
+          trial.erase(trial.begin() + static_cast<std::ptrdiff_t>(i),
+                      trial.begin() + static_cast<std::ptrdiff_t>(i + len));
+          trial.insert(trial.begin() + static_cast<std::ptrdiff_t>(to), segment.begin(), segment.end());
+          first = std::min(i, to);
+          break;
+        }
+        default: {  // swap with a nearby box of another type; identical boxes decode the same
+          const size_t j = near(i);
+          if (type[trial[i]] == type[trial[j]]) continue;
+          std::swap(trial[i], trial[j]);
+          first = std::min(i, j);
+          break;
+        }
+      }
+      const size_t k = first / stride;
+      std::unique_ptr<Decoder> d = resume(trial, k, ind.score);
+      if (!d) continue;
+      Result result = d->result();
+      settle_lateral_offset(inst, d->supports(), &result);
+      const double score = score_result(result);
+      if (!(score > ind.score + 1e-12)) continue;
+      ind.order.swap(trial);
+      ind.result = std::move(result);
+      ind.score = score;
+      marks.resize(k + 1);
+      for (auto& c : fresh) marks.push_back(std::move(c));
+    }
+  };
+  double ls_gain = 0;
+  double ls_ms = 0;
+
   population = std::max(population, 4);
   generations = std::max(generations, 1);
+  const size_t ls_elites = n > 1 ? static_cast<size_t>(std::clamp(params.local_search_elites, 0, population)) : 0;
 
   std::vector<Individual> pop;
   pop.reserve(static_cast<size_t>(population));
   pop.push_back(make_individual(false));
+  if (!params.seed_orders.empty()) {
+    // Warm start: the seed orders, then copies with a few random swaps each, up to half the
+    // population. Random individuals fill the rest so the search can still move away.
+    std::vector<std::vector<size_t>> seeds;
+    for (const auto& ids : params.seed_orders) seeds.push_back(warm_order(inst, ids));
+    const size_t seeded = std::max(seeds.size(), static_cast<size_t>(population / 2));
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (size_t k = 0; k < seeded && static_cast<int>(pop.size()) < population; ++k) {
+      Individual ind;
+      ind.order = seeds[k % seeds.size()];
+      const size_t swaps = k < seeds.size() ? 0 : 1 + (k / seeds.size()) % 3;
+      for (size_t s = 0; s < swaps; ++s) std::swap(ind.order[pick(rng)], ind.order[pick(rng)]);
+      pop.push_back(std::move(ind));
+    }
+  }
   while (static_cast<int>(pop.size()) < population) {
     pop.push_back(make_individual(true));
   }
+  decode_from(pop, 0);
 
   auto select_parent = [&]() -> const Individual& {
     // Tournament selection (k=3)
@@ -404,8 +365,64 @@ Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int popula
     std::swap(ind.order[a], ind.order[b]);
   };
 
+  using Clock = std::chrono::steady_clock;
+  const auto interval = std::chrono::milliseconds(std::max(params.progress_interval_ms, 0));
+  Clock::time_point last_report{};
+  double reported_score = -std::numeric_limits<double>::infinity();
+  bool reported_once = false;
+
+  auto report = [&](const Individual& best, int gen, bool force) {
+    if (!params.on_progress) return;
+    const auto now = Clock::now();
+    if (!force && reported_once && now - last_report < interval) return;
+    last_report = now;
+    reported_once = true;
+    const bool improved = best.score > reported_score;
+    if (improved) reported_score = best.score;
+    GaProgress g{gen, generations, best.score, best.result.utilization, best.result.placed.size(),
+                 best.result.unplaced.size(), improved, &best.result};
+    g.local_search_gain = ls_gain;
+    g.local_search_ms = ls_ms;
+    params.on_progress(g);
+  };
+
+  auto finish = [&](const Individual& best) {
+    Result r = best.result;
+    r.local_search_gain = ls_gain;
+    r.local_search_ms = ls_ms;
+    return r;
+  };
+
   for (int gen = 0; gen < generations; ++gen) {
     std::sort(pop.begin(), pop.end(), [](const Individual& x, const Individual& y) { return x.score > y.score; });
+    report(pop.front(), gen, false);
+    if (params.cancel && params.cancel->load(std::memory_order_relaxed)) {
+      return finish(pop.front());
+    }
+    if (ls_elites > 0) {
+      // Each elite searches with its own seed, so fanning out gives the same results.
+      std::vector<uint32_t> seeds(ls_elites);
+      for (auto& seed : seeds) seed = static_cast<uint32_t>(rng());
+      std::vector<double> gain(ls_elites), ms(ls_elites);
+      auto improve = [&](size_t i) {
+        const double t0 = thread_cpu_ms();
+        const double before = pop[i].score;
+        local_search(pop[i], seeds[i]);
+        gain[i] = pop[i].score - before;
+        ms[i] = thread_cpu_ms() - t0;
+      };
+      if (params.parallel_for) {
+        params.parallel_for(ls_elites, improve);
+      } else {
+        for (size_t i = 0; i < ls_elites; ++i) improve(i);
+      }
+      for (size_t i = 0; i < ls_elites; ++i) {
+        ls_gain += gain[i];
+        ls_ms += ms[i];
+      }
+      std::sort(pop.begin(), pop.end(), [](const Individual& x, const Individual& y) { return x.score > y.score; });
+    }
+    double incumbent_score = pop.front().score;
 
     // Elitism: keep top 10%
     const int elite = std::max(1, population / 10);
@@ -418,16 +435,35 @@ Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int popula
       const Individual& p2 = select_parent();
       Individual child = crossover(p1, p2);
       mutate(child);
-      child.result = pack_by_order(truck, boxes, child.order);
-      child.score = score_result(child.result);
       next.push_back(std::move(child));
     }
 
+    if (params.parallel_for) decode_from(next, static_cast<size_t>(elite));
+    for (size_t i = static_cast<size_t>(elite); i < next.size(); ++i) {
+      Individual& child = next[i];
+      if (!params.parallel_for) decode(child);
+      if (child.score > incumbent_score) {
+        // Surface improvements as they happen rather than at the next generation.
+        incumbent_score = child.score;
+        report(child, gen, false);
+      }
+    }
+
     pop = std::move(next);
   }
 
   std::sort(pop.begin(), pop.end(), [](const Individual& x, const Individual& y) { return x.score > y.score; });
-  return pop.front().result;
+  report(pop.front(), generations, true);
+  return finish(pop.front());
+}
+
+Result optimize_ga(const Truck& truck, const std::vector<Box>& boxes, int population, int generations, double mutation_rate, uint32_t seed) {
+  GaParams params;
+  params.population = population;
+  params.generations = generations;
+  params.mutation_rate = mutation_rate;
+  params.seed = seed;
+  return optimize_ga(prepare_instance(truck, boxes), params);
 }
 
 }  // namespace engine
@@ -0,0 +1,230 @@
+#include "height_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include "packing_common.h"
+
+namespace engine {
+namespace packing {
+
+namespace {
+
+// Buckets across the floor's width; square buckets continue along its depth.
+constexpr int kBucketsAcross = 8;
+constexpr int kMaxBucketsAlong = 1024;
+
+template <typename T>
+bool overlaps(T ax0, T ax1, T az0, T az1, T bx0, T bx1, T bz0, T bz1) {
+  return ax0 < bx1 && bx0 < ax1 && az0 < bz1 && bz0 < az1;
+}
+
+// Emits the parts of [x0, x1) × [z0, z1) outside the hole, which overlaps it: up to two
+// full-depth strips beside the hole and two more in front of and behind it.
+template <typename T, typename Emit>
+void cut(T x0, T x1, T z0, T z1, T hx0, T hx1, T hz0, T hz1, Emit emit) {
+  if (x0 < hx0) emit(x0, hx0, z0, z1);
+  if (hx1 < x1) emit(hx1, x1, z0, z1);
+  const T mx0 = std::max(x0, hx0);
+  const T mx1 = std::min(x1, hx1);
+  if (z0 < hz0) emit(mx0, mx1, z0, hz0);
+  if (hz1 < z1) emit(mx0, mx1, hz1, z1);
+}
+
+// Whether a top raised from `below` to `top` may still count as level with a base that
+// `below` is level with.
+template <typename T>
+bool within_level_gap(T below, T top) {
+  if constexpr (std::is_integral_v<T>) {
+    return false;
+  } else {
+    return top - below <= 2 * kLevelEps;
+  }
+}
+
+// Index of the cell holding v, before clamping to the grid.
+template <typename T>
+long cell_index(T v, T cell) {
+  if constexpr (std::is_integral_v<T>) {
+    return v / cell;
+  } else {
+    return static_cast<long>(std::floor(v / cell));
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void HeightMap<T>::set_floor(T width, T depth) {
+  T cell = width / kBucketsAcross;
+  if constexpr (std::is_integral_v<T>) cell = std::max<T>(cell, 1);
+  if (!(cell > 0)) return clear();
+  const int nx = static_cast<int>(std::min<long>(cell_index(width, cell) + 1, kMaxBucketsAlong));
+  const int nz = static_cast<int>(std::min<long>(cell_index(std::max<T>(depth, 0), cell) + 1, kMaxBucketsAlong));
+  if (cell != cell_ || nx != nx_ || nz != nz_) {
+    cell_ = cell;
+    nx_ = nx;
+    nz_ = nz;
+    buckets_.assign(static_cast<size_t>(nx) * nz, {});
+  }
+  clear();
+}
+
+template <typename T>
+void HeightMap<T>::clear() {
+  for (auto* v : {&x0_, &x1_, &z0_, &z1_, &top_}) v->clear();
+  owner_.clear();
+  free_.clear();
+  for (auto& b : buckets_) b.clear();
+  exact_ = true;
+}
+
+template <typename T>
+void HeightMap<T>::reserve(size_t n) {
+  for (auto* v : {&x0_, &x1_, &z0_, &z1_, &top_}) v->reserve(n);
+  owner_.reserve(n);
+}
+
+template <typename T>
+int HeightMap<T>::bucket(T v, int n) const {
+  if (!(cell_ > 0)) return 0;
+  const long k = cell_index(v, cell_);
+  return k < 0 ? 0 : (k >= n ? n - 1 : static_cast<int>(k));
+}
+
+template <typename T>
+typename HeightMap<T>::Buckets HeightMap<T>::buckets_of(T x0, T x1, T z0, T z1) const {
+  return Buckets{bucket(x0, nx_), bucket(x1, nx_), bucket(z0, nz_), bucket(z1, nz_)};
+}
+
+// A rectangle is listed in every bucket it spans, so it is visited only from the first
+// bucket it shares with the footprint.
+template <typename T>
+template <typename Visit>
+void HeightMap<T>::for_each_near(T x0, T x1, T z0, T z1, Visit visit) const {
+  const Buckets q = buckets_of(x0, x1, z0, z1);
+  for (int bz = q.z0; bz <= q.z1; ++bz) {
+    for (int bx = q.x0; bx <= q.x1; ++bx) {
+      for (uint32_t r : buckets_[static_cast<size_t>(bz) * nx_ + bx]) {
+        if ((bx != q.x0 && bucket(x0_[r], nx_) != bx) || (bz != q.z0 && bucket(z0_[r], nz_) != bz)) continue;
+        if (overlaps(x0_[r], x1_[r], z0_[r], z1_[r], x0, x1, z0, z1)) visit(r);
+      }
+    }
+  }
+}
+
+template <typename T>
+void HeightMap<T>::push(T x0, T x1, T z0, T z1, T top, uint32_t owner) {
+  uint32_t r;
+  if (free_.empty()) {
+    r = static_cast<uint32_t>(x0_.size());
+    x0_.push_back(x0);
+    x1_.push_back(x1);
+    z0_.push_back(z0);
+    z1_.push_back(z1);
+    top_.push_back(top);
+    owner_.push_back(owner);
+  } else {
+    r = free_.back();
+    free_.pop_back();
+    x0_[r] = x0;
+    x1_[r] = x1;
+    z0_[r] = z0;
+    z1_[r] = z1;
+    top_[r] = top;
+    owner_[r] = owner;
+  }
+  const Buckets b = buckets_of(x0, x1, z0, z1);
+  for (int bz = b.z0; bz <= b.z1; ++bz) {
+    for (int bx = b.x0; bx <= b.x1; ++bx) buckets_[static_cast<size_t>(bz) * nx_ + bx].push_back(r);
+  }
+}
+
+template <typename T>
+void HeightMap<T>::erase(uint32_t r) {
+  const Buckets b = buckets_of(x0_[r], x1_[r], z0_[r], z1_[r]);
+  for (int bz = b.z0; bz <= b.z1; ++bz) {
+    for (int bx = b.x0; bx <= b.x1; ++bx) {
+      auto& list = buckets_[static_cast<size_t>(bz) * nx_ + bx];
+      *std::find(list.begin(), list.end(), r) = list.back();
+      list.pop_back();
+    }
+  }
+  free_.push_back(r);
+}
+
+template <typename T>
+void HeightMap<T>::raise(T x, T z, T w, T d, T top, uint32_t owner) {
+  const T fx1 = x + w;
+  const T fz1 = z + d;
+  near_.clear();
+  for_each_near(x, fx1, z, fz1, [&](uint32_t r) { near_.push_back(r); });
+
+  // The footprint still to cover, as (x0, x1, z0, z1) quadruples: higher tops cut holes
+  // in it.
+  pieces_.assign({x, fx1, z, fz1});
+  for (uint32_t r : near_) {
+    const T rx0 = x0_[r], rx1 = x1_[r], rz0 = z0_[r], rz1 = z1_[r], rtop = top_[r];
+    if (rtop >= top) {
+      next_.clear();
+      for (size_t p = 0; p < pieces_.size(); p += 4) {
+        const T* q = &pieces_[p];
+        if (!overlaps(q[0], q[1], q[2], q[3], rx0, rx1, rz0, rz1)) {
+          next_.insert(next_.end(), q, q + 4);
+          continue;
+        }
+        cut(q[0], q[1], q[2], q[3], rx0, rx1, rz0, rz1, [&](T a0, T a1, T b0, T b1) { next_.insert(next_.end(), {a0, a1, b0, b1}); });
+      }
+      pieces_.swap(next_);
+      continue;
+    }
+
+    if (within_level_gap(rtop, top)) exact_ = false;
+    const uint32_t rowner = owner_[r];
+    erase(r);
+    cut(rx0, rx1, rz0, rz1, x, fx1, z, fz1, [&](T a0, T a1, T b0, T b1) { push(a0, a1, b0, b1, rtop, rowner); });
+  }
+
+  for (size_t p = 0; p < pieces_.size(); p += 4) push(pieces_[p], pieces_[p + 1], pieces_[p + 2], pieces_[p + 3], top, owner);
+}
+
+template <typename T>
+void HeightMap<T>::lower(T x, T z, T w, T d, uint32_t owner) {
+  near_.clear();
+  for_each_near(x, x + w, z, z + d, [&](uint32_t r) {
+    if (owner_[r] == owner) near_.push_back(r);
+  });
+  for (uint32_t r : near_) erase(r);
+}
+
+template <typename T>
+T HeightMap<T>::rest_height(T x, T z, T w, T d) const {
+  T y = 0;
+  for_each_near(x, x + w, z, z + d, [&](uint32_t r) { y = std::max(y, top_[r]); });
+  return y;
+}
+
+template <typename T>
+bool HeightMap<T>::level_owners(T x, T z, T w, T d, T base, std::vector<uint32_t>* owners) const {
+  if (!exact_) return false;
+  owners->clear();
+  bool covered = false;
+  for_each_near(x, x + w, z, z + d, [&](uint32_t r) {
+    if (level_with(top_[r], base)) {
+      owners->push_back(owner_[r]);
+    } else if (top_[r] > base) {
+      covered = true;
+    }
+  });
+  if (covered) return false;
+  std::sort(owners->begin(), owners->end());
+  owners->erase(std::unique(owners->begin(), owners->end()), owners->end());
+  return true;
+}
+
+template class HeightMap<double>;
+template class HeightMap<int32_t>;
+
+}  // namespace packing
+}  // namespace engine
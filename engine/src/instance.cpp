@@ -0,0 +1,88 @@
+#include "instance.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace engine {
+
+OrientationSet orientations_for(const Box& box, const Truck& truck) {
+  const std::array<std::array<double, 3>, 6> all = {
+      std::array<double, 3>{box.w, box.h, box.d},
+      std::array<double, 3>{box.w, box.d, box.h},
+      std::array<double, 3>{box.h, box.w, box.d},
+      std::array<double, 3>{box.h, box.d, box.w},
+      std::array<double, 3>{box.d, box.w, box.h},
+      std::array<double, 3>{box.d, box.h, box.w},
+  };
+  OrientationSet set{};
+  set.count = 0;
+  for (size_t i = 0; i < all.size(); ++i) {
+    const auto& r = all[i];
+    if (!(box.orientations & (1u << i))) continue;
+    if (r[0] > truck.w || r[1] > truck.h || r[2] > truck.d) continue;
+    if (std::find(set.dims.begin(), set.dims.begin() + set.count, r) != set.dims.begin() + set.count) continue;
+    set.dims[set.count++] = r;
+  }
+  return set;
+}
+
+size_t PreparedInstance::memory_bytes() const {
+  size_t bytes = sizeof(PreparedInstance);
+  bytes += boxes.capacity() * sizeof(Box);
+  for (const auto& b : boxes) {
+    if (b.id.capacity() > sizeof(std::string)) bytes += b.id.capacity();
+  }
+  bytes += volumes.capacity() * sizeof(double);
+  bytes += orientations.capacity() * sizeof(OrientationSet);
+  bytes += type_of.capacity() * sizeof(uint32_t);
+  bytes += rules.capacity() * sizeof(ItemRules);
+  bytes += stop_of.capacity() * sizeof(int32_t);
+  return bytes;
+}
+
+PreparedInstance prepare_instance(const Truck& truck, std::vector<Box> boxes) {
+  PreparedInstance inst;
+  inst.truck = truck;
+  inst.boxes = std::move(boxes);
+
+  const size_t n = inst.boxes.size();
+  inst.volumes.resize(n);
+  inst.orientations.resize(n);
+  inst.type_of.resize(n);
+
+  std::map<std::tuple<double, double, double, double, uint8_t, double, bool, int>, uint32_t> types;
+  for (size_t i = 0; i < n; ++i) {
+    const Box& b = inst.boxes[i];
+    inst.volumes[i] = b.w * b.h * b.d;
+    inst.total_volume += inst.volumes[i];
+    inst.orientations[i] = orientations_for(b, truck);
+    const auto key = std::make_tuple(b.w, b.h, b.d, b.weight, b.orientations, b.max_load, b.fragile, b.drop);
+    const auto it = types.emplace(key, static_cast<uint32_t>(types.size())).first;
+    inst.type_of[i] = it->second;
+  }
+  inst.type_count = static_cast<uint32_t>(types.size());
+
+  const bool limited = std::any_of(inst.boxes.begin(), inst.boxes.end(),
+                                   [](const Box& b) { return b.max_load > 0 || b.fragile; });
+  if (limited) {
+    inst.rules.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      inst.rules[i].max_load = inst.boxes[i].max_load;
+      inst.rules[i].fragile = inst.boxes[i].fragile;
+    }
+  }
+
+  if (std::any_of(inst.boxes.begin(), inst.boxes.end(), [](const Box& b) { return b.drop > 0; })) {
+    inst.stop_of.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      const int drop = inst.boxes[i].drop;
+      inst.stop_of[i] = drop > 0 ? drop : std::numeric_limits<int32_t>::max();
+    }
+  }
+  return inst;
+}
+
+}  // namespace engine
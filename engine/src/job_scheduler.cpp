@@ -0,0 +1,177 @@
+#include "job_scheduler.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace engine {
+
+namespace {
+
+double ms_between(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+  return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+}  // namespace
+
+const char* job_state_name(JobState s) {
+  switch (s) {
+    case JobState::kQueued:
+      return "queued";
+    case JobState::kRunning:
+      return "running";
+    case JobState::kDone:
+      return "done";
+    case JobState::kCancelled:
+      return "cancelled";
+    case JobState::kFailed:
+      return "failed";
+  }
+  return "unknown";
+}
+
+JobScheduler::JobScheduler(size_t workers, size_t max_queued, size_t max_finished)
+    : max_queued_(max_queued), max_finished_(std::max<size_t>(1, max_finished)) {
+  workers = std::max<size_t>(1, workers);
+  threads_.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) threads_.emplace_back([this] { worker_loop(); });
+}
+
+JobScheduler::~JobScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stopping_ = true;
+    for (auto& [id, job] : jobs_) job->cancel.store(true);
+  }
+  cv_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+uint64_t JobScheduler::submit(int priority, std::string label, Task task) {
+  auto job = std::make_shared<Job>();
+  job->priority = priority;
+  job->label = std::move(label);
+  job->task = std::move(task);
+  job->submitted = std::chrono::steady_clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (queued_ >= max_queued_) throw std::length_error("job queue is full");
+    job->id = next_id_++;
+    jobs_.emplace(job->id, job);
+    queue_.push(job);
+    ++queued_;
+  }
+  cv_.notify_one();
+  return job->id;
+}
+
+bool JobScheduler::status(uint64_t id, JobStatus* out) const {
+  std::lock_guard<std::mutex> lock(mu_);
+  const auto it = jobs_.find(id);
+  if (it == jobs_.end()) return false;
+  const Job& job = *it->second;
+  const auto now = std::chrono::steady_clock::now();
+
+  out->id = job.id;
+  out->state = job.state;
+  out->priority = job.priority;
+  out->label = job.label;
+  out->has_progress = job.has_progress;
+  out->progress = job.progress;
+  out->queued_ms = ms_between(job.submitted, job.state == JobState::kQueued ? now : job.started);
+  switch (job.state) {
+    case JobState::kQueued:
+      out->run_ms = 0;
+      break;
+    case JobState::kRunning:
+      out->run_ms = ms_between(job.started, now);
+      break;
+    default:
+      out->run_ms = job.started.time_since_epoch().count() ? ms_between(job.started, job.finished) : 0;
+      break;
+  }
+  out->result = job.result;
+  out->error = job.error;
+  return true;
+}
+
+bool JobScheduler::cancel(uint64_t id) {
+  std::shared_ptr<Job> job;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    const auto it = jobs_.find(id);
+    if (it == jobs_.end()) return false;
+    job = it->second;
+    if (job->state != JobState::kQueued && job->state != JobState::kRunning) return false;
+    job->cancel.store(true);
+    if (job->state != JobState::kQueued) return true;
+    // Still in the heap; the worker that pops it will skip it.
+    job->state = JobState::kCancelled;
+    job->task = nullptr;
+    job->finished = std::chrono::steady_clock::now();
+    --queued_;
+  }
+  finish(job);
+  return true;
+}
+
+void JobScheduler::worker_loop() {
+  for (;;) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mu_);
+      cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (stopping_) return;
+      job = queue_.top();
+      queue_.pop();
+      if (job->state != JobState::kQueued) continue;  // cancelled while queued
+      --queued_;
+      job->state = JobState::kRunning;
+      job->started = std::chrono::steady_clock::now();
+    }
+
+    auto on_progress = [this, &job](const GaProgress& p) {
+      std::lock_guard<std::mutex> lock(mu_);
+      job->progress = p;
+      job->progress.incumbent = nullptr;  // dangles once the callback returns
+      job->has_progress = true;
+    };
+
+    std::shared_ptr<const Result> result;
+    std::string error;
+    try {
+      result = std::make_shared<const Result>(job->task(on_progress, job->cancel));
+    } catch (const std::exception& e) {
+      error = e.what();
+    } catch (...) {
+      error = "unknown error";
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      job->finished = std::chrono::steady_clock::now();
+      job->result = std::move(result);
+      job->error = std::move(error);
+      if (!job->error.empty()) {
+        job->state = JobState::kFailed;
+      } else {
+        job->state = job->cancel.load() ? JobState::kCancelled : JobState::kDone;
+      }
+      job->task = nullptr;  // drop captured instance data early
+    }
+    finish(job);
+  }
+}
+
+void JobScheduler::finish(const std::shared_ptr<Job>& job) {
+  std::lock_guard<std::mutex> lock(mu_);
+  finished_.push_back(job->id);
+  while (finished_.size() > max_finished_) {
+    jobs_.erase(finished_.front());
+    finished_.pop_front();
+  }
+}
+
+}  // namespace engine
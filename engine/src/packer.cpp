@@ -0,0 +1,352 @@
+#include "packer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "instance.h"
+#include "packing_common.h"
+
+namespace engine {
+
+using namespace packing;
+
+class Packer::Session {
+ public:
+  virtual ~Session() = default;
+  virtual std::optional<Placement> add_box(const Box& box) = 0;
+  virtual void remove_box(const std::string& id) = 0;
+  virtual Result snapshot() const = 0;
+  virtual size_t size() const = 0;
+};
+
+namespace {
+
+// Removed boxes keep their slot with faces moved here, off the truck floor: no candidate
+// meets them and no base is level with their top.
+constexpr double kGone = -1.0;
+
+template <typename Physics>
+class PackerSession final : public Packer::Session {
+ public:
+  PackerSession(const Truck& truck, const PhysicsModel& physics) : truck_(truck), physics_(physics) {
+    if (has_balance_limits(truck_)) {
+      throw std::invalid_argument("sessions do not take trucks with axle or lateral balance limits");
+    }
+    placed_.set_floor(truck_.w, truck_.d);
+    add_candidate(0, 0, 0);
+  }
+
+  std::optional<Placement> add_box(const Box& box) override {
+    if (live_.count(box.id)) throw std::invalid_argument("box '" + box.id + "' is already placed");
+    if (box.drop != 0) {
+      throw std::invalid_argument("box '" + box.id + "' has a drop stop; sessions do not sequence stops");
+    }
+
+    const OrientationSet rots = orientations_for(box, truck_);
+    const double side = std::min({box.w, box.h, box.d});
+    if (side < smallest_side_) {
+      smallest_side_ = side;
+      // Stale runs are never shorter than fresh ones, so the rest stay out.
+      unpark([&](const Candidate<double>& c) { return c.shortest_run() + kEps >= side; });
+    }
+    bool found = false;
+    AABB best{};
+    AppliedLoads best_loads;
+    if (box.weight <= truck_.max_weight - total_weight_ + 1e-9) {
+      // Candidates iterate lowest, then frontmost, then leftmost, the extreme-point
+      // decoder's order of preference, so the first fit is the one it would pick.
+      for (auto it = candidates_.begin(); it != candidates_.end() && !found; ++it) {
+        const Candidate<double>& c = it->second;
+        if (c.shortest_run() + kEps < side) continue;
+        for (uint8_t ri = 0; ri < rots.count && !found; ++ri) {
+          const auto& r = rots.dims[ri];
+          if (r[0] > c.rx + kEps || r[1] > c.ry + kEps || r[2] > c.rz + kEps) continue;
+          const AABB candidate{c.x, c.y, c.z, r[0], r[1], r[2]};
+          if (!inside_truck(truck_, candidate) || any_intersects(placed_.geometry, candidate)) continue;
+          best_loads.clear();
+          if (support_ok_and_apply_load(candidate, box.weight, placed_, &best_loads, physics_.min_support)) {
+            found = true;
+            best = candidate;
+          } else {
+            rollback_loads(placed_, best_loads);
+          }
+        }
+      }
+    }
+
+    if (!found) {
+      if (!unplaced_volume_.count(box.id)) unplaced_.push_back(box.id);
+      unplaced_volume_[box.id] = volume(box.w, box.h, box.d);
+      return std::nullopt;
+    }
+    unplaced_.erase(std::remove(unplaced_.begin(), unplaced_.end(), box.id), unplaced_.end());
+    commit(box, best, std::move(best_loads));
+
+    // The box's own corner and any point it now covers are gone, and the runs of the
+    // points it stands in front of end at it; its three far corners are new extreme
+    // points.
+    for (auto it = candidates_.begin(); it != candidates_.end();) {
+      Candidate<double>& c = it->second;
+      if (!clip_runs(c, best.x, best.x + best.w, best.y, best.y + best.h, best.z, best.z + best.d)) {
+        it = candidates_.erase(it);
+      } else if (c.shortest_run() + kEps < smallest_side_) {
+        parked_.push_back(c);
+        it = candidates_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    add_candidate(best.x + best.w, best.y, best.z);
+    add_candidate(best.x, best.y, best.z + best.d);
+    add_candidate(best.x, best.y + best.h, best.z);
+    return slots_.back().placement;
+  }
+
+  void remove_box(const std::string& id) override {
+    const auto it = live_.find(id);
+    if (it == live_.end()) throw std::invalid_argument("box '" + id + "' is not placed");
+    const uint32_t slot = it->second;
+    Slot& s = slots_[slot];
+    if (s.carrying > 0) throw std::invalid_argument("box '" + id + "' carries other boxes");
+
+    if constexpr (Physics::kCrush) rollback_loads(placed_, s.applied);
+    for (uint32_t k : s.rests_on) --slots_[k].carrying;
+    total_weight_ -= s.box.weight;
+    used_volume_ -= volume(s.placement.w, s.placement.h, s.placement.d);
+    const Placement& p = s.placement;
+    moments_.add(-s.box.weight, p.x + p.w / 2, p.y + p.h / 2, p.z + p.d / 2);
+    live_.erase(it);
+    s.live = false;
+    s.applied.clear();
+    s.rests_on.clear();
+    for (auto* v : {&placed_.geometry.x0, &placed_.geometry.x1, &placed_.geometry.y0, &placed_.geometry.y1,
+                    &placed_.geometry.z0, &placed_.geometry.z1}) {
+      (*v)[slot] = kGone;
+    }
+    if constexpr (Physics::kSupport) {
+      // Bring back into view whatever the box hid; raise() keeps the highest top.
+      placed_.surface.lower(p.x, p.z, p.w, p.d, slot);
+      for (uint32_t k = 0; k < slots_.size(); ++k) {
+        const Placement& o = slots_[k].placement;
+        if (!slots_[k].live || overlap_1d(o.x, o.x + o.w, p.x, p.x + p.w) <= kEps ||
+            overlap_1d(o.z, o.z + o.d, p.z, p.z + p.d) <= kEps) {
+          continue;
+        }
+        placed_.surface.raise(o.x, o.z, o.w, o.d, o.y + o.h, k);
+      }
+    }
+    regrow_runs(p);
+    add_candidate(p.x, p.y, p.z);
+
+    if (slots_.size() - live_.size() > std::max<size_t>(live_.size(), kMinCompaction)) compact();
+  }
+
+  Result snapshot() const override {
+    Result r;
+    r.placed.reserve(live_.size());
+    double offered_volume = used_volume_;
+    for (const Slot& s : slots_) {
+      if (s.live) r.placed.push_back(s.placement);
+    }
+    for (const auto& id : unplaced_) {
+      r.unplaced.push_back(id);
+      offered_volume += unplaced_volume_.at(id);
+    }
+    r.used_volume = used_volume_;
+    r.total_volume = offered_volume;
+    const double truck_volume = truck_.w * truck_.h * truck_.d;
+    r.utilization = truck_volume > 0 ? used_volume_ / truck_volume : 0;
+    r.total_weight = total_weight_;
+    report_balance(truck_, moments_, &r);
+    return r;
+  }
+
+  size_t size() const override { return live_.size(); }
+
+ private:
+  struct Slot {
+    Box box;
+    Placement placement;
+    bool live = true;
+    uint32_t carrying = 0;          // boxes resting on this one
+    std::vector<uint32_t> rests_on;  // slots this one rests on
+    AppliedLoads applied;            // loads it put on the boxes below
+  };
+
+  // Holes are only compacted past this many, so small sessions never rebuild.
+  static constexpr size_t kMinCompaction = 64;
+
+  double max_load_of(const Box& box, const AABB& b) const {
+    if (box.fragile) return 0;
+    if (box.max_load > 0) return box.max_load;
+    return max_load_for(physics_, box.weight, b.w * b.d);
+  }
+
+  void commit(const Box& box, const AABB& b, AppliedLoads applied) {
+    const auto slot = static_cast<uint32_t>(slots_.size());
+    Slot s;
+    s.box = box;
+    s.placement = Placement{box.id, b.x, b.y, b.z, b.w, b.h, b.d};
+    if constexpr (Physics::kSupport) {
+      if (b.y > kEps) {
+        const size_t hits = support_contacts(b, placed_);
+        for (size_t h = 0; h < hits; ++h) {
+          if (placed_.ox[h] * placed_.oz[h] <= kEps) continue;
+          s.rests_on.push_back(placed_.hits[h]);
+          ++slots_[placed_.hits[h]].carrying;
+        }
+      }
+    }
+    s.applied = std::move(applied);
+    placed_.add(b, max_load_of(box, b));
+    total_weight_ += box.weight;
+    used_volume_ += volume(b.w, b.h, b.d);
+    moments_.add(box.weight, b.x + b.w / 2, b.y + b.h / 2, b.z + b.d / 2);
+    unplaced_volume_.erase(box.id);
+    live_[box.id] = slot;
+    slots_.push_back(std::move(s));
+  }
+
+  // Rebuilds the placed state from the live boxes, in placement order, dropping holes.
+  // Every live box still rests on the boxes it rested on, but the loads add up again in
+  // a new order; if that puts any box past its max load, the holes stay and every box
+  // keeps its slot.
+  void compact() {
+    std::vector<Slot> old = std::move(slots_);
+    const PlacedBoxes<double, Physics> old_placed = placed_;
+    const std::unordered_map<std::string, uint32_t> old_live = live_;
+    const double old_weight = total_weight_;
+    const double old_volume = used_volume_;
+    const LoadMoments old_moments = moments_;
+
+    slots_.clear();
+    live_.clear();
+    placed_.clear();
+    placed_.set_floor(truck_.w, truck_.d);
+    total_weight_ = 0;
+    used_volume_ = 0;
+    moments_ = LoadMoments{};
+    for (const Slot& s : old) {
+      if (!s.live) continue;
+      const Placement& p = s.placement;
+      const AABB b{p.x, p.y, p.z, p.w, p.h, p.d};
+      AppliedLoads applied;
+      if (!support_ok_and_apply_load(b, s.box.weight, placed_, &applied, 0.0)) {
+        slots_ = std::move(old);
+        placed_ = old_placed;
+        live_ = old_live;
+        total_weight_ = old_weight;
+        used_volume_ = old_volume;
+        moments_ = old_moments;
+        return;
+      }
+      commit(s.box, b, std::move(applied));
+    }
+  }
+
+  // The point with its runs to the walls and the live boxes; false when a box covers it.
+  bool measure_runs(Candidate<double>& c) const {
+    c.rx = truck_.w - c.x;
+    c.ry = truck_.h - c.y;
+    c.rz = truck_.d - c.z;
+    const PlacedGeometry<double>& g = placed_.geometry;
+    for (size_t i = 0; i < g.size(); ++i) {
+      if (!clip_runs(c, g.x0[i], g.x1[i], g.y0[i], g.y1[i], g.z0[i], g.z1[i])) return false;
+    }
+    return true;
+  }
+
+  void add_candidate(double x, double y, double z) {
+    if (x >= truck_.w - kEps || y >= truck_.h - kEps || z >= truck_.d - kEps) return;
+    Candidate<double> c{x, y, z, 0, 0, 0};
+    if (!measure_runs(c)) return;
+    if (c.shortest_run() + kEps < smallest_side_) {
+      parked_.push_back(c);
+      return;
+    }
+    insert_candidate(c);
+  }
+
+  void insert_candidate(const Candidate<double>& c) {
+    auto key = [](double v) { return static_cast<long long>(std::llround(v * 100000.0)); };
+    candidates_.emplace(std::make_tuple(key(c.y), key(c.z), key(c.x)), c);
+  }
+
+  // Parked points are too tight for every box offered so far, so add_box never looks at
+  // them. Their runs went stale when they were parked: boxes added since then did not
+  // shorten them, and a removal may have lengthened them.
+  //
+  // Measures again the parked points `stale` picks and brings back those a box now fits.
+  template <typename Stale>
+  void unpark(Stale stale) {
+    std::vector<Candidate<double>> still;
+    for (Candidate<double>& c : parked_) {
+      if (!stale(c)) {
+        still.push_back(c);
+      } else if (measure_runs(c)) {
+        if (c.shortest_run() + kEps < smallest_side_) {
+          still.push_back(c);
+        } else {
+          insert_candidate(c);
+        }
+      }
+    }
+    parked_.swap(still);
+  }
+
+  // The runs the removed box p cut short are measured again.
+  void regrow_runs(const Placement& p) {
+    auto cut_by_p = [&](const Candidate<double>& c) {
+      Candidate<double> open{c.x, c.y, c.z, truck_.w - c.x, truck_.h - c.y, truck_.d - c.z};
+      clip_runs(open, p.x, p.x + p.w, p.y, p.y + p.h, p.z, p.z + p.d);
+      return open.rx < truck_.w - c.x || open.ry < truck_.h - c.y || open.rz < truck_.d - c.z;
+    };
+    for (auto& entry : candidates_) {
+      if (cut_by_p(entry.second)) measure_runs(entry.second);
+    }
+    unpark(cut_by_p);
+  }
+
+  Truck truck_;
+  const PhysicsModel physics_;
+  PlacedBoxes<double, Physics> placed_;
+  std::vector<Slot> slots_;
+  std::unordered_map<std::string, uint32_t> live_;
+  // Extreme points keyed (y, z, x) on the decoder's de-dup grid, with their free runs.
+  std::map<std::tuple<long long, long long, long long>, Candidate<double>> candidates_;
+  // Points whose shortest run is below smallest_side_, the shortest side of any box
+  // offered so far.
+  std::vector<Candidate<double>> parked_;
+  double smallest_side_ = std::numeric_limits<double>::infinity();
+  std::vector<std::string> unplaced_;
+  std::unordered_map<std::string, double> unplaced_volume_;
+  double total_weight_ = 0;
+  double used_volume_ = 0;
+  LoadMoments moments_;
+};
+
+}  // namespace
+
+Packer::Packer(const Truck& truck, const PhysicsModel& physics)
+    : session_(with_physics(physics.mode, [&](auto policy) -> std::unique_ptr<Session> {
+        return std::make_unique<PackerSession<decltype(policy)>>(truck, physics);
+      })) {}
+
+Packer::~Packer() = default;
+Packer::Packer(Packer&&) noexcept = default;
+Packer& Packer::operator=(Packer&&) noexcept = default;
+
+std::optional<Placement> Packer::add_box(const Box& box) { return session_->add_box(box); }
+void Packer::remove_box(const std::string& id) { session_->remove_box(id); }
+Result Packer::snapshot() const { return session_->snapshot(); }
+size_t Packer::size() const { return session_->size(); }
+
+}  // namespace engine
@@ -0,0 +1,352 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "packing_common.h"
+
+// Function multiversioning: each kernel below is written once per target under its own
+// name, and multiversioned entry points let the loader resolve a call to the best one the
+// CPU supports.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ENGINE_PLACED_KERNELS_FMV 1
+#include <immintrin.h>
+#define ENGINE_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ENGINE_TARGET(isa)
+#endif
+
+namespace engine {
+namespace packing {
+
+namespace {
+
+// Scalar kernels; also finish the lanes left over by the vector ones.
+template <typename T>
+bool any_hit_from(const PlacedGeometry<T>& g, const BasicAABB<T>& b, size_t i) {
+  const T ax1 = b.x + b.w;
+  const T ay1 = b.y + b.h;
+  const T az1 = b.z + b.d;
+  for (; i < g.size(); ++i) {
+    if (b.x < g.x1[i] && g.x0[i] < ax1 && b.y < g.y1[i] && g.y0[i] < ay1 && b.z < g.z1[i] && g.z0[i] < az1) return true;
+  }
+  return false;
+}
+
+template <typename T>
+size_t overlaps_from(const PlacedGeometry<T>& g, const BasicAABB<T>& b, uint32_t* idx, T* ox, T* oz, size_t i, size_t k) {
+  const T ax1 = b.x + b.w;
+  const T az1 = b.z + b.d;
+  for (; i < g.size(); ++i) {
+    if (!level_with(g.y1[i], b.y)) continue;
+    const T x = overlap_1d(b.x, ax1, g.x0[i], g.x1[i]);
+    const T z = overlap_1d(b.z, az1, g.z0[i], g.z1[i]);
+    if (x > 0 && z > 0) {
+      idx[k] = static_cast<uint32_t>(i);
+      ox[k] = x;
+      oz[k] = z;
+      ++k;
+    }
+  }
+  return k;
+}
+
+bool any_hit_scalar(const PlacedGeometry<double>& g, const AABB& b) { return any_hit_from(g, b, 0); }
+bool any_hit_scalar(const PlacedGeometry<int32_t>& g, const FixedAABB& b) { return any_hit_from(g, b, 0); }
+size_t overlaps_scalar(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  return overlaps_from(g, b, idx, ox, oz, 0, 0);
+}
+size_t overlaps_scalar(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  return overlaps_from(g, b, idx, ox, oz, 0, 0);
+}
+
+#ifdef ENGINE_PLACED_KERNELS_FMV
+
+ENGINE_TARGET("avx2") bool any_hit_avx2(const PlacedGeometry<double>& g, const AABB& b) {
+  const __m256d ax0 = _mm256_set1_pd(b.x), ax1 = _mm256_set1_pd(b.x + b.w);
+  const __m256d ay0 = _mm256_set1_pd(b.y), ay1 = _mm256_set1_pd(b.y + b.h);
+  const __m256d az0 = _mm256_set1_pd(b.z), az1 = _mm256_set1_pd(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d m = _mm256_and_pd(_mm256_cmp_pd(ax0, _mm256_loadu_pd(&g.x1[i]), _CMP_LT_OQ),
+                              _mm256_cmp_pd(_mm256_loadu_pd(&g.x0[i]), ax1, _CMP_LT_OQ));
+    m = _mm256_and_pd(m, _mm256_cmp_pd(ay0, _mm256_loadu_pd(&g.y1[i]), _CMP_LT_OQ));
+    m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(&g.y0[i]), ay1, _CMP_LT_OQ));
+    m = _mm256_and_pd(m, _mm256_cmp_pd(az0, _mm256_loadu_pd(&g.z1[i]), _CMP_LT_OQ));
+    m = _mm256_and_pd(m, _mm256_cmp_pd(_mm256_loadu_pd(&g.z0[i]), az1, _CMP_LT_OQ));
+    if (_mm256_movemask_pd(m) != 0) return true;
+  }
+  return any_hit_from(g, b, i);
+}
+
+ENGINE_TARGET("avx512f") bool any_hit_avx512(const PlacedGeometry<double>& g, const AABB& b) {
+  const __m512d ax0 = _mm512_set1_pd(b.x), ax1 = _mm512_set1_pd(b.x + b.w);
+  const __m512d ay0 = _mm512_set1_pd(b.y), ay1 = _mm512_set1_pd(b.y + b.h);
+  const __m512d az0 = _mm512_set1_pd(b.z), az1 = _mm512_set1_pd(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __mmask8 m = _mm512_cmp_pd_mask(ax0, _mm512_loadu_pd(&g.x1[i]), _CMP_LT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(&g.x0[i]), ax1, _CMP_LT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, ay0, _mm512_loadu_pd(&g.y1[i]), _CMP_LT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(&g.y0[i]), ay1, _CMP_LT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, az0, _mm512_loadu_pd(&g.z1[i]), _CMP_LT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, _mm512_loadu_pd(&g.z0[i]), az1, _CMP_LT_OQ);
+    if (m != 0) return true;
+  }
+  return any_hit_from(g, b, i);
+}
+
+ENGINE_TARGET("avx2") inline __m256i load8(const std::vector<int32_t>& v, size_t i) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&v[i]));
+}
+
+ENGINE_TARGET("avx2") bool any_hit_avx2(const PlacedGeometry<int32_t>& g, const FixedAABB& b) {
+  const __m256i ax0 = _mm256_set1_epi32(b.x), ax1 = _mm256_set1_epi32(b.x + b.w);
+  const __m256i ay0 = _mm256_set1_epi32(b.y), ay1 = _mm256_set1_epi32(b.y + b.h);
+  const __m256i az0 = _mm256_set1_epi32(b.z), az1 = _mm256_set1_epi32(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i m = _mm256_and_si256(_mm256_cmpgt_epi32(load8(g.x1, i), ax0), _mm256_cmpgt_epi32(ax1, load8(g.x0, i)));
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(load8(g.y1, i), ay0));
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(ay1, load8(g.y0, i)));
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(load8(g.z1, i), az0));
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(az1, load8(g.z0, i)));
+    if (_mm256_movemask_epi8(m) != 0) return true;
+  }
+  return any_hit_from(g, b, i);
+}
+
+ENGINE_TARGET("avx512f") bool any_hit_avx512(const PlacedGeometry<int32_t>& g, const FixedAABB& b) {
+  const __m512i ax0 = _mm512_set1_epi32(b.x), ax1 = _mm512_set1_epi32(b.x + b.w);
+  const __m512i ay0 = _mm512_set1_epi32(b.y), ay1 = _mm512_set1_epi32(b.y + b.h);
+  const __m512i az0 = _mm512_set1_epi32(b.z), az1 = _mm512_set1_epi32(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __mmask16 m = _mm512_cmpgt_epi32_mask(_mm512_loadu_si512(&g.x1[i]), ax0);
+    m = _mm512_mask_cmpgt_epi32_mask(m, ax1, _mm512_loadu_si512(&g.x0[i]));
+    m = _mm512_mask_cmpgt_epi32_mask(m, _mm512_loadu_si512(&g.y1[i]), ay0);
+    m = _mm512_mask_cmpgt_epi32_mask(m, ay1, _mm512_loadu_si512(&g.y0[i]));
+    m = _mm512_mask_cmpgt_epi32_mask(m, _mm512_loadu_si512(&g.z1[i]), az0);
+    m = _mm512_mask_cmpgt_epi32_mask(m, az1, _mm512_loadu_si512(&g.z0[i]));
+    if (m != 0) return true;
+  }
+  return any_hit_from(g, b, i);
+}
+
+// Appends the lanes set in `bits` (boxes i, i+1, ...) to the output.
+template <typename T>
+size_t emit_lanes(unsigned bits, size_t i, const T* xs, const T* zs, uint32_t* idx, T* ox, T* oz, size_t k) {
+  while (bits != 0) {
+    const int j = __builtin_ctz(bits);
+    bits &= bits - 1;
+    idx[k] = static_cast<uint32_t>(i + j);
+    ox[k] = xs[j];
+    oz[k] = zs[j];
+    ++k;
+  }
+  return k;
+}
+
+ENGINE_TARGET("avx2")
+size_t overlaps_avx2(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  const __m256d base = _mm256_set1_pd(b.y), tol = _mm256_set1_pd(1e-6), zero = _mm256_setzero_pd();
+  const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+  const __m256d ax0 = _mm256_set1_pd(b.x), ax1 = _mm256_set1_pd(b.x + b.w);
+  const __m256d az0 = _mm256_set1_pd(b.z), az1 = _mm256_set1_pd(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256d gap = _mm256_and_pd(_mm256_sub_pd(_mm256_loadu_pd(&g.y1[i]), base), abs_mask);
+    const __m256d x = _mm256_sub_pd(_mm256_min_pd(ax1, _mm256_loadu_pd(&g.x1[i])), _mm256_max_pd(ax0, _mm256_loadu_pd(&g.x0[i])));
+    const __m256d z = _mm256_sub_pd(_mm256_min_pd(az1, _mm256_loadu_pd(&g.z1[i])), _mm256_max_pd(az0, _mm256_loadu_pd(&g.z0[i])));
+    __m256d m = _mm256_cmp_pd(gap, tol, _CMP_LE_OQ);
+    m = _mm256_and_pd(m, _mm256_cmp_pd(x, zero, _CMP_GT_OQ));
+    m = _mm256_and_pd(m, _mm256_cmp_pd(z, zero, _CMP_GT_OQ));
+    const unsigned bits = static_cast<unsigned>(_mm256_movemask_pd(m));
+    if (bits == 0) continue;
+    alignas(32) double xs[4], zs[4];
+    _mm256_store_pd(xs, x);
+    _mm256_store_pd(zs, z);
+    k = emit_lanes(bits, i, xs, zs, idx, ox, oz, k);
+  }
+  return overlaps_from(g, b, idx, ox, oz, i, k);
+}
+
+ENGINE_TARGET("avx2")
+size_t overlaps_avx2(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  const __m256i base = _mm256_set1_epi32(b.y), zero = _mm256_setzero_si256();
+  const __m256i ax0 = _mm256_set1_epi32(b.x), ax1 = _mm256_set1_epi32(b.x + b.w);
+  const __m256i az0 = _mm256_set1_epi32(b.z), az1 = _mm256_set1_epi32(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i x = _mm256_sub_epi32(_mm256_min_epi32(ax1, load8(g.x1, i)), _mm256_max_epi32(ax0, load8(g.x0, i)));
+    const __m256i z = _mm256_sub_epi32(_mm256_min_epi32(az1, load8(g.z1, i)), _mm256_max_epi32(az0, load8(g.z0, i)));
+    __m256i m = _mm256_cmpeq_epi32(load8(g.y1, i), base);
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(x, zero));
+    m = _mm256_and_si256(m, _mm256_cmpgt_epi32(z, zero));
+    const unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+    if (bits == 0) continue;
+    alignas(32) int32_t xs[8], zs[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(xs), x);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(zs), z);
+    k = emit_lanes(bits, i, xs, zs, idx, ox, oz, k);
+  }
+  return overlaps_from(g, b, idx, ox, oz, i, k);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's AVX-512 min/max intrinsics start from _mm512_undefined_*(), which
+// -Wmaybe-uninitialized reports at every call.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+ENGINE_TARGET("avx512f")
+size_t overlaps_avx512(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  const __m512d base = _mm512_set1_pd(b.y), tol = _mm512_set1_pd(1e-6), zero = _mm512_setzero_pd();
+  const __m512d ax0 = _mm512_set1_pd(b.x), ax1 = _mm512_set1_pd(b.x + b.w);
+  const __m512d az0 = _mm512_set1_pd(b.z), az1 = _mm512_set1_pd(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m512d gap = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(&g.y1[i]), base));
+    const __m512d x = _mm512_sub_pd(_mm512_min_pd(ax1, _mm512_loadu_pd(&g.x1[i])), _mm512_max_pd(ax0, _mm512_loadu_pd(&g.x0[i])));
+    const __m512d z = _mm512_sub_pd(_mm512_min_pd(az1, _mm512_loadu_pd(&g.z1[i])), _mm512_max_pd(az0, _mm512_loadu_pd(&g.z0[i])));
+    __mmask8 m = _mm512_cmp_pd_mask(gap, tol, _CMP_LE_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, x, zero, _CMP_GT_OQ);
+    m = _mm512_mask_cmp_pd_mask(m, z, zero, _CMP_GT_OQ);
+    if (m == 0) continue;
+    alignas(64) double xs[8], zs[8];
+    _mm512_store_pd(xs, x);
+    _mm512_store_pd(zs, z);
+    k = emit_lanes(m, i, xs, zs, idx, ox, oz, k);
+  }
+  return overlaps_from(g, b, idx, ox, oz, i, k);
+}
+
+ENGINE_TARGET("avx512f")
+size_t overlaps_avx512(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  const __m512i base = _mm512_set1_epi32(b.y), zero = _mm512_setzero_si512();
+  const __m512i ax0 = _mm512_set1_epi32(b.x), ax1 = _mm512_set1_epi32(b.x + b.w);
+  const __m512i az0 = _mm512_set1_epi32(b.z), az1 = _mm512_set1_epi32(b.z + b.d);
+  const size_t n = g.size();
+  size_t i = 0;
+  size_t k = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i x = _mm512_sub_epi32(_mm512_min_epi32(ax1, _mm512_loadu_si512(&g.x1[i])), _mm512_max_epi32(ax0, _mm512_loadu_si512(&g.x0[i])));
+    const __m512i z = _mm512_sub_epi32(_mm512_min_epi32(az1, _mm512_loadu_si512(&g.z1[i])), _mm512_max_epi32(az0, _mm512_loadu_si512(&g.z0[i])));
+    __mmask16 m = _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(&g.y1[i]), base);
+    m = _mm512_mask_cmpgt_epi32_mask(m, x, zero);
+    m = _mm512_mask_cmpgt_epi32_mask(m, z, zero);
+    if (m == 0) continue;
+    alignas(64) int32_t xs[16], zs[16];
+    _mm512_store_si512(xs, x);
+    _mm512_store_si512(zs, z);
+    k = emit_lanes(m, i, xs, zs, idx, ox, oz, k);
+  }
+  return overlaps_from(g, b, idx, ox, oz, i, k);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+ENGINE_TARGET("default") bool any_hit(const PlacedGeometry<double>& g, const AABB& b) { return any_hit_scalar(g, b); }
+ENGINE_TARGET("avx2") bool any_hit(const PlacedGeometry<double>& g, const AABB& b) { return any_hit_avx2(g, b); }
+ENGINE_TARGET("avx512f") bool any_hit(const PlacedGeometry<double>& g, const AABB& b) { return any_hit_avx512(g, b); }
+
+ENGINE_TARGET("default") bool any_hit(const PlacedGeometry<int32_t>& g, const FixedAABB& b) { return any_hit_scalar(g, b); }
+ENGINE_TARGET("avx2") bool any_hit(const PlacedGeometry<int32_t>& g, const FixedAABB& b) { return any_hit_avx2(g, b); }
+ENGINE_TARGET("avx512f") bool any_hit(const PlacedGeometry<int32_t>& g, const FixedAABB& b) { return any_hit_avx512(g, b); }
+
+ENGINE_TARGET("default")
+size_t overlaps(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  return overlaps_scalar(g, b, idx, ox, oz);
+}
+ENGINE_TARGET("avx2")
+size_t overlaps(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  return overlaps_avx2(g, b, idx, ox, oz);
+}
+ENGINE_TARGET("avx512f")
+size_t overlaps(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  return overlaps_avx512(g, b, idx, ox, oz);
+}
+
+ENGINE_TARGET("default")
+size_t overlaps(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  return overlaps_scalar(g, b, idx, ox, oz);
+}
+ENGINE_TARGET("avx2")
+size_t overlaps(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  return overlaps_avx2(g, b, idx, ox, oz);
+}
+ENGINE_TARGET("avx512f")
+size_t overlaps(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  return overlaps_avx512(g, b, idx, ox, oz);
+}
+
+#else
+
+bool any_hit(const PlacedGeometry<double>& g, const AABB& b) { return any_hit_scalar(g, b); }
+bool any_hit(const PlacedGeometry<int32_t>& g, const FixedAABB& b) { return any_hit_scalar(g, b); }
+size_t overlaps(const PlacedGeometry<double>& g, const AABB& b, uint32_t* idx, double* ox, double* oz) {
+  return overlaps_scalar(g, b, idx, ox, oz);
+}
+size_t overlaps(const PlacedGeometry<int32_t>& g, const FixedAABB& b, uint32_t* idx, int32_t* ox, int32_t* oz) {
+  return overlaps_scalar(g, b, idx, ox, oz);
+}
+
+#endif
+
+}  // namespace
+
+bool any_intersects(const PlacedGeometry<double>& placed, const AABB& box) { return any_hit(placed, box); }
+
+bool any_intersects(const PlacedGeometry<int32_t>& placed, const FixedAABB& box) { return any_hit(placed, box); }
+
+size_t support_overlaps(const PlacedGeometry<double>& placed, const AABB& box, uint32_t* idx, double* ox, double* oz) {
+  return overlaps(placed, box, idx, ox, oz);
+}
+
+size_t support_overlaps(const PlacedGeometry<int32_t>& placed, const FixedAABB& box, uint32_t* idx, int32_t* ox,
+                        int32_t* oz) {
+  return overlaps(placed, box, idx, ox, oz);
+}
+
+std::vector<PlacedKernelSet> placed_kernel_sets() {
+  // Overloads need a cast to name the one a pointer takes.
+  using HitD = bool (*)(const PlacedGeometry<double>&, const AABB&);
+  using HitI = bool (*)(const PlacedGeometry<int32_t>&, const FixedAABB&);
+  using OverlapsD = size_t (*)(const PlacedGeometry<double>&, const AABB&, uint32_t*, double*, double*);
+  using OverlapsI = size_t (*)(const PlacedGeometry<int32_t>&, const FixedAABB&, uint32_t*, int32_t*, int32_t*);
+  std::vector<PlacedKernelSet> sets{{"scalar", HitD(any_hit_scalar), HitI(any_hit_scalar), OverlapsD(overlaps_scalar),
+                                     OverlapsI(overlaps_scalar)}};
+#ifdef ENGINE_PLACED_KERNELS_FMV
+  if (__builtin_cpu_supports("avx2")) {
+    sets.push_back({"avx2", HitD(any_hit_avx2), HitI(any_hit_avx2), OverlapsD(overlaps_avx2), OverlapsI(overlaps_avx2)});
+  }
+  if (__builtin_cpu_supports("avx512f")) {
+    sets.push_back(
+        {"avx512f", HitD(any_hit_avx512), HitI(any_hit_avx512), OverlapsD(overlaps_avx512), OverlapsI(overlaps_avx512)});
+  }
+#endif
+  return sets;
+}
+
+const char* placed_kernels_isa() {
+#ifdef ENGINE_PLACED_KERNELS_FMV
+  if (__builtin_cpu_supports("avx512f")) return "avx512f";
+  if (__builtin_cpu_supports("avx2")) return "avx2";
+#endif
+  return "scalar";
+}
+
+}  // namespace packing
+}  // namespace engine
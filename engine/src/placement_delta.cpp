@@ -0,0 +1,33 @@
+#include "placement_delta.h"
+
+#include <utility>
+
+namespace engine {
+
+namespace {
+
+bool same_pose(const Placement& a, const Placement& b) {
+  return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w && a.h == b.h && a.d == b.d;
+}
+
+}  // namespace
+
+PlacementDelta PlacementDiffer::update(const Result& r) {
+  PlacementDelta delta;
+  std::unordered_map<std::string, Placement> next;
+  next.reserve(r.placed.size());
+
+  for (const auto& p : r.placed) {
+    const auto it = last_.find(p.id);
+    if (it == last_.end() || !same_pose(it->second, p)) delta.upserts.push_back(p);
+    next.emplace(p.id, p);
+  }
+  for (const auto& kv : last_) {
+    if (next.find(kv.first) == next.end()) delta.removed.push_back(kv.first);
+  }
+
+  last_ = std::move(next);
+  return delta;
+}
+
+}  // namespace engine
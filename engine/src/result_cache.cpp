@@ -0,0 +1,207 @@
+#include "result_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "fnv_hash.h"
+#include "warm_start.h"
+#include "wire_format.h"
+
+namespace engine {
+
+namespace {
+
+size_t result_bytes(const Result& r) {
+  size_t bytes = sizeof(Result) + r.placed.capacity() * sizeof(Placement) + r.unplaced.capacity() * sizeof(std::string);
+  for (const auto& p : r.placed) {
+    if (p.id.capacity() > sizeof(std::string)) bytes += p.id.capacity();
+  }
+  for (const auto& id : r.unplaced) {
+    if (id.capacity() > sizeof(std::string)) bytes += id.capacity();
+  }
+  return bytes;
+}
+
+// Spill file header, ahead of the wire result: magic, u16 format, u16 reserved,
+// u32 plan version, u64 key.
+constexpr char kSpillMagic[4] = {'V', 'L', 'S', 'P'};
+constexpr uint16_t kSpillFormat = 1;
+
+std::string spill_path(const std::string& dir, uint64_t key) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "/%016llx.vlrs", static_cast<unsigned long long>(key));
+  return dir + name;
+}
+
+}  // namespace
+
+std::optional<uint64_t> ResultCache::key(const PreparedInstance& instance, const GaParams& params) {
+  if (params.warm_start) return std::nullopt;
+  uint64_t h = instance_hash(instance);
+  fnv_value(&h, params.population);
+  fnv_value(&h, params.generations);
+  fnv_value(&h, params.mutation_rate);
+  fnv_value(&h, params.seed);
+  fnv_value(&h, static_cast<int>(params.decoder));
+  fnv_value(&h, params.fixed_unit);
+  fnv_value(&h, static_cast<int>(params.physics.mode));
+  fnv_value(&h, params.physics.min_support);
+  fnv_value(&h, params.physics.max_stack_multiplier);
+  fnv_value(&h, params.physics.max_pressure);
+  fnv_value(&h, params.blocks);
+  fnv_value(&h, params.block_boxes);
+  fnv_value(&h, static_cast<int>(params.slab_mode));
+  fnv_value(&h, params.slab_boxes);
+  fnv_value(&h, params.local_search_elites);
+  fnv_value(&h, params.local_search_moves);
+  for (const auto& order : params.seed_orders) {
+    fnv_value(&h, order.size());
+    for (const auto& id : order) {
+      fnv_value(&h, id.size());
+      fnv(&h, id.data(), id.size());
+    }
+  }
+  return h;
+}
+
+std::shared_ptr<const Result> ResultCache::get(uint64_t key) {
+  std::string dir;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (capacity_bytes_ == 0) return nullptr;
+    const auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+      ++counts_.hits;
+      return it->second.result;
+    }
+    if (spill_dir_.empty()) {
+      ++counts_.misses;
+      return nullptr;
+    }
+    dir = spill_dir_;
+  }
+
+  // Disk reads happen outside the lock.
+  auto spilled = read_spilled(dir, key);
+  Evicted evicted;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (!spilled) {
+      ++counts_.misses;
+      return nullptr;
+    }
+    ++counts_.disk_hits;
+    if (!entries_.count(key)) insert(key, spilled, &evicted);
+  }
+  spill(dir, evicted);
+  return spilled;
+}
+
+void ResultCache::put(uint64_t key, const Result& result) {
+  auto shared = std::make_shared<const Result>(result);
+  Evicted evicted;
+  std::string dir;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (capacity_bytes_ == 0 || entries_.count(key)) return;
+    insert(key, std::move(shared), &evicted);
+    dir = spill_dir_;
+  }
+  spill(dir, evicted);
+}
+
+void ResultCache::configure(size_t capacity_bytes, std::string spill_dir) {
+  Evicted evicted;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    capacity_bytes_ = capacity_bytes;
+    spill_dir_ = std::move(spill_dir);
+    evict_to(capacity_bytes_, &evicted);
+  }
+  // Plans dropped by a shrink are not spilled: the operator asked for less.
+}
+
+ResultCache::Stats ResultCache::stats() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  Stats s = counts_;
+  s.entries = entries_.size();
+  s.bytes = bytes_;
+  s.capacity_bytes = capacity_bytes_;
+  return s;
+}
+
+void ResultCache::insert(uint64_t key, std::shared_ptr<const Result> result, Evicted* evicted) {
+  const size_t bytes = result_bytes(*result);
+  if (bytes > capacity_bytes_) return;
+  evict_to(capacity_bytes_ - bytes, evicted);
+  lru_.push_front(key);
+  entries_.emplace(key, Entry{std::move(result), bytes, lru_.begin()});
+  bytes_ += bytes;
+}
+
+void ResultCache::evict_to(size_t limit, Evicted* evicted) {
+  while (bytes_ > limit && !lru_.empty()) {
+    const auto it = entries_.find(lru_.back());
+    bytes_ -= it->second.bytes;
+    evicted->emplace_back(it->first, std::move(it->second.result));
+    entries_.erase(it);
+    lru_.pop_back();
+    ++counts_.evictions;
+  }
+}
+
+void ResultCache::spill(const std::string& dir, const Evicted& evicted) {
+  if (dir.empty() || evicted.empty()) return;
+  size_t written = 0;
+  for (const auto& [key, result] : evicted) {
+    // Written under a temporary name and renamed, so readers never see half a file.
+    const std::string path = spill_path(dir, key);
+    const std::string tmp = path + ".tmp";
+    wire::ByteWriter out;
+    out.bytes(kSpillMagic, sizeof(kSpillMagic));
+    out.put<uint16_t>(kSpillFormat);
+    out.put<uint16_t>(0);
+    out.put<uint32_t>(kPlanVersion);
+    out.put<uint64_t>(key);
+    const std::vector<uint8_t> plan = wire::encode_result(*result);
+    std::vector<uint8_t>& bytes = out.buffer();
+    bytes.insert(bytes.end(), plan.begin(), plan.end());
+    std::FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f) continue;
+    const bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    if (std::fclose(f) == 0 && ok && std::rename(tmp.c_str(), path.c_str()) == 0) {
+      ++written;
+    } else {
+      std::remove(tmp.c_str());
+    }
+  }
+  std::lock_guard<std::mutex> lock(mu_);
+  counts_.spilled += written;
+}
+
+std::shared_ptr<const Result> ResultCache::read_spilled(const std::string& dir, uint64_t key) const {
+  std::FILE* f = std::fopen(spill_path(dir, key).c_str(), "rb");
+  if (!f) return nullptr;
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[1 << 16];
+  size_t got;
+  while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + got);
+  std::fclose(f);
+  // A damaged file, or one another format, engine build or key wrote, is a miss.
+  try {
+    wire::ByteReader in(bytes.data(), bytes.size());
+    if (std::memcmp(in.take(sizeof(kSpillMagic)), kSpillMagic, sizeof(kSpillMagic)) != 0) return nullptr;
+    if (in.get<uint16_t>() != kSpillFormat) return nullptr;
+    in.get<uint16_t>();  // reserved
+    if (in.get<uint32_t>() != kPlanVersion || in.get<uint64_t>() != key) return nullptr;
+    return std::make_shared<const Result>(wire::decode_result(bytes.data() + in.pos(), bytes.size() - in.pos()));
+  } catch (const std::runtime_error&) {
+    return nullptr;
+  }
+}
+
+}  // namespace engine
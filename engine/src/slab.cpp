@@ -0,0 +1,273 @@
+#include "slab.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "packing_common.h"
+
+namespace engine {
+
+namespace {
+
+constexpr double kFitEps = 1e-9;
+// Share of a slab's volume the pre-pass fills; the packer rarely reaches 100%.
+constexpr double kSlabFill = 0.9;
+
+bool fits_extents(const Box& b, const Truck& t) {
+  std::array<double, 3> box{b.w, b.h, b.d};
+  std::array<double, 3> truck{t.w, t.h, t.d};
+  std::sort(box.begin(), box.end());
+  std::sort(truck.begin(), truck.end());
+  for (size_t i = 0; i < 3; ++i) {
+    if (box[i] > truck[i] + kFitEps) return false;
+  }
+  return true;
+}
+
+double used_depth(const Result& r) {
+  double d = 0;
+  for (const auto& p : r.placed) d = std::max(d, p.z + p.d);
+  return d;
+}
+
+}  // namespace
+
+bool use_slabs(const GaParams& params, const PreparedInstance& instance) {
+  const size_t boxes = instance.boxes.size();
+  switch (params.slab_mode) {
+    case SlabMode::kOff:
+      return false;
+    case SlabMode::kOn:
+      return boxes > 1;
+    case SlabMode::kAuto:
+      break;
+  }
+  // Slabs are packed as trucks of their own, blind to the load and stops in the others.
+  return boxes > kSlabAutoThreshold && !packing::has_balance_limits(instance.truck) && instance.stop_of.empty();
+}
+
+Result optimize_slabs(const PreparedInstance& inst, const GaParams& params) {
+  const Truck& truck = inst.truck;
+  const std::vector<Box>& boxes = inst.boxes;
+  const size_t n = boxes.size();
+
+  // Slabs must stay deep enough for every box in its thinnest orientation.
+  double thickest = 0;
+  for (const auto& b : boxes) thickest = std::max(thickest, std::min({b.w, b.h, b.d}));
+  const size_t per_slab = std::max<size_t>(params.slab_boxes, 2);
+  size_t slabs = (n + per_slab - 1) / per_slab;
+  if (thickest > 0) slabs = std::min(slabs, static_cast<size_t>(std::floor(truck.d / thickest)));
+  slabs = std::max<size_t>(slabs, 1);
+
+  const Truck slab_truck{truck.w, truck.h, truck.d / static_cast<double>(slabs), truck.max_weight};
+  const double slab_volume_cap = slab_truck.w * slab_truck.h * slab_truck.d * kSlabFill;
+
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (std::fabs(inst.volumes[a] - inst.volumes[b]) > 1e-12) return inst.volumes[a] > inst.volumes[b];
+    return boxes[a].priority > boxes[b].priority;
+  });
+
+  // Pre-pass: deal boxes in snake order so every slab gets a similar size mix, within the
+  // slab's volume and the truck's overall weight limit.
+  std::vector<std::vector<size_t>> members(slabs);
+  std::vector<double> slab_volume(slabs, 0.0);
+  std::vector<double> slab_weight(slabs, 0.0);
+  std::vector<size_t> leftover;
+  double assigned_weight = 0;
+  size_t turn = 0;
+  for (const size_t idx : order) {
+    const Box& b = boxes[idx];
+    if (!fits_extents(b, slab_truck) || assigned_weight + b.weight > truck.max_weight) {
+      leftover.push_back(idx);
+      continue;
+    }
+    bool placed = false;
+    for (size_t k = 0; k < slabs && !placed; ++k, ++turn) {
+      const size_t round = turn / slabs;
+      const size_t pos = turn % slabs;
+      const size_t s = (round % 2 == 0) ? pos : slabs - 1 - pos;
+      if (slab_volume[s] + inst.volumes[idx] > slab_volume_cap) continue;
+      members[s].push_back(idx);
+      slab_volume[s] += inst.volumes[idx];
+      slab_weight[s] += b.weight;
+      assigned_weight += b.weight;
+      placed = true;
+    }
+    if (!placed) leftover.push_back(idx);
+  }
+
+  // Per-slab effort matches what the GA already allows instances over 250 boxes, so the
+  // total stays proportional to the slab count.
+  GaParams sub = params;
+  sub.slab_mode = SlabMode::kOff;
+  sub.on_progress = nullptr;
+  sub.population = std::min(sub.population, 10);
+  sub.generations = std::min(sub.generations, 6);
+
+  std::vector<Result> results(slabs);
+
+  // Progress: one step per slab and one for the tail pass. Slabs finish in any order, so
+  // the reported plan is the run of finished slabs from the front, stitched as below; it
+  // only gains boxes. Reports are serialized and throttled like the GA's.
+  using Clock = std::chrono::steady_clock;
+  const int steps = static_cast<int>(slabs) + 1;
+  const double truck_volume = truck.w * truck.h * truck.d;
+  const auto interval = std::chrono::milliseconds(std::max(params.progress_interval_ms, 0));
+  std::mutex progress_mu;
+  std::vector<char> finished(slabs, 0);
+  int finished_count = 0;
+  size_t front = 0;
+  double front_offset = 0;
+  Result front_plan;
+  front_plan.total_volume = inst.total_volume;
+  Clock::time_point last_report{};
+  bool reported_once = false;
+  double reported_score = -std::numeric_limits<double>::infinity();
+  auto report = [&](int step, const Result& plan, size_t unplaced, bool force) {
+    const auto now = Clock::now();
+    if (!force && reported_once && now - last_report < interval) return;
+    last_report = now;
+    reported_once = true;
+    // Boxes of slabs not stitched yet count as unplaced.
+    const double score = score_result(plan) - 0.5 * static_cast<double>(unplaced - plan.unplaced.size());
+    const bool improved = score > reported_score;
+    if (improved) reported_score = score;
+    GaProgress g{step, steps, score, plan.utilization, plan.placed.size(), unplaced, improved, &plan};
+    g.local_search_gain = plan.local_search_gain;
+    g.local_search_ms = plan.local_search_ms;
+    params.on_progress(g);
+  };
+  auto slab_done = [&](size_t s) {
+    if (!params.on_progress) return;
+    std::lock_guard<std::mutex> lock(progress_mu);
+    finished[s] = 1;
+    ++finished_count;
+    for (; front < slabs && finished[front]; ++front) {
+      const Result& r = results[front];
+      for (auto p : r.placed) {
+        p.z += front_offset;
+        front_plan.placed.push_back(std::move(p));
+      }
+      front_offset += used_depth(r);
+      front_plan.used_volume += r.used_volume;
+      front_plan.total_weight += r.total_weight;
+      front_plan.local_search_gain += r.local_search_gain;
+      front_plan.local_search_ms += r.local_search_ms;
+    }
+    front_plan.utilization = truck_volume > 0 ? front_plan.used_volume / truck_volume : 0;
+    report(finished_count, front_plan, n - front_plan.placed.size(), false);
+  };
+
+  auto pack_slab = [&](size_t s) {
+    std::vector<Box> slab_boxes;
+    slab_boxes.reserve(members[s].size());
+    for (const size_t idx : members[s]) slab_boxes.push_back(boxes[idx]);
+    Truck t = slab_truck;
+    // The global limit was enforced by the pre-pass; the slack absorbs summation order.
+    t.max_weight = slab_weight[s] * (1.0 + 1e-9) + 1e-9;
+    GaParams p = sub;
+    p.seed = params.seed + static_cast<uint32_t>(s);
+    results[s] = optimize_ga(prepare_instance(t, std::move(slab_boxes)), p);
+    slab_done(s);
+  };
+  if (params.parallel_for) {
+    params.parallel_for(slabs, pack_slab);
+  } else {
+    for (size_t s = 0; s < slabs; ++s) pack_slab(s);
+  }
+
+  // Stitch: shift each slab forward by the depth the previous slabs really used.
+  Result out;
+  out.used_volume = 0;
+  out.total_volume = inst.total_volume;
+  out.total_weight = 0;
+  out.placed.reserve(n);
+  double offset = 0;
+  packing::LoadMoments moments;
+  std::vector<std::string> unplaced_ids;
+  for (size_t s = 0; s < slabs; ++s) {
+    Result& r = results[s];
+    for (auto p : r.placed) {
+      p.z += offset;
+      out.placed.push_back(std::move(p));
+    }
+    moments.add(r.total_weight, r.cog_x, r.cog_y, r.cog_z + offset);
+    offset += used_depth(r);
+    out.used_volume += r.used_volume;
+    out.total_weight += r.total_weight;
+    out.local_search_gain += r.local_search_gain;
+    out.local_search_ms += r.local_search_ms;
+    unplaced_ids.insert(unplaced_ids.end(), r.unplaced.begin(), r.unplaced.end());
+  }
+
+  // Tail pass: slab leftovers and boxes the pre-pass skipped, into the freed depth.
+  std::vector<size_t> tail_candidates = leftover;
+  {
+    std::unordered_map<std::string, std::vector<size_t>> by_id;
+    for (size_t s = 0; s < slabs; ++s) {
+      for (const size_t idx : members[s]) by_id[boxes[idx].id].push_back(idx);
+    }
+    for (const auto& id : unplaced_ids) {
+      auto& c = by_id[id];
+      if (c.empty()) continue;
+      tail_candidates.push_back(c.back());
+      c.pop_back();
+    }
+  }
+  std::stable_sort(tail_candidates.begin(), tail_candidates.end(),
+                   [&](size_t a, size_t b) { return inst.volumes[a] > inst.volumes[b]; });
+
+  const Truck tail_truck{truck.w, truck.h, truck.d - offset, truck.max_weight - out.total_weight};
+  std::vector<Box> tail_boxes;
+  std::vector<char> tried(n, 0);
+  const double tail_volume = tail_truck.w * tail_truck.h * std::max(tail_truck.d, 0.0);
+  double tail_assigned = 0;
+  const bool cancelled = params.cancel && params.cancel->load(std::memory_order_relaxed);
+  if (!cancelled && tail_truck.d > kFitEps && tail_truck.max_weight > 0) {
+    for (const size_t idx : tail_candidates) {
+      if (tail_boxes.size() >= per_slab) break;
+      if (!fits_extents(boxes[idx], tail_truck) || tail_assigned + inst.volumes[idx] > tail_volume) continue;
+      tail_boxes.push_back(boxes[idx]);
+      tail_assigned += inst.volumes[idx];
+      tried[idx] = 1;
+    }
+  }
+
+  std::vector<std::string> tail_unplaced;
+  if (!tail_boxes.empty()) {
+    GaParams p = sub;
+    p.seed = params.seed + static_cast<uint32_t>(slabs);
+    Result r = optimize_ga(prepare_instance(tail_truck, std::move(tail_boxes)), p);
+    for (auto pl : r.placed) {
+      pl.z += offset;
+      out.placed.push_back(std::move(pl));
+    }
+    moments.add(r.total_weight, r.cog_x, r.cog_y, r.cog_z + offset);
+    out.used_volume += r.used_volume;
+    out.total_weight += r.total_weight;
+    out.local_search_gain += r.local_search_gain;
+    out.local_search_ms += r.local_search_ms;
+    tail_unplaced = std::move(r.unplaced);
+  }
+  for (const size_t idx : tail_candidates) {
+    if (!tried[idx]) out.unplaced.push_back(boxes[idx].id);
+  }
+  out.unplaced.insert(out.unplaced.end(), tail_unplaced.begin(), tail_unplaced.end());
+
+  out.utilization = truck_volume > 0 ? out.used_volume / truck_volume : 0;
+  packing::report_balance(truck, moments, &out);
+  if (params.on_progress) report(steps, out, out.unplaced.size(), true);
+  return out;
+}
+
+}  // namespace engine
@@ -0,0 +1,118 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace engine {
+
+namespace {
+
+// Which pool (if any) the current thread works for, and its deque index.
+thread_local const WorkStealingPool* tl_pool = nullptr;
+thread_local size_t tl_index = 0;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threads) {
+  threads = std::max<size_t>(1, threads);
+  deques_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) deques_.push_back(std::make_unique<Deque>());
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) threads_.emplace_back([this, i] { worker_loop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mu_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+void WorkStealingPool::push(Task task) {
+  const size_t target =
+      tl_pool == this ? tl_index : next_deque_.fetch_add(1, std::memory_order_relaxed) % deques_.size();
+  // Counted before it is visible: a thief may take and uncount it the moment it is in
+  // the deque, and pending_ must not wrap below zero meanwhile.
+  {
+    std::lock_guard<std::mutex> lock(sleep_mu_);
+    pending_.fetch_add(1);
+  }
+  {
+    std::lock_guard<std::mutex> lock(deques_[target]->mu);
+    deques_[target]->tasks.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+bool WorkStealingPool::try_run_one() {
+  const size_t count = deques_.size();
+  const size_t self = tl_pool == this ? tl_index : 0;
+  Task task;
+  for (size_t k = 0; k < count && !task; ++k) {
+    Deque& d = *deques_[(self + k) % count];
+    std::lock_guard<std::mutex> lock(d.mu);
+    if (d.tasks.empty()) continue;
+    if (k == 0 && tl_pool == this) {
+      task = std::move(d.tasks.back());
+      d.tasks.pop_back();
+    } else {
+      task = std::move(d.tasks.front());
+      d.tasks.pop_front();
+    }
+  }
+  if (!task) return false;
+  pending_.fetch_sub(1);
+  task();
+  return true;
+}
+
+void WorkStealingPool::worker_loop(size_t index) {
+  tl_pool = this;
+  tl_index = index;
+  for (;;) {
+    if (try_run_one()) continue;
+    std::unique_lock<std::mutex> lock(sleep_mu_);
+    wake_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+    if (stopping_) return;
+  }
+}
+
+void WorkStealingPool::parallel_for(size_t n, const std::function<void(size_t)>& fn) {
+  if (n == 0) return;
+  if (n == 1) {
+    fn(0);
+    return;
+  }
+
+  struct Shared {
+    std::atomic<size_t> remaining;
+    std::mutex mu;
+    std::exception_ptr error;
+  };
+  auto shared = std::make_shared<Shared>();
+  shared->remaining.store(n);
+
+  auto run = [shared, &fn](size_t i) {
+    try {
+      fn(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(shared->mu);
+      if (!shared->error) shared->error = std::current_exception();
+    }
+    shared->remaining.fetch_sub(1, std::memory_order_acq_rel);
+  };
+
+  // Pushed in reverse so the owner, popping from the back, walks them in index order.
+  for (size_t i = n - 1; i >= 1; --i) push([run, i] { run(i); });
+  run(0);
+
+  while (shared->remaining.load(std::memory_order_acquire) != 0) {
+    if (!try_run_one()) std::this_thread::yield();
+  }
+  if (shared->error) std::rethrow_exception(shared->error);
+}
+
+}  // namespace engine
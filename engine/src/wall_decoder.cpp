@@ -0,0 +1,256 @@
+#include "decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+#include "drop_index.h"
+#include "packing_common.h"
+
+namespace engine {
+
+namespace {
+
+using namespace packing;
+
+// Wall-building: the truck is filled in vertical walls spanning its width and height,
+// front to back. The box that opens a wall sets its depth; later boxes go into the
+// first wall they fit, bottom-left on that wall's face. Each wall keeps a skyline of
+// its face (x-segments with their top height), so positions come from the segment
+// starts instead of a global candidate list.
+struct Segment {
+  double x;
+  double w;
+  double y;
+};
+
+struct Wall {
+  double z;
+  double depth;
+  std::vector<Segment> skyline;
+};
+
+template <typename Physics>
+class WallDecoder final : public Decoder {
+ public:
+  WallDecoder(const PreparedInstance& inst, const PhysicsModel& physics)
+      : inst_(inst), physics_(physics), balance_(inst) {
+    if (!inst_.stop_of.empty()) drops_.emplace();
+    reset();
+  }
+
+  void reset() override {
+    result_ = Result{};
+    result_.used_volume = 0;
+    result_.total_volume = inst_.total_volume;
+    result_.utilization = 0;
+    result_.total_weight = 0;
+    remaining_weight_ = inst_.truck.max_weight;
+    moments_ = LoadMoments{};
+    placed_.clear();
+    placed_.reserve(inst_.boxes.size());
+    placed_.set_floor(inst_.truck.w, inst_.truck.d);
+    walls_.clear();
+    if (drops_) drops_->set_depth(inst_.truck.d);
+  }
+
+  bool place(size_t idx) override {
+    const Truck& truck = inst_.truck;
+    const auto& box = inst_.boxes[idx];
+
+    if (box.weight > remaining_weight_ + 1e-9) {
+      result_.unplaced.push_back(box.id);
+      return false;
+    }
+
+    for (auto& wall : walls_) {
+      AABB best{};
+      if (fit_in_wall(wall, idx, &best)) {
+        commit(wall, best, idx);
+        return true;
+      }
+    }
+
+    // Nothing open takes it: start a new wall behind the last one. Its depth is the
+    // box's thinnest orientation, so the wall wastes as little length as possible.
+    const OrientationSet& rots = inst_.orientations[idx];
+    const double z = walls_.empty() ? 0.0 : walls_.back().z + walls_.back().depth;
+    bool found = false;
+    AABB best{};
+    for (uint8_t ri = 0; ri < rots.count; ++ri) {
+      const auto& r = rots.dims[ri];
+      const AABB candidate{0, 0, z, r[0], r[1], r[2]};
+      if (!inside_truck(truck, candidate) || !balanced(candidate, box.weight) || !reachable(candidate, idx)) continue;
+      if (!found || candidate.d < best.d || (candidate.d == best.d && candidate.h < best.h)) {
+        found = true;
+        best = candidate;
+      }
+    }
+    if (!found) {
+      result_.unplaced.push_back(box.id);
+      return false;
+    }
+    walls_.push_back(Wall{z, best.d, {Segment{0, truck.w, 0}}});
+    commit(walls_.back(), best, idx);
+    return true;
+  }
+
+  bool place_at(size_t idx, const Placement& at) override {
+    const Truck& truck = inst_.truck;
+    const auto& box = inst_.boxes[idx];
+    if (orientation_of(inst_.orientations[idx], at) == kNoOrientation || box.weight > remaining_weight_ + 1e-9) {
+      return false;
+    }
+    const AABB b{at.x, at.y, at.z, at.w, at.h, at.d};
+    if (!inside_truck(truck, shrunk(b)) || !balanced(b, box.weight) || !reachable(b, idx)) return false;
+    // Skylines only bound what is below them, so test against the boxes themselves.
+    if (any_intersects(placed_.geometry, shrunk(b))) return false;
+    if (!support_ok_and_apply_load(b, box.weight, placed_, nullptr, min_support_of(inst_, physics_, idx))) return false;
+
+    // Raise every wall the box reaches into, and cover what lies past the last one with a
+    // new wall, so later place() calls never fit a box through it.
+    const double end = walls_.empty() ? 0.0 : walls_.back().z + walls_.back().depth;
+    if (b.z + b.d > end + kEps) walls_.push_back(Wall{end, b.z + b.d - end, {Segment{0, truck.w, 0}}});
+    Wall* last = nullptr;
+    for (auto& wall : walls_) {
+      if (wall.z >= b.z + b.d - kEps || wall.z + wall.depth <= b.z + kEps) continue;
+      if (last) raise_skyline(last->skyline, b.x, b.w, b.y + b.h);
+      last = &wall;
+    }
+    commit(*last, b, idx);
+    return true;
+  }
+
+  const Result& result() const override { return result_; }
+  SupportGraph supports() const override {
+    if constexpr (!Physics::kSupport) return {};
+    return {&placed_.first_support, &placed_.supporters};
+  }
+  std::unique_ptr<Decoder> clone() const override { return std::make_unique<WallDecoder>(*this); }
+
+ private:
+  // Bottom-left position on the wall face. The winning candidate's loads are left
+  // applied to placed_.
+  bool fit_in_wall(const Wall& wall, size_t idx, AABB* out) {
+    const OrientationSet& rots = inst_.orientations[idx];
+    const double weight = inst_.boxes[idx].weight;
+    const double min_support = min_support_of(inst_, physics_, idx);
+    bool found = false;
+    AABB best{};
+    AppliedLoads best_loads;
+
+    for (uint8_t ri = 0; ri < rots.count; ++ri) {
+      const auto& r = rots.dims[ri];
+      if (r[2] > wall.depth + kEps) continue;
+
+      for (size_t s = 0; s < wall.skyline.size(); ++s) {
+        const double x = wall.skyline[s].x;
+        if (x + r[0] > inst_.truck.w + kEps) break;
+
+        // Resting height is the tallest segment under the footprint.
+        double y = 0;
+        for (size_t t = s; t < wall.skyline.size() && wall.skyline[t].x < x + r[0] - kEps; ++t) {
+          y = std::max(y, wall.skyline[t].y);
+        }
+        const AABB candidate{x, y, wall.z, r[0], r[1], r[2]};
+        if (!inside_truck(inst_.truck, candidate)) continue;
+        if (found && (best.y < y || (best.y == y && best.x <= x))) continue;
+        if (!balanced(candidate, weight) || !reachable(candidate, idx)) continue;
+
+        AppliedLoads applied;
+        if (!support_ok_and_apply_load(candidate, weight, placed_, &applied, min_support)) {
+          rollback_loads(placed_, applied);
+          continue;
+        }
+        if (found) rollback_loads(placed_, best_loads);
+        found = true;
+        best = candidate;
+        best_loads = std::move(applied);
+      }
+    }
+
+    if (found) *out = best;
+    return found;
+  }
+
+  bool balanced(const AABB& b, double weight) const {
+    return balance_.allows(moments_, weight, b.x + b.w / 2, b.z + b.d / 2);
+  }
+
+  bool reachable(const AABB& b, size_t idx) const {
+    return !drops_ || drops_->allows(b.x, b.y, b.z, b.w, b.h, b.d, inst_.stop_of[idx]);
+  }
+
+  void commit(Wall& wall, const AABB& b, size_t idx) {
+    const Box& box = inst_.boxes[idx];
+    placed_.add(b, max_load_of(inst_, physics_, idx, b.w * b.d));
+    if (drops_) drops_->add(b.x, b.y, b.z, b.w, b.h, b.d, inst_.stop_of[idx]);
+
+    result_.placed.push_back(Placement{box.id, b.x, b.y, b.z, b.w, b.h, b.d});
+    result_.used_volume += volume(b.w, b.h, b.d);
+    result_.total_weight += box.weight;
+    remaining_weight_ -= box.weight;
+    moments_.add(box.weight, b.x + b.w / 2, b.y + b.h / 2, b.z + b.d / 2);
+    report_balance(inst_.truck, moments_, &result_);
+    const double truck_volume = inst_.truck.w * inst_.truck.h * inst_.truck.d;
+    result_.utilization = truck_volume > 0 ? (result_.used_volume / truck_volume) : 0;
+
+    raise_skyline(wall.skyline, b.x, b.w, b.y + b.h);
+  }
+
+  static void raise_skyline(std::vector<Segment>& skyline, double x, double w, double top) {
+    const double x1 = x + w;
+    std::vector<Segment> next;
+    next.reserve(skyline.size() + 2);
+    bool inserted = false;
+    for (const auto& s : skyline) {
+      const double s1 = s.x + s.w;
+      if (s1 <= x + kEps || s.x >= x1 - kEps) {
+        if (!inserted && s.x >= x1 - kEps) {
+          next.push_back(Segment{x, w, top});
+          inserted = true;
+        }
+        next.push_back(s);
+        continue;
+      }
+      if (s.x < x - kEps) next.push_back(Segment{s.x, x - s.x, s.y});
+      if (!inserted) {
+        next.push_back(Segment{x, w, top});
+        inserted = true;
+      }
+      if (s1 > x1 + kEps) next.push_back(Segment{x1, s1 - x1, s.y});
+    }
+    if (!inserted) next.push_back(Segment{x, w, top});
+
+    // Merge neighbours at the same height so positions stay few.
+    skyline.clear();
+    for (const auto& s : next) {
+      if (!skyline.empty() && std::abs(skyline.back().y - s.y) <= 1e-9) {
+        skyline.back().w = s.x + s.w - skyline.back().x;
+      } else {
+        skyline.push_back(s);
+      }
+    }
+  }
+
+  const PreparedInstance& inst_;
+  const PhysicsModel physics_;
+  Result result_;
+  double remaining_weight_ = 0;
+  const BalanceLimits balance_;
+  LoadMoments moments_;
+  std::optional<DropIndex<double>> drops_;
+  PlacedBoxes<double, Physics> placed_;
+  std::vector<Wall> walls_;
+};
+
+}  // namespace
+
+std::unique_ptr<Decoder> make_wall_decoder(const PreparedInstance& instance, const PhysicsModel& physics) {
+  return with_physics(physics.mode, [&](auto policy) -> std::unique_ptr<Decoder> {
+    return std::make_unique<WallDecoder<decltype(policy)>>(instance, physics);
+  });
+}
+
+}  // namespace engine
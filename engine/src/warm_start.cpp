@@ -0,0 +1,175 @@
+#include "warm_start.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+
+#include "fnv_hash.h"
+
+namespace engine {
+
+namespace {
+
+// splitmix64 finaliser: spreads each box hash before they are summed.
+uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+std::vector<std::string> sorted_ids(const PreparedInstance& instance) {
+  std::vector<std::string> ids;
+  ids.reserve(instance.boxes.size());
+  for (const auto& b : instance.boxes) ids.push_back(b.id);
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// Sides, payload and balance limits: an order tuned under other axle or lateral limits
+// packs differently.
+bool same_truck(const Truck& a, const Truck& b) {
+  return a.w == b.w && a.h == b.h && a.d == b.d && a.max_weight == b.max_weight &&
+         a.front_axle_z == b.front_axle_z && a.rear_axle_z == b.rear_axle_z &&
+         a.front_axle_max == b.front_axle_max && a.rear_axle_max == b.rear_axle_max &&
+         a.max_lateral_offset == b.max_lateral_offset;
+}
+
+// Ids in both sorted lists, counting repeats.
+size_t shared_ids(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+  size_t shared = 0;
+  for (size_t i = 0, j = 0; i < a.size() && j < b.size();) {
+    const int c = a[i].compare(b[j]);
+    if (c == 0) {
+      ++shared;
+      ++i;
+      ++j;
+    } else if (c < 0) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return shared;
+}
+
+}  // namespace
+
+uint64_t instance_hash(const PreparedInstance& instance) {
+  // Summing mixed per-box hashes makes the result independent of box order.
+  uint64_t boxes = 0;
+  for (const Box& b : instance.boxes) {
+    uint64_t h = kFnvOffset;
+    fnv(&h, b.id.data(), b.id.size());
+    for (double v : {b.w, b.h, b.d, b.weight, b.max_load}) fnv_value(&h, v);
+    for (int v : {b.priority, static_cast<int>(b.orientations), static_cast<int>(b.fragile), b.drop}) fnv_value(&h, v);
+    boxes += mix(h);
+  }
+  const Truck& t = instance.truck;
+  uint64_t h = kFnvOffset;
+  for (double v : {t.w, t.h, t.d, t.max_weight, t.front_axle_z, t.rear_axle_z, t.front_axle_max, t.rear_axle_max,
+                   t.max_lateral_offset}) {
+    fnv_value(&h, v);
+  }
+  fnv_value(&h, instance.boxes.size());
+  fnv_value(&h, boxes);
+  return h;
+}
+
+bool packs_before(const PreparedInstance& instance, size_t a, size_t b) {
+  if (!instance.stop_of.empty() && instance.stop_of[a] != instance.stop_of[b]) {
+    return instance.stop_of[a] > instance.stop_of[b];
+  }
+  const double va = instance.volumes[a];
+  const double vb = instance.volumes[b];
+  if (std::fabs(va - vb) > 1e-12) return va > vb;
+  return instance.boxes[a].priority > instance.boxes[b].priority;
+}
+
+std::vector<std::string> plan_order(const Result& result) {
+  std::vector<std::string> ids;
+  ids.reserve(result.placed.size() + result.unplaced.size());
+  for (const auto& p : result.placed) ids.push_back(p.id);
+  ids.insert(ids.end(), result.unplaced.begin(), result.unplaced.end());
+  return ids;
+}
+
+std::vector<size_t> warm_order(const PreparedInstance& instance, const std::vector<std::string>& ids) {
+  const size_t n = instance.boxes.size();
+  // Boxes by id, last first so pop_back hands them out in instance order.
+  std::unordered_map<std::string, std::vector<size_t>> by_id;
+  by_id.reserve(n);
+  for (size_t i = n; i-- > 0;) by_id[instance.boxes[i].id].push_back(i);
+
+  std::vector<size_t> kept;
+  kept.reserve(n);
+  std::vector<char> seen(n, 0);
+  for (const auto& id : ids) {
+    const auto it = by_id.find(id);
+    if (it == by_id.end() || it->second.empty()) continue;
+    kept.push_back(it->second.back());
+    seen[it->second.back()] = 1;
+    it->second.pop_back();
+  }
+
+  std::vector<size_t> added;
+  for (size_t i = 0; i < n; ++i) {
+    if (!seen[i]) added.push_back(i);
+  }
+  if (added.empty()) return kept;
+  auto before = [&](size_t a, size_t b) { return packs_before(instance, a, b); };
+  std::stable_sort(added.begin(), added.end(), before);
+
+  std::vector<size_t> order;
+  order.reserve(n);
+  size_t next = 0;
+  for (size_t k : kept) {
+    while (next < added.size() && before(added[next], k)) order.push_back(added[next++]);
+    order.push_back(k);
+  }
+  order.insert(order.end(), added.begin() + static_cast<std::ptrdiff_t>(next), added.end());
+  return order;
+}
+
+std::vector<std::string> WarmStartCache::lookup(const PreparedInstance& instance) {
+  const uint64_t hash = instance_hash(instance);
+  const std::vector<std::string> ids = sorted_ids(instance);
+
+  std::lock_guard<std::mutex> lock(mu_);
+  auto best = entries_.end();
+  size_t best_shared = 0;
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->hash == hash && it->ids == ids) {
+      best = it;
+      break;
+    }
+    if (!same_truck(it->truck, instance.truck)) continue;
+    const size_t shared = shared_ids(it->ids, ids);
+    if (shared > best_shared) {
+      best = it;
+      best_shared = shared;
+    }
+  }
+  if (best == entries_.end()) return {};
+  if (best->hash != hash && 2 * best_shared < ids.size()) return {};
+  entries_.splice(entries_.begin(), entries_, best);
+  return best->order;
+}
+
+void WarmStartCache::store(const PreparedInstance& instance, const Result& result) {
+  Entry entry{instance_hash(instance), instance.truck, sorted_ids(instance), plan_order(result)};
+
+  std::lock_guard<std::mutex> lock(mu_);
+  if (capacity_ == 0) return;
+  entries_.remove_if([&](const Entry& e) { return e.hash == entry.hash && e.ids == entry.ids; });
+  entries_.push_front(std::move(entry));
+  while (entries_.size() > capacity_) entries_.pop_back();
+}
+
+size_t WarmStartCache::size() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  return entries_.size();
+}
+
+}  // namespace engine
@@ -0,0 +1,366 @@
+#include "wire_format.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace engine {
+namespace wire {
+
+namespace {
+
+size_t dtype_width(uint16_t dtype) {
+  switch (dtype) {
+    case kF64:
+      return sizeof(double);
+    case kI32:
+      return sizeof(int32_t);
+    default:
+      return 0;
+  }
+}
+
+void write_column_header(ByteWriter& out, uint16_t tag, uint16_t dtype, uint64_t byte_len) {
+  out.put<uint16_t>(tag);
+  out.put<uint16_t>(dtype);
+  out.put<uint32_t>(0);
+  out.put<uint64_t>(byte_len);
+}
+
+void write_metric(ByteWriter& out, const std::string& key, double value) {
+  out.put<uint16_t>(static_cast<uint16_t>(key.size()));
+  out.bytes(key.data(), key.size());
+  out.put<double>(value);
+}
+
+std::string read_string(ByteReader& in, size_t n) {
+  const uint8_t* p = in.take(n);
+  return std::string(reinterpret_cast<const char*>(p), n);
+}
+
+}  // namespace
+
+const Column* ColumnBlock::find(uint16_t tag, uint16_t dtype) const {
+  for (const auto& c : columns) {
+    if (c.tag == tag && c.dtype == dtype) return &c;
+  }
+  return nullptr;
+}
+
+double ColumnBlock::f64(const Column& c, size_t row) const {
+  double v;
+  std::memcpy(&v, c.data + row * sizeof(double), sizeof(double));
+  return v;
+}
+
+int32_t ColumnBlock::i32(const Column& c, size_t row) const {
+  int32_t v;
+  std::memcpy(&v, c.data + row * sizeof(int32_t), sizeof(int32_t));
+  return v;
+}
+
+std::string ColumnBlock::str(const Column& c, size_t row) const {
+  uint32_t lo;
+  uint32_t hi;
+  std::memcpy(&lo, c.data + row * sizeof(uint32_t), sizeof(uint32_t));
+  std::memcpy(&hi, c.data + (row + 1) * sizeof(uint32_t), sizeof(uint32_t));
+  const size_t base = (static_cast<size_t>(rows) + 1) * sizeof(uint32_t);
+  return std::string(reinterpret_cast<const char*>(c.data + base + lo), hi - lo);
+}
+
+void write_header(ByteWriter& out, const char magic[4]) {
+  out.bytes(magic, 4);
+  out.put<uint16_t>(kVersion);
+  out.put<uint16_t>(0);
+}
+
+void read_header(ByteReader& in, const char magic[4]) {
+  const uint8_t* m = in.take(4);
+  if (std::memcmp(m, magic, 4) != 0) throw std::runtime_error("wire: bad magic");
+  const auto version = in.get<uint16_t>();
+  if (version == 0 || version > kVersion) throw std::runtime_error("wire: unsupported version");
+  in.get<uint16_t>();  // flags, reserved
+}
+
+void begin_column_block(ByteWriter& out, uint32_t rows, uint32_t columns) {
+  out.pad_to(8);
+  out.put<uint32_t>(rows);
+  out.put<uint32_t>(columns);
+}
+
+void write_f64_column(ByteWriter& out, uint16_t tag, const std::vector<double>& values) {
+  write_column_header(out, tag, kF64, values.size() * sizeof(double));
+  out.bytes(values.data(), values.size() * sizeof(double));
+  out.pad_to(8);
+}
+
+void write_i32_column(ByteWriter& out, uint16_t tag, const std::vector<int32_t>& values) {
+  write_column_header(out, tag, kI32, values.size() * sizeof(int32_t));
+  out.bytes(values.data(), values.size() * sizeof(int32_t));
+  out.pad_to(8);
+}
+
+void write_strings_column(ByteWriter& out, uint16_t tag, const std::vector<std::string>& values) {
+  std::vector<uint32_t> offsets;
+  offsets.reserve(values.size() + 1);
+  uint32_t total = 0;
+  offsets.push_back(0);
+  for (const auto& v : values) {
+    total += static_cast<uint32_t>(v.size());
+    offsets.push_back(total);
+  }
+  write_column_header(out, tag, kStrings, offsets.size() * sizeof(uint32_t) + total);
+  out.bytes(offsets.data(), offsets.size() * sizeof(uint32_t));
+  for (const auto& v : values) out.bytes(v.data(), v.size());
+  out.pad_to(8);
+}
+
+ColumnBlock read_column_block(ByteReader& in) {
+  in.align_to(8);
+  ColumnBlock block;
+  block.rows = in.get<uint32_t>();
+  const auto count = in.get<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    Column c;
+    c.tag = in.get<uint16_t>();
+    c.dtype = in.get<uint16_t>();
+    in.get<uint32_t>();
+    c.byte_len = in.get<uint64_t>();
+    c.data = in.take(static_cast<size_t>(c.byte_len));
+    in.align_to(8);
+
+    const size_t width = dtype_width(c.dtype);
+    if (width != 0 && c.byte_len != static_cast<uint64_t>(block.rows) * width) {
+      throw std::runtime_error("wire: column length does not match row count");
+    }
+    if (c.dtype == kStrings) {
+      const uint64_t table = (static_cast<uint64_t>(block.rows) + 1) * sizeof(uint32_t);
+      if (c.byte_len < table) throw std::runtime_error("wire: truncated string table");
+      uint32_t prev = 0;
+      for (size_t r = 0; r <= block.rows; ++r) {
+        uint32_t off;
+        std::memcpy(&off, c.data + r * sizeof(uint32_t), sizeof(uint32_t));
+        if (off < prev || table + off > c.byte_len) throw std::runtime_error("wire: bad string offsets");
+        prev = off;
+      }
+    }
+    block.columns.push_back(c);
+  }
+  return block;
+}
+
+void write_box_columns(ByteWriter& out, const std::vector<Box>& boxes) {
+  const size_t n = boxes.size();
+  std::vector<std::string> ids(n);
+  std::vector<double> w(n), h(n), d(n), weight(n), max_load(n);
+  std::vector<int32_t> priority(n), orientations(n), fragile(n), drop(n);
+  bool restricted = false, limited = false, any_fragile = false, any_drop = false;
+  for (size_t i = 0; i < n; ++i) {
+    ids[i] = boxes[i].id;
+    w[i] = boxes[i].w;
+    h[i] = boxes[i].h;
+    d[i] = boxes[i].d;
+    weight[i] = boxes[i].weight;
+    priority[i] = boxes[i].priority;
+    orientations[i] = boxes[i].orientations;
+    restricted = restricted || boxes[i].orientations != kAnyOrientation;
+    max_load[i] = boxes[i].max_load;
+    limited = limited || boxes[i].max_load != 0;
+    fragile[i] = boxes[i].fragile ? 1 : 0;
+    any_fragile = any_fragile || boxes[i].fragile;
+    drop[i] = boxes[i].drop;
+    any_drop = any_drop || boxes[i].drop != 0;
+  }
+  begin_column_block(out, static_cast<uint32_t>(n), 6 + restricted + limited + any_fragile + any_drop);
+  write_strings_column(out, kColId, ids);
+  write_f64_column(out, kColW, w);
+  write_f64_column(out, kColH, h);
+  write_f64_column(out, kColD, d);
+  write_f64_column(out, kColWeight, weight);
+  write_i32_column(out, kColPriority, priority);
+  if (restricted) write_i32_column(out, kColOrientations, orientations);
+  if (limited) write_f64_column(out, kColMaxLoad, max_load);
+  if (any_fragile) write_i32_column(out, kColFragile, fragile);
+  if (any_drop) write_i32_column(out, kColDrop, drop);
+}
+
+std::vector<Box> boxes_from_columns(const ColumnBlock& block) {
+  const Column* ids = block.find(kColId, kStrings);
+  const Column* w = block.find(kColW, kF64);
+  const Column* h = block.find(kColH, kF64);
+  const Column* d = block.find(kColD, kF64);
+  if (!ids || !w || !h || !d) throw std::runtime_error("wire: box columns missing id/w/h/d");
+  const Column* weight = block.find(kColWeight, kF64);
+  const Column* priority = block.find(kColPriority, kI32);
+  const Column* orientations = block.find(kColOrientations, kI32);
+  const Column* max_load = block.find(kColMaxLoad, kF64);
+  const Column* fragile = block.find(kColFragile, kI32);
+  const Column* drop = block.find(kColDrop, kI32);
+
+  // Same defaults as the dict-based binding path.
+  std::vector<Box> boxes(block.rows);
+  for (size_t i = 0; i < block.rows; ++i) {
+    Box& b = boxes[i];
+    b.id = block.str(*ids, i);
+    b.w = block.f64(*w, i);
+    b.h = block.f64(*h, i);
+    b.d = block.f64(*d, i);
+    b.weight = weight ? block.f64(*weight, i) : 1.0;
+    b.priority = priority ? block.i32(*priority, i) : 1;
+    if (orientations) b.orientations = static_cast<uint8_t>(block.i32(*orientations, i) & kAnyOrientation);
+    if (max_load) b.max_load = std::max(0.0, block.f64(*max_load, i));
+    if (fragile) b.fragile = block.i32(*fragile, i) != 0;
+    if (drop) b.drop = std::max(0, block.i32(*drop, i));
+  }
+  return boxes;
+}
+
+std::vector<uint8_t> encode_request(const Request& req) {
+  ByteWriter out;
+  write_header(out, kRequestMagic);
+  out.put<double>(req.truck.w);
+  out.put<double>(req.truck.h);
+  out.put<double>(req.truck.d);
+  out.put<double>(req.truck.max_weight);
+  write_box_columns(out, req.boxes);
+
+  out.put<uint32_t>(static_cast<uint32_t>(req.params.size()));
+  for (const auto& p : req.params) {
+    out.put<uint16_t>(static_cast<uint16_t>(p.key.size()));
+    out.put<uint8_t>(p.type);
+    out.put<uint8_t>(0);
+    out.bytes(p.key.data(), p.key.size());
+    if (p.type == kParamString) {
+      out.put<uint32_t>(static_cast<uint32_t>(p.text.size()));
+      out.bytes(p.text.data(), p.text.size());
+    } else {
+      out.put<double>(p.number);
+    }
+  }
+  return std::move(out.buffer());
+}
+
+Request decode_request(const uint8_t* data, size_t size) {
+  ByteReader in(data, size);
+  read_header(in, kRequestMagic);
+
+  Request req;
+  req.truck.w = in.get<double>();
+  req.truck.h = in.get<double>();
+  req.truck.d = in.get<double>();
+  req.truck.max_weight = in.get<double>();
+  req.boxes = boxes_from_columns(read_column_block(in));
+
+  const auto count = in.get<uint32_t>();
+  req.params.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    Param p;
+    const auto key_len = in.get<uint16_t>();
+    p.type = static_cast<ParamType>(in.get<uint8_t>());
+    in.get<uint8_t>();
+    p.key = read_string(in, key_len);
+    p.number = 0.0;
+    if (p.type == kParamNumber) {
+      p.number = in.get<double>();
+    } else if (p.type == kParamString) {
+      p.text = read_string(in, in.get<uint32_t>());
+    } else {
+      throw std::runtime_error("wire: unknown param type");
+    }
+    req.params.push_back(std::move(p));
+  }
+  return req;
+}
+
+std::vector<uint8_t> encode_result(const Result& r) {
+  ByteWriter out;
+  write_header(out, kResultMagic);
+
+  const size_t n = r.placed.size();
+  std::vector<std::string> ids(n);
+  std::vector<double> x(n), y(n), z(n), w(n), h(n), d(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto& p = r.placed[i];
+    ids[i] = p.id;
+    x[i] = p.x;
+    y[i] = p.y;
+    z[i] = p.z;
+    w[i] = p.w;
+    h[i] = p.h;
+    d[i] = p.d;
+  }
+  begin_column_block(out, static_cast<uint32_t>(n), 7);
+  write_strings_column(out, kColId, ids);
+  write_f64_column(out, kColX, x);
+  write_f64_column(out, kColY, y);
+  write_f64_column(out, kColZ, z);
+  write_f64_column(out, kColW, w);
+  write_f64_column(out, kColH, h);
+  write_f64_column(out, kColD, d);
+
+  begin_column_block(out, static_cast<uint32_t>(r.unplaced.size()), 1);
+  write_strings_column(out, kColId, r.unplaced);
+
+  // Local-search stats only when the run had a memetic step; older readers skip unknown keys.
+  const bool local_search = r.local_search_ms > 0;
+  out.put<uint32_t>(local_search ? 11 : 9);
+  write_metric(out, "used_volume", r.used_volume);
+  write_metric(out, "total_volume", r.total_volume);
+  write_metric(out, "utilization", r.utilization);
+  write_metric(out, "total_weight", r.total_weight);
+  write_metric(out, "cog_x", r.cog_x);
+  write_metric(out, "cog_y", r.cog_y);
+  write_metric(out, "cog_z", r.cog_z);
+  write_metric(out, "front_axle_load", r.front_axle_load);
+  write_metric(out, "rear_axle_load", r.rear_axle_load);
+  if (local_search) {
+    write_metric(out, "local_search_gain", r.local_search_gain);
+    write_metric(out, "local_search_ms", r.local_search_ms);
+  }
+  return std::move(out.buffer());
+}
+
+Result decode_result(const uint8_t* data, size_t size) {
+  ByteReader in(data, size);
+  read_header(in, kResultMagic);
+
+  Result r{};
+  const ColumnBlock placed = read_column_block(in);
+  const Column* ids = placed.find(kColId, kStrings);
+  const Column* cols[6] = {placed.find(kColX, kF64), placed.find(kColY, kF64), placed.find(kColZ, kF64),
+                           placed.find(kColW, kF64), placed.find(kColH, kF64), placed.find(kColD, kF64)};
+  for (const Column* c : cols) {
+    if (!c || !ids) throw std::runtime_error("wire: placement columns missing");
+  }
+  r.placed.reserve(placed.rows);
+  for (size_t i = 0; i < placed.rows; ++i) {
+    r.placed.push_back(Placement{placed.str(*ids, i), placed.f64(*cols[0], i), placed.f64(*cols[1], i),
+                                 placed.f64(*cols[2], i), placed.f64(*cols[3], i), placed.f64(*cols[4], i),
+                                 placed.f64(*cols[5], i)});
+  }
+
+  const ColumnBlock unplaced = read_column_block(in);
+  if (const Column* u = unplaced.find(kColId, kStrings)) {
+    for (size_t i = 0; i < unplaced.rows; ++i) r.unplaced.push_back(unplaced.str(*u, i));
+  }
+
+  const auto count = in.get<uint32_t>();
+  for (uint32_t i = 0; i < count; ++i) {
+    const std::string key = read_string(in, in.get<uint16_t>());
+    const double value = in.get<double>();
+    if (key == "used_volume") r.used_volume = value;
+    else if (key == "total_volume") r.total_volume = value;
+    else if (key == "utilization") r.utilization = value;
+    else if (key == "total_weight") r.total_weight = value;
+    else if (key == "cog_x") r.cog_x = value;
+    else if (key == "cog_y") r.cog_y = value;
+    else if (key == "cog_z") r.cog_z = value;
+    else if (key == "front_axle_load") r.front_axle_load = value;
+    else if (key == "rear_axle_load") r.rear_axle_load = value;
+    else if (key == "local_search_gain") r.local_search_gain = value;
+    else if (key == "local_search_ms") r.local_search_ms = value;
+  }
+  return r;
+}
+
+}  // namespace wire
+}  // namespace engine
@@ -0,0 +1,115 @@
+// Block-building on a repetitive manifest that overflows the truck, where blocks leave
+// gaps single boxes would fill: the short single-box run after the blocks may only improve
+// on the expanded plan and must stay within a tenth of the boxes blocks off places, and
+// expanding a block plan accounts for every box.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "blocks.h"
+#include "optimizer.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+// Every box once, none overlapping.
+void check_plan(const engine::Result& r, const std::vector<engine::Box>& boxes, const std::string& label) {
+  std::vector<std::string> ids;
+  for (const auto& pl : r.placed) ids.push_back(pl.id);
+  ids.insert(ids.end(), r.unplaced.begin(), r.unplaced.end());
+  std::sort(ids.begin(), ids.end());
+  std::vector<std::string> want;
+  for (const auto& b : boxes) want.push_back(b.id);
+  std::sort(want.begin(), want.end());
+  check(ids == want, label + ": boxes lost or duplicated");
+  for (size_t i = 0; i < r.placed.size(); ++i) {
+    for (size_t j = i + 1; j < r.placed.size(); ++j) {
+      check(!overlap(r.placed[i], r.placed[j]), label + ": " + r.placed[i].id + " overlaps " + r.placed[j].id);
+    }
+  }
+}
+
+// A narrow, long truck makes blocks run along the depth; turned, they would be wider
+// than the truck, so they must not be offered turned.
+void check_yaw_fits() {
+  std::vector<engine::Box> boxes;
+  for (int k = 0; k < 8; ++k) {
+    engine::Box b{"C" + std::to_string(k), 0.5, 0.5, 0.5, 5, 1};
+    b.orientations = engine::kAnyOrientation;
+    boxes.push_back(b);
+  }
+  const engine::Truck truck{1.0, 0.5, 4.0, 1000};
+  const engine::BlockedInstance blocked =
+      engine::build_blocks(engine::prepare_instance(truck, boxes), 8, engine::PhysicsModel{});
+  check(blocked.grouped > 0, "narrow truck: no blocks built");
+  for (size_t k = 0; k < blocked.blocks.size(); ++k) {
+    const engine::OrientationSet& rots = blocked.instance.orientations[k];
+    for (uint8_t r = 0; r < rots.count; ++r) {
+      check(rots.dims[r][0] <= truck.w + 1e-9 && rots.dims[r][2] <= truck.d + 1e-9,
+            "narrow truck: block " + std::to_string(k) + " offered " + std::to_string(rots.dims[r][0]) + " wide");
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  check_yaw_fits();
+
+  // Five SKUs of forty boxes each.
+  std::mt19937 rng(4);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<engine::Box> boxes;
+  for (int s = 0; s < 5; ++s) {
+    const double w = 0.2 + 0.4 * u(rng), h = 0.15 + 0.35 * u(rng), d = 0.2 + 0.4 * u(rng), kg = 2 + 20 * u(rng);
+    for (int k = 0; k < 40; ++k) {
+      boxes.push_back(engine::Box{"S" + std::to_string(s) + "_" + std::to_string(k), w, h, d, kg, 1});
+    }
+  }
+  const engine::Truck truck{2.4, 2.6, 2.0, 24000};
+  const auto inst = engine::prepare_instance(truck, boxes);
+
+  const engine::PhysicsModel physics;
+  const engine::BlockedInstance blocked = engine::build_blocks(inst, 8, physics);
+  check(blocked.grouped > 0, "no blocks built");
+  for (size_t k = 0; k < blocked.blocks.size(); ++k) {
+    if (blocked.blocks[k].members.size() < 2) continue;
+    check(blocked.instance.rules[k].min_support < 1.0, "block " + std::to_string(k) + " needs its whole base");
+  }
+
+  const struct {
+    const char* name;
+    engine::DecoderKind kind;
+  } kinds[] = {{"extreme_points", engine::DecoderKind::kExtremePoints},
+               {"wall", engine::DecoderKind::kWallBuilding},
+               {"ems", engine::DecoderKind::kEmptySpaces}};
+  for (const auto& k : kinds) {
+    engine::GaParams p;
+    p.population = 12;
+    p.generations = 6;
+    p.seed = 1;
+    p.decoder = k.kind;
+    p.slab_mode = engine::SlabMode::kOff;
+    const std::string label = k.name;
+
+    // Expanding a plan made on the blocks, units that fail included.
+    const engine::Result packed = engine::optimize_ga(blocked.instance, p);
+    const engine::Result expanded = engine::expand_blocks(blocked, inst, packed, p.decoder, p.physics);
+    check_plan(expanded, boxes, label + " expanded");
+
+    const engine::Result off = engine::optimize_ga(inst, p);
+    p.blocks = true;
+    const engine::Result on = engine::optimize_ga(inst, p);
+    check_plan(on, boxes, label + " blocks");
+    check(on.placed.size() + boxes.size() / 10 >= off.placed.size(),
+          label + ": blocks placed " + std::to_string(on.placed.size()) + " boxes, single boxes " +
+              std::to_string(off.placed.size()));
+    check(engine::score_result(on) >= engine::score_result(expanded) - 1e-9, label + ": blocks scored below their expanded plan");
+  }
+
+  return finish("blocks");
+}
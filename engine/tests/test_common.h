@@ -0,0 +1,57 @@
+#pragma once
+
+// What the native tests share: check() records a failure and carries on, finish() turns
+// the count into main's exit status, and a few plan helpers.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "engine_types.h"
+
+namespace engine_test {
+
+inline int failures = 0;
+
+inline void check(bool ok, const std::string& what) {
+  if (ok) return;
+  std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+  ++failures;
+}
+
+// 1 after any failed check; otherwise prints "<name>: ok" and returns 0.
+inline int finish(const char* name) {
+  if (failures) return 1;
+  std::printf("%s: ok\n", name);
+  return 0;
+}
+
+// Whether two placements share volume; touching faces do not.
+inline bool overlap(const engine::Placement& a, const engine::Placement& b) {
+  constexpr double e = 1e-6;
+  return a.x + e < b.x + b.w && b.x + e < a.x + a.w && a.y + e < b.y + b.h && b.y + e < a.y + a.h &&
+         a.z + e < b.z + b.d && b.z + e < a.z + a.d;
+}
+
+// Mixed SKUs: a third of the boxes repeat the previous one, like real manifests. The
+// decoder benchmark packs the same ones.
+inline std::vector<engine::Box> make_boxes(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<engine::Box> boxes;
+  boxes.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 3 == 2) {
+      boxes.push_back(boxes.back());
+    } else {
+      boxes.push_back(engine::Box{"", 0.2 + 0.5 * u(rng), 0.15 + 0.45 * u(rng), 0.2 + 0.6 * u(rng), 2 + 38 * u(rng),
+                                  1 + static_cast<int>(5 * u(rng))});
+    }
+    boxes.back().id = "B" + std::to_string(i);
+  }
+  return boxes;
+}
+
+}  // namespace engine_test
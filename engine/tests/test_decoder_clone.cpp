@@ -0,0 +1,74 @@
+// A decoder cloned mid-order must carry on exactly like the original: both copies place
+// the rest of the order and must end with the same plan as an uninterrupted decode, with
+// the source destroyed first so nothing in the clone may point back into it.
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "decoder.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+bool same_plan(const engine::Result& a, const engine::Result& b) {
+  if (a.placed.size() != b.placed.size() || a.unplaced != b.unplaced) return false;
+  for (size_t i = 0; i < a.placed.size(); ++i) {
+    const auto& p = a.placed[i];
+    const auto& q = b.placed[i];
+    if (p.id != q.id || p.x != q.x || p.y != q.y || p.z != q.z || p.w != q.w || p.h != q.h || p.d != q.d) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  const struct {
+    const char* name;
+    engine::DecoderKind kind;
+  } kinds[] = {{"extreme_points", engine::DecoderKind::kExtremePoints},
+               {"wall", engine::DecoderKind::kWallBuilding},
+               {"ems", engine::DecoderKind::kEmptySpaces}};
+  const engine::PhysicsMode modes[] = {engine::PhysicsMode::kFull, engine::PhysicsMode::kSupportOnly,
+                                       engine::PhysicsMode::kNone};
+
+  // More boxes than fit, so the tail also exercises failed placements.
+  const auto inst = engine::prepare_instance(engine::Truck{2.4, 2.6, 2.0, 12000}, make_boxes(120, 7));
+  std::vector<size_t> order(inst.boxes.size());
+  for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::shuffle(order.begin(), order.end(), std::mt19937(11));
+
+  for (const auto& k : kinds) {
+    for (const auto mode : modes) {
+      engine::PhysicsModel physics;
+      physics.mode = mode;
+      const std::string label = std::string(k.name) + "/mode " + std::to_string(static_cast<int>(mode));
+      const engine::Result whole = engine::decode_order(inst, k.kind, order, physics);
+      check(!whole.unplaced.empty(), label + ": the truck should overflow");
+
+      for (size_t cut : {size_t{1}, order.size() / 3, order.size() / 2, order.size() - 1}) {
+        auto source = engine::make_decoder(inst, k.kind, physics);
+        for (size_t p = 0; p < cut; ++p) source->place(order[p]);
+        auto copy = source->clone();
+        auto second = copy->clone();
+
+        for (size_t p = cut; p < order.size(); ++p) source->place(order[p]);
+        check(same_plan(source->result(), whole), label + ": source diverged after clone at " + std::to_string(cut));
+        source.reset();
+
+        for (size_t p = cut; p < order.size(); ++p) copy->place(order[p]);
+        check(same_plan(copy->result(), whole), label + ": clone diverged at " + std::to_string(cut));
+        copy.reset();
+
+        for (size_t p = cut; p < order.size(); ++p) second->place(order[p]);
+        check(same_plan(second->result(), whole), label + ": clone of clone diverged at " + std::to_string(cut));
+      }
+    }
+  }
+
+  return finish("decoder clone");
+}
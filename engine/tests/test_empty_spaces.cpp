@@ -0,0 +1,44 @@
+// The empty-space decoder off the floor: a space's near-bottom-left corner may hang in the
+// air past the box its floor rests on, and the box must then go flush with that box
+// instead of being left out.
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "decoder.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+bool near(double a, double b) { return std::fabs(a - b) <= 1e-9; }
+
+}  // namespace
+
+int main() {
+  // T, low, on the left half and P, taller, on the right. The only space C fits is the
+  // one over both, from P's top; its corner at x = 0 is over T's lower top, so C must
+  // slide right until 0.5 of its 0.55 rests on P.
+  std::vector<engine::Box> boxes = {engine::Box{"T", 0.5, 0.3, 1.0, 5, 1}, engine::Box{"P", 0.5, 0.5, 1.0, 5, 1},
+                                    engine::Box{"C", 0.55, 0.2, 1.0, 5, 1}};
+  for (auto& b : boxes) b.orientations = 0x01;
+  const auto inst = engine::prepare_instance(engine::Truck{1.0, 1.0, 1.0, 1000}, boxes);
+
+  for (const auto mode : {engine::PhysicsMode::kFull, engine::PhysicsMode::kSupportOnly}) {
+    engine::PhysicsModel physics;
+    physics.mode = mode;
+    const std::string label = "mode " + std::to_string(static_cast<int>(mode));
+    const engine::Result r = engine::decode_order(inst, engine::DecoderKind::kEmptySpaces, {0, 1, 2}, physics);
+    check(r.unplaced.empty(), label + ": a box was left out");
+    if (r.placed.size() != 3) continue;
+    const engine::Placement& p = r.placed[1];
+    const engine::Placement& c = r.placed[2];
+    check(near(p.x, 0.5) && near(p.y, 0) && near(p.z, 0), label + ": P not beside T");
+    check(near(c.x, 0.45) && near(c.y, 0.5) && near(c.z, 0),
+          label + ": C at (" + std::to_string(c.x) + ", " + std::to_string(c.y) + ", " + std::to_string(c.z) + ")");
+  }
+
+  return finish("empty spaces");
+}
@@ -0,0 +1,125 @@
+// Extreme-point pruning by free runs and by the sides of the boxes still to come: points
+// and rotations too tight for the current box are skipped, points too tight for every box
+// left are dropped, and neither may cost a position the decoder would otherwise find.
+// Checked on the plans of small trucks whose right answer is known, in metres and on the
+// millimetre grid.
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "decoder.h"
+#include "packing_common.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+engine::Box box(const std::string& id, double w, double h, double d, uint8_t orientations = 0x01) {
+  engine::Box b{id, w, h, d, 5, 1};
+  b.orientations = orientations;
+  return b;
+}
+
+bool near(double a, double b) { return std::fabs(a - b) <= 1e-6; }
+
+struct Want {
+  std::string id;
+  double x, y, z, w, h, d;
+};
+
+// Decodes the boxes in order on both extreme-point decoders and checks the plan.
+void check_plan(const std::string& name, const engine::Truck& truck, const std::vector<engine::Box>& boxes,
+                const std::vector<Want>& placed, const std::vector<std::string>& unplaced) {
+  const auto inst = engine::prepare_instance(truck, boxes);
+  const engine::FixedGeometry grid = engine::make_fixed_geometry(inst, 0.001);
+  // Crush limits would only add reasons to refuse a point.
+  engine::PhysicsModel physics;
+  physics.mode = engine::PhysicsMode::kSupportOnly;
+  const struct {
+    const char* lengths;
+    std::unique_ptr<engine::Decoder> decoder;
+  } runs[] = {{"metres", engine::make_extreme_point_decoder(inst, physics)},
+              {"millimetres", engine::make_fixed_point_decoder(inst, grid, physics)}};
+  for (const auto& run : runs) {
+    const std::string label = name + " (" + run.lengths + ")";
+    for (size_t i = 0; i < boxes.size(); ++i) run.decoder->place(i);
+    const engine::Result& r = run.decoder->result();
+    check(r.unplaced == unplaced, label + ": wrong boxes left out");
+    check(r.placed.size() == placed.size(), label + ": wrong number of boxes placed");
+    for (size_t i = 0; i < std::min(r.placed.size(), placed.size()); ++i) {
+      const engine::Placement& p = r.placed[i];
+      const Want& q = placed[i];
+      check(p.id == q.id && near(p.x, q.x) && near(p.y, q.y) && near(p.z, q.z) && near(p.w, q.w) &&
+                near(p.h, q.h) && near(p.d, q.d),
+            label + ": " + p.id + " at (" + std::to_string(p.x) + ", " + std::to_string(p.y) + ", " +
+                std::to_string(p.z) + ") size " + std::to_string(p.w) + "x" + std::to_string(p.h) + "x" +
+                std::to_string(p.d) + ", want " + q.id);
+    }
+  }
+}
+
+void check_remaining_sides() {
+  const engine::Truck truck{2.0, 2.0, 2.0, 1000};
+  const auto inst = engine::prepare_instance(
+      truck, {box("a", 0.4, 0.9, 0.5), box("b", 0.2, 0.3, 0.6), box("c", 0.7, 0.2, 0.8), box("d", 0.9, 0.6, 0.5)});
+  engine::packing::RemainingSides sides;
+  sides.reset(inst);
+  check(sides.smallest() == 0.2, "smallest side of all four should be 0.2");
+  sides.take(inst.boxes[1]);
+  check(sides.smallest() == 0.2, "c still has a 0.2 side");
+  sides.take(inst.boxes[2]);
+  check(sides.smallest() == 0.4, "after b and c the smallest side is a's 0.4");
+  sides.take(inst.boxes[0]);
+  sides.take(inst.boxes[3]);
+  check(sides.smallest() == std::numeric_limits<double>::infinity(), "nothing left should need an endless run");
+}
+
+}  // namespace
+
+int main() {
+  check_remaining_sides();
+
+  const engine::Truck cube{1.0, 1.0, 1.0, 1000};
+
+  // A and B on it leave a slot 0.15 deep at the back. C is too big for it, and points whose
+  // runs are shorter than C's sides are skipped, but D and E are still to come, so the
+  // slot's points must survive C and take them.
+  check_plan("slot kept for smaller boxes", cube,
+             {box("A", 1.0, 0.5, 0.85), box("B", 1.0, 0.5, 0.85), box("C", 0.3, 0.3, 0.3), box("D", 0.1, 0.1, 0.1),
+              box("E", 0.12, 0.12, 0.12)},
+             {{"A", 0, 0, 0, 1.0, 0.5, 0.85},
+              {"B", 0, 0.5, 0, 1.0, 0.5, 0.85},
+              {"D", 0, 0, 0.85, 0.1, 0.1, 0.1},
+              {"E", 0.1, 0, 0.85, 0.12, 0.12, 0.12}},
+             {"C"});
+
+  // The point beside A has a 0.4 run along x. B's first rotation is 0.5 wide and is
+  // skipped there, but an upright one fits the runs and takes the point.
+  check_plan("rotation fitted to the runs", cube,
+             {box("A", 0.6, 1.0, 1.0), box("B", 0.5, 0.2, 0.2, engine::kAnyOrientation)},
+             {{"A", 0, 0, 0, 0.6, 1.0, 1.0}, {"B", 0.6, 0, 0, 0.2, 0.5, 0.2}}, {});
+
+  // A fills the truck: no point is left, and everything after it is unplaced in order,
+  // the small box included.
+  check_plan("no points left", cube,
+             {box("A", 1.0, 1.0, 1.0), box("B", 0.5, 0.5, 0.5), box("C", 0.01, 0.01, 0.01)},
+             {{"A", 0, 0, 0, 1.0, 1.0, 1.0}}, {"B", "C"});
+
+  // A runs to the ceiling and leaves 0.3 along x. Only B's 0.25 side fits that run, so
+  // it stands with that side across, and C, 0.35 on every side, finds nothing.
+  check_plan("runs bounded by the walls", cube,
+             {box("A", 0.7, 1.0, 1.0), box("C", 0.35, 0.35, 0.35), box("B", 0.6, 0.25, 0.9, engine::kAnyOrientation)},
+             {{"A", 0, 0, 0, 0.7, 1.0, 1.0}, {"B", 0.7, 0, 0, 0.25, 0.6, 0.9}}, {"C"});
+
+  // B, taller than A beside it, ends the x run from A's top at exactly C's width: C fits
+  // that run with nothing to spare and must still go on A.
+  check_plan("runs bounded by a box", cube,
+             {box("A", 0.5, 0.5, 1.0), box("B", 0.5, 1.0, 1.0), box("C", 0.5, 0.5, 1.0)},
+             {{"A", 0, 0, 0, 0.5, 0.5, 1.0}, {"B", 0.5, 0, 0, 0.5, 1.0, 1.0}, {"C", 0, 0.5, 0, 0.5, 0.5, 1.0}}, {});
+
+  return finish("extreme points");
+}
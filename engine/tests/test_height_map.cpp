@@ -0,0 +1,127 @@
+// The top surface the support checks read: which boxes it names under a footprint, when
+// it defers to the full scan, and what it reports after boxes are taken back out. On
+// random stacked loads its answers must match the scan over every placed box.
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "height_map.h"
+#include "packing_common.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+using Surface = engine::packing::HeightMap<double>;
+
+void check_queries() {
+  Surface s;
+  s.set_floor(2.4, 6.0);
+  s.raise(0.0, 0.0, 1.0, 1.0, 0.5, 0);  // A
+  s.raise(1.0, 0.0, 1.0, 1.0, 0.5, 1);  // B, level with A
+  s.raise(0.0, 1.0, 2.0, 1.0, 0.8, 2);  // C, behind both and higher
+  std::vector<uint32_t> owners;
+
+  check(s.level_owners(0.5, 0.2, 1.0, 0.6, 0.5, &owners) && owners == std::vector<uint32_t>{0, 1},
+        "a base across A and B should rest on both, in order");
+  check(s.level_owners(0.5, 0.2, 1.0, 0.6, 0.5 + 4e-7, &owners) && owners == std::vector<uint32_t>{0, 1},
+        "a base within the level tolerance should still rest on A and B");
+  check(s.level_owners(0.5, 0.2, 1.0, 0.6, 0.502, &owners) && owners.empty(),
+        "a base above A and B with nothing over it rests on nothing");
+  check(s.level_owners(0.2, 1.2, 1.5, 0.5, 0.8, &owners) && owners == std::vector<uint32_t>{2},
+        "a base on C should rest on C alone");
+  check(!s.level_owners(0.5, 0.5, 0.5, 1.0, 0.5, &owners), "C over part of the footprint should defer to the scan");
+  check(s.rest_height(0.5, 0.5, 0.5, 1.0) == 0.8, "a box across A and C comes to rest on C");
+  check(s.rest_height(0.5, 0.2, 1.0, 0.6) == 0.5, "a box across A and B comes to rest on them");
+  check(s.rest_height(2.1, 0.0, 0.3, 3.0) == 0.0, "beside the load is floor");
+}
+
+// Stacks random boxes the way a decoder would, each at the height it comes to rest at,
+// then asks what holds up random bases: the surface's answer, when it gives one, and
+// support_contacts() must both match the scan over every placed box.
+template <typename T>
+void check_against_scan(T unit, uint32_t seed) {
+  using namespace engine::packing;
+  const std::string label = std::is_integral_v<T> ? "int32" : "double";
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> pos(0, 11), side(1, 5);
+  size_t answered = 0, queries = 0;
+  for (int load = 0; load < 30; ++load) {
+    PlacedBoxes<T, SupportPhysics> placed;
+    placed.set_floor(16 * unit, 16 * unit);
+    for (int n = 0; n < 60; ++n) {
+      BasicAABB<T> b{pos(rng) * unit, 0, pos(rng) * unit, side(rng) * unit, side(rng) * unit, side(rng) * unit};
+      b.y = placed.surface.rest_height(b.x, b.z, b.w, b.d);
+      placed.add(b, 0);
+
+      // A base at a random placed top, or where a box would come to rest.
+      BasicAABB<T> q{pos(rng) * unit, 0, pos(rng) * unit, side(rng) * unit, unit, side(rng) * unit};
+      const size_t pick = std::uniform_int_distribution<size_t>(0, placed.size() - 1)(rng);
+      q.y = n % 2 == 0 ? placed.geometry.y1[pick] : placed.surface.rest_height(q.x, q.z, q.w, q.d);
+
+      std::vector<uint32_t> want(placed.size());
+      std::vector<T> want_ox(placed.size()), want_oz(placed.size());
+      const size_t k = support_overlaps(placed.geometry, q, want.data(), want_ox.data(), want_oz.data());
+      want.resize(k);
+      const std::string at = label + " load " + std::to_string(load) + " box " + std::to_string(n);
+
+      ++queries;
+      std::vector<uint32_t> owners;
+      if (placed.surface.level_owners(q.x, q.z, q.w, q.d, q.y, &owners)) {
+        ++answered;
+        check(owners == want, at + ": the surface names other supporters than the scan");
+      }
+      const size_t hits = support_contacts(q, placed);
+      bool same = hits == k;
+      for (size_t h = 0; same && h < hits; ++h) {
+        same = placed.hits[h] == want[h] && placed.ox[h] == want_ox[h] && placed.oz[h] == want_oz[h];
+      }
+      check(same, at + ": support_contacts differs from the scan");
+    }
+  }
+  // Overhangs send some queries to the scan, but the surface should answer most.
+  check(answered * 2 > queries, label + ": the surface answered only " + std::to_string(answered) + " of " +
+                                    std::to_string(queries) + " queries");
+}
+
+void check_lowering() {
+  Surface s;
+  s.set_floor(2.4, 6.0);
+  s.raise(0.0, 0.0, 2.0, 2.0, 1.0, 0);  // A on the floor
+  s.raise(0.5, 0.5, 1.0, 1.0, 1.5, 1);  // B on A
+  s.raise(1.2, 1.2, 1.0, 1.0, 2.0, 2);  // C over a corner of B, held up elsewhere
+  std::vector<uint32_t> owners;
+  check(!s.level_owners(0.0, 0.0, 2.0, 2.0, 1.0, &owners), "B and C should cover part of A");
+
+  // B comes out: its rectangles go, and raising what lies under it brings A back.
+  s.lower(0.5, 0.5, 1.0, 1.0, 1);
+  s.raise(0.0, 0.0, 2.0, 2.0, 1.0, 0);
+  check(s.rest_height(0.5, 0.5, 0.6, 0.6) == 1.0, "A's top not back where B was");
+  check(s.rest_height(1.3, 1.3, 0.1, 0.1) == 2.0, "C lowered with B");
+  check(s.level_owners(0.2, 0.2, 0.9, 0.9, 1.0, &owners) && owners == std::vector<uint32_t>{0},
+        "a base on A's top should rest on A alone");
+  check(!s.level_owners(0.2, 0.2, 1.5, 1.5, 1.0, &owners), "C still covers part of A");
+
+  // C comes out with nothing beneath but A and the floor.
+  s.lower(1.2, 1.2, 1.0, 1.0, 2);
+  s.raise(0.0, 0.0, 2.0, 2.0, 1.0, 0);
+  check(s.rest_height(1.2, 1.2, 1.0, 1.0) == 1.0, "C's top left over A");
+  check(s.rest_height(2.05, 2.05, 0.1, 0.1) == 0.0, "C's top left over the floor");
+  check(s.level_owners(0.0, 0.0, 2.0, 2.0, 1.0, &owners) && owners == std::vector<uint32_t>{0},
+        "A should be the whole surface over its footprint");
+}
+
+}  // namespace
+
+int main() {
+  check_queries();
+  check_against_scan<double>(0.25, 21);
+  check_against_scan<int32_t>(250, 22);
+  check_lowering();
+
+  return finish("height map");
+}
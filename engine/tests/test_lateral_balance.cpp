@@ -0,0 +1,109 @@
+// max_lateral_offset on a manifest the truck cannot hold: whatever stays out, the plan
+// each decoder returns, alone or through the GA, keeps its centre of gravity within the
+// limit, recomputed here from the placements themselves. Trimming a plan for it stops
+// short rather than put an axle over its limit.
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "decoder.h"
+#include "optimizer.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+// Heavy and light SKUs mixed, so a row cut short is lopsided.
+std::vector<engine::Box> lopsided_boxes(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<engine::Box> boxes;
+  for (size_t i = 0; i < n; ++i) {
+    const double weight = i % 4 == 0 ? 150 + 200 * u(rng) : 2 + 20 * u(rng);
+    boxes.push_back(engine::Box{"B" + std::to_string(i), 0.3 + 0.5 * u(rng), 0.3 + 0.5 * u(rng), 0.3 + 0.5 * u(rng),
+                                weight, 1});
+  }
+  return boxes;
+}
+
+void check_plan(const engine::PreparedInstance& inst, const engine::Result& r, const std::string& label) {
+  std::unordered_map<std::string, double> weight;
+  for (const auto& b : inst.boxes) weight[b.id] = b.weight;
+  double w = 0, mx = 0;
+  for (const auto& p : r.placed) {
+    w += weight[p.id];
+    mx += weight[p.id] * (p.x + p.w / 2);
+  }
+  check(!r.unplaced.empty(), label + ": every box fit, nothing to test");
+  check(r.placed.size() + r.unplaced.size() == inst.boxes.size(), label + ": boxes lost");
+  check(w > 0, label + ": empty plan");
+  if (!(w > 0)) return;
+  const double offset = std::fabs(mx / w - inst.truck.w / 2);
+  check(offset <= inst.truck.max_lateral_offset + 1e-6, label + ": lateral offset " + std::to_string(offset));
+  check(std::fabs(r.cog_x - mx / w) <= 1e-6, label + ": cog_x does not match the placements");
+  check(std::fabs(r.total_weight - w) <= 1e-6, label + ": total_weight does not match the placements");
+}
+
+// Two columns: B under A ahead of the front axle on the left, K under H behind the rear
+// axle on the right. Taking A off would balance the plan but overload the rear axle, and
+// taking H off would overload the front one, so the plan must stay as it is.
+void check_axles_hold() {
+  engine::Truck truck{2.0, 2.0, 4.0, 1000};
+  truck.front_axle_z = 1.0;
+  truck.rear_axle_z = 3.0;
+  truck.front_axle_max = 222;
+  truck.rear_axle_max = 110;
+  truck.max_lateral_offset = 0.1;
+  const auto inst = engine::prepare_instance(
+      truck, {engine::Box{"B", 1, 1, 1, 100, 1}, engine::Box{"A", 1, 1, 1, 100, 1}, engine::Box{"K", 1, 1, 1, 100, 1},
+              engine::Box{"H", 1, 1, 1, 20, 1}});
+
+  engine::Result r{};
+  r.placed = {engine::Placement{"B", 0, 0, 0, 1, 1, 1}, engine::Placement{"A", 0, 1, 0, 1, 1, 1},
+              engine::Placement{"K", 1, 0, 3, 1, 1, 1}, engine::Placement{"H", 1, 1, 3, 1, 1, 1}};
+  r.used_volume = 4;
+  r.total_weight = 320;
+  r.cog_x = 280.0 / 320;
+  const std::vector<uint32_t> first = {0, 0, 1, 1, 2}, on = {0, 2};
+  engine::settle_lateral_offset(inst, engine::SupportGraph{&first, &on}, &r);
+  check(r.placed.size() == 4 && r.unplaced.empty(), "axles: a box was taken off past an axle limit");
+}
+
+}  // namespace
+
+int main() {
+  check_axles_hold();
+
+  const struct {
+    const char* name;
+    engine::DecoderKind kind;
+  } kinds[] = {{"extreme_points", engine::DecoderKind::kExtremePoints},
+               {"wall", engine::DecoderKind::kWallBuilding},
+               {"ems", engine::DecoderKind::kEmptySpaces}};
+
+  for (uint32_t seed = 1; seed <= 6; ++seed) {
+    engine::Truck truck{2.4, 2.0, 2.5, 30000};
+    truck.max_lateral_offset = 0.05;
+    const auto inst = engine::prepare_instance(truck, lopsided_boxes(90, seed));
+    std::vector<size_t> order(inst.boxes.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    for (const auto& k : kinds) {
+      const std::string label = std::string(k.name) + " seed " + std::to_string(seed);
+      check_plan(inst, engine::decode_order(inst, k.kind, order), label + " decode");
+
+      engine::GaParams p;
+      p.population = 8;
+      p.generations = 3;
+      p.seed = seed;
+      p.decoder = k.kind;
+      check_plan(inst, engine::optimize_ga(inst, p), label + " ga");
+    }
+  }
+
+  return finish("lateral balance");
+}
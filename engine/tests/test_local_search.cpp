@@ -0,0 +1,71 @@
+// The memetic step on a truck the manifest overflows, where it is the only case that can
+// change the score: every decoder must report a gain and still return a sound plan.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "optimizer.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  std::vector<engine::Box> boxes;
+  for (size_t i = 0; i < 120; ++i) {
+    if (i % 3 == 2) {
+      boxes.push_back(boxes.back());
+    } else {
+      boxes.push_back(engine::Box{"", 0.3 + 0.5 * u(rng), 0.2 + 0.5 * u(rng), 0.3 + 0.6 * u(rng), 2 + 38 * u(rng), 1});
+    }
+    boxes.back().id = "B" + std::to_string(i);
+  }
+  const engine::Truck truck{2.4, 2.6, 2.0, 24000};
+  const auto inst = engine::prepare_instance(truck, boxes);
+  check(inst.total_volume > truck.w * truck.h * truck.d, "the manifest should overflow the truck");
+
+  const struct {
+    const char* name;
+    engine::DecoderKind kind;
+  } kinds[] = {{"extreme_points", engine::DecoderKind::kExtremePoints},
+               {"wall", engine::DecoderKind::kWallBuilding},
+               {"ems", engine::DecoderKind::kEmptySpaces}};
+  for (const auto& k : kinds) {
+    engine::GaParams p;
+    p.population = 12;
+    p.generations = 4;
+    p.seed = 3;
+    p.decoder = k.kind;
+    p.local_search_elites = 2;
+    p.local_search_moves = 16;
+    const engine::Result r = engine::optimize_ga(inst, p);
+    const std::string label = k.name;
+
+    check(r.local_search_gain > 0, label + ": local search gained nothing");
+    check(r.local_search_ms > 0, label + ": local search time not reported");
+    check(!r.unplaced.empty(), label + ": everything placed in an overflowing truck");
+
+    std::vector<std::string> ids;
+    for (const auto& pl : r.placed) ids.push_back(pl.id);
+    ids.insert(ids.end(), r.unplaced.begin(), r.unplaced.end());
+    std::sort(ids.begin(), ids.end());
+    std::vector<std::string> want;
+    for (const auto& b : boxes) want.push_back(b.id);
+    std::sort(want.begin(), want.end());
+    check(ids == want, label + ": boxes lost or duplicated");
+    for (size_t i = 0; i < r.placed.size(); ++i) {
+      for (size_t j = i + 1; j < r.placed.size(); ++j) {
+        check(!overlap(r.placed[i], r.placed[j]), label + ": " + r.placed[i].id + " overlaps " + r.placed[j].id);
+      }
+    }
+  }
+
+  return finish("local search");
+}
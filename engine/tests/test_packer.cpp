@@ -0,0 +1,105 @@
+// Live loading sessions: boxes taken out leave the space and surface as if they had never
+// been placed, and what a session cannot honour is refused instead of ignored.
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "packer.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+template <typename F>
+bool throws(F f) {
+  try {
+    f();
+  } catch (const std::invalid_argument&) {
+    return true;
+  }
+  return false;
+}
+
+void check_refusals() {
+  engine::Truck axles{2.4, 2.6, 13.6, 24000};
+  axles.front_axle_z = 1.0;
+  axles.rear_axle_z = 11.0;
+  axles.rear_axle_max = 18000;
+  check(throws([&] { engine::Packer p(axles); }), "truck with axle limits accepted");
+
+  engine::Truck lateral{2.4, 2.6, 13.6, 24000};
+  lateral.max_lateral_offset = 0.1;
+  check(throws([&] { engine::Packer p(lateral); }), "truck with a lateral limit accepted");
+
+  engine::Packer p(engine::Truck{2.4, 2.6, 13.6, 24000});
+  engine::Box stop{"S", 0.5, 0.5, 0.5, 10, 1};
+  stop.drop = 2;
+  check(throws([&] { p.add_box(stop); }), "box with a drop accepted");
+  check(p.size() == 0 && p.snapshot().unplaced.empty(), "refused box recorded");
+}
+
+void check_removal() {
+  // A slab across the floor, a box on it, then the box taken out: a box of the same size
+  // goes back on the slab, and the slab can then come out too.
+  for (const auto mode : {engine::PhysicsMode::kFull, engine::PhysicsMode::kSupportOnly}) {
+    engine::PhysicsModel physics;
+    physics.mode = mode;
+    engine::Packer p(engine::Truck{2.4, 2.6, 2.0, 24000}, physics);
+    const auto slab = p.add_box(engine::Box{"slab", 2.4, 0.4, 2.0, 50, 1});
+    check(slab && slab->y == 0.0, "slab not on the floor");
+    const auto top = p.add_box(engine::Box{"top", 1.0, 1.0, 1.0, 20, 1});
+    check(top && top->y == 0.4, "box not on the slab");
+    check(throws([&] { p.remove_box("slab"); }), "removed a box something rests on");
+
+    p.remove_box("top");
+    const auto again = p.add_box(engine::Box{"again", 1.0, 1.0, 1.0, 20, 1});
+    check(again && again->y == 0.4 && again->x == 0.0 && again->z == 0.0, "box not back on the slab");
+    p.remove_box("again");
+    p.remove_box("slab");
+    check(p.size() == 0 && p.snapshot().placed.empty(), "boxes left after removing all");
+    const auto floor = p.add_box(engine::Box{"floor", 1.0, 1.0, 1.0, 20, 1});
+    check(floor && floor->y == 0.0, "box not on the emptied floor");
+  }
+}
+
+void check_late_small_box() {
+  // The 0.1 m gap beside the wide box is too tight for it and set aside; a small box
+  // arriving later must still find it.
+  engine::Packer p(engine::Truck{1.0, 1.0, 1.0, 24000});
+  engine::Box wide{"wide", 0.9, 0.9, 1.0, 20, 1};
+  wide.orientations = 0x01;
+  check(p.add_box(wide).has_value(), "wide box not placed");
+  check(!p.add_box(engine::Box{"again", 0.9, 0.9, 0.9, 20, 1}), "second wide box placed in a gap");
+  const auto small = p.add_box(engine::Box{"small", 0.1, 0.1, 0.1, 1, 1});
+  check(small && small->y == 0.0 && std::fabs(small->x - 0.9) < 1e-9, "small box not in the gap beside the wide one");
+}
+
+void check_runs_regrow() {
+  // Two slices side by side, the left one taken out first: the front corner it frees
+  // is hemmed in by the right one, and must open up to the far wall once that goes too.
+  engine::Packer p(engine::Truck{1.0, 1.0, 1.0, 24000});
+  for (const char* id : {"left", "right"}) {
+    engine::Box slice{id, 0.5, 1.0, 1.0, 20, 1};
+    slice.orientations = 0x01;
+    check(p.add_box(slice).has_value(), std::string(id) + " slice not placed");
+  }
+  p.remove_box("left");
+  p.remove_box("right");
+  engine::Box wide{"wide", 0.8, 1.0, 1.0, 20, 1};
+  wide.orientations = 0x01;
+  const auto back = p.add_box(wide);
+  check(back && back->x == 0.0, "wide box not placed on the emptied floor");
+}
+
+}  // namespace
+
+int main() {
+  check_refusals();
+  check_removal();
+  check_late_small_box();
+  check_runs_regrow();
+
+  return finish("packer");
+}
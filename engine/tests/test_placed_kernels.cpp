@@ -0,0 +1,95 @@
+// Every vector version of the placed-box kernels this CPU runs must give exactly what the
+// scalar one gives: random loads of every length around the vector widths, queried with
+// boxes that cross, touch and rest level on what is placed.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "packing_common.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine::packing;
+
+using namespace engine_test;
+
+// Boxes on a coarse grid, so faces touch and tops line up often. Double coordinates are
+// nudged by less than the level tolerance now and then, and by more at other times.
+template <typename T>
+BasicAABB<T> random_box(std::mt19937& rng, T unit, bool nudge) {
+  std::uniform_int_distribution<int> pos(0, 9), side(1, 4);
+  BasicAABB<T> b{pos(rng) * unit, pos(rng) * unit, pos(rng) * unit, side(rng) * unit, side(rng) * unit, side(rng) * unit};
+  if constexpr (!std::is_integral_v<T>) {
+    if (nudge) {
+      const double nudges[] = {0, 0, 4e-7, -4e-7, 3e-6, -3e-6};
+      b.y += nudges[std::uniform_int_distribution<int>(0, 5)(rng)];
+    }
+  }
+  return b;
+}
+
+template <typename T>
+void check_set(const PlacedKernelSet& set, const PlacedKernelSet& scalar, T unit, uint32_t seed) {
+  auto any = [](const PlacedKernelSet& s) {
+    if constexpr (std::is_integral_v<T>) {
+      return s.any_intersects_fixed;
+    } else {
+      return s.any_intersects;
+    }
+  };
+  auto overlaps = [](const PlacedKernelSet& s) {
+    if constexpr (std::is_integral_v<T>) {
+      return s.support_overlaps_fixed;
+    } else {
+      return s.support_overlaps;
+    }
+  };
+  const std::string label = std::string(set.isa) + (std::is_integral_v<T> ? " int32" : " double");
+
+  std::mt19937 rng(seed);
+  for (size_t n = 0; n <= 70; ++n) {
+    for (int round = 0; round < 40; ++round) {
+      PlacedGeometry<T> g;
+      for (size_t i = 0; i < n; ++i) g.push_back(random_box(rng, unit, true));
+      // A base level with a placed top, or anywhere.
+      BasicAABB<T> q = random_box(rng, unit, true);
+      if (n > 0 && round % 2 == 0) q.y = g.y1[std::uniform_int_distribution<size_t>(0, n - 1)(rng)];
+
+      const std::string at = label + " n=" + std::to_string(n) + " round " + std::to_string(round);
+      check(any(set)(g, q) == any(scalar)(g, q), at + ": any_intersects differs");
+
+      std::vector<uint32_t> idx(n + 1), want_idx(n + 1);
+      std::vector<T> ox(n + 1), oz(n + 1), want_ox(n + 1), want_oz(n + 1);
+      const size_t k = overlaps(set)(g, q, idx.data(), ox.data(), oz.data());
+      const size_t want = overlaps(scalar)(g, q, want_idx.data(), want_ox.data(), want_oz.data());
+      bool same = k == want;
+      for (size_t j = 0; same && j < k; ++j) {
+        same = idx[j] == want_idx[j] && ox[j] == want_ox[j] && oz[j] == want_oz[j];
+      }
+      check(same, at + ": support_overlaps differs");
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  const std::vector<PlacedKernelSet> sets = placed_kernel_sets();
+  check(!sets.empty() && std::string(sets.front().isa) == "scalar", "scalar kernels not listed first");
+  bool dispatched = false;
+  for (const auto& set : sets) dispatched = dispatched || std::string(set.isa) == placed_kernels_isa();
+  check(dispatched, std::string("dispatched kernels '") + placed_kernels_isa() + "' not listed");
+
+  for (const auto& set : sets) {
+    check_set<double>(set, sets.front(), 0.25, 11);
+    check_set<int32_t>(set, sets.front(), 250, 12);
+    std::printf("placed kernels: %s checked\n", set.isa);
+  }
+
+  return finish("placed kernels");
+}
@@ -0,0 +1,94 @@
+// Spilled plans come back from disk only to the build and key that wrote them: a file
+// from another plan version, or one without the spill header, is a miss.
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "result_cache.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+engine::Result plan_of(const char* id) {
+  engine::Result r{};
+  r.placed.push_back(engine::Placement{id, 0, 0, 0, 1, 1, 1});
+  r.used_volume = 1;
+  return r;
+}
+
+std::vector<char> read_file(const std::string& path) {
+  std::vector<char> bytes;
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return bytes;
+  char chunk[4096];
+  size_t got;
+  while ((got = std::fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + got);
+  std::fclose(f);
+  return bytes;
+}
+
+void write_file(const std::string& path, const std::vector<char>& bytes) {
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return;
+  std::fwrite(bytes.data(), 1, bytes.size(), f);
+  std::fclose(f);
+}
+
+std::string spill_path(const std::string& dir, uint64_t key) {
+  char name[32];
+  std::snprintf(name, sizeof(name), "/%016llx.vlrs", static_cast<unsigned long long>(key));
+  return dir + name;
+}
+
+}  // namespace
+
+int main() {
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::temp_directory_path() / ("result_cache_test_" + std::to_string(::getpid()));
+  fs::create_directories(dir);
+
+  // Room for one plan, so the second put spills the first.
+  engine::ResultCache probe(1 << 20);
+  probe.put(1, plan_of("A"));
+  const size_t one = probe.stats().bytes;
+
+  engine::ResultCache cache(one + one / 2, dir.string());
+  cache.put(1, plan_of("A"));
+  cache.put(2, plan_of("B"));
+  check(cache.stats().spilled == 1, "first plan not spilled");
+  const std::string path = spill_path(dir.string(), 1);
+  const std::vector<char> good = read_file(path);
+  check(!good.empty(), "no spill file");
+
+  engine::ResultCache reader(one + one / 2, dir.string());
+  const auto back = reader.get(1);
+  check(back && back->placed.size() == 1 && back->placed[0].id == "A", "spilled plan not read back");
+
+  // Another plan version wrote it.
+  std::vector<char> stale = good;
+  if (stale.size() >= 12) {
+    uint32_t version = engine::ResultCache::kPlanVersion + 1;
+    std::memcpy(stale.data() + 8, &version, sizeof(version));
+  }
+  write_file(path, stale);
+  check(!engine::ResultCache(one + one / 2, dir.string()).get(1), "plan from another version served");
+
+  // The file of another key, renamed.
+  write_file(spill_path(dir.string(), 3), good);
+  check(!engine::ResultCache(one + one / 2, dir.string()).get(3), "plan for another key served");
+
+  // A bare wire result, as spilled before the header existed.
+  write_file(path, std::vector<char>(good.begin() + 16, good.end()));
+  check(!engine::ResultCache(one + one / 2, dir.string()).get(1), "headerless file served");
+
+  fs::remove_all(dir);
+  return finish("result cache");
+}
@@ -0,0 +1,48 @@
+// The work-stealing pool under nested fork-join, the way batches fan out their GA
+// decodes: every index runs exactly once, the first exception reaches the caller, and the
+// pool shuts down cleanly after thousands of pushes and steals.
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "thread_pool.h"
+#include "test_common.h"
+
+namespace {
+
+using namespace engine_test;
+
+}  // namespace
+
+int main() {
+  {
+    engine::WorkStealingPool pool(4);
+    for (int round = 0; round < 200; ++round) {
+      std::vector<std::atomic<int>> runs(8 * 16);
+      pool.parallel_for(8, [&](size_t i) {
+        pool.parallel_for(16, [&](size_t j) { runs[i * 16 + j].fetch_add(1); });
+      });
+      bool once = true;
+      for (const auto& r : runs) once = once && r.load() == 1;
+      check(once, "round " + std::to_string(round) + ": an index ran other than once");
+    }
+
+    bool thrown = false;
+    try {
+      pool.parallel_for(32, [](size_t i) {
+        if (i == 17) throw std::runtime_error("17");
+      });
+    } catch (const std::runtime_error& e) {
+      thrown = std::string(e.what()) == "17";
+    }
+    check(thrown, "exception from a task not rethrown");
+
+    std::atomic<int> after{0};
+    pool.parallel_for(64, [&](size_t) { after.fetch_add(1); });
+    check(after.load() == 64, "pool unusable after an exception");
+  }
+
+  return finish("thread pool");
+}
@@ -0,0 +1,53 @@
+// The warm-start cache only hands an order to a run on the same truck: a truck that
+// differs in its axle or lateral limits alone packs differently and starts cold.
+
+#include <string>
+#include <vector>
+
+#include "test_common.h"
+#include "warm_start.h"
+
+namespace {
+
+using namespace engine_test;
+
+}  // namespace
+
+int main() {
+  const std::vector<engine::Box> boxes = make_boxes(8, 1);
+  engine::Truck truck{2.4, 2.6, 13.6, 24000};
+  truck.front_axle_z = 1.0;
+  truck.rear_axle_z = 11.0;
+  truck.rear_axle_max = 18000;
+  truck.max_lateral_offset = 0.1;
+  const auto inst = engine::prepare_instance(truck, boxes);
+
+  engine::Result plan{};
+  for (auto it = boxes.rbegin(); it != boxes.rend(); ++it) {
+    plan.placed.push_back(engine::Placement{it->id, 0, 0, 0, 1, 1, 1});
+  }
+  engine::WarmStartCache cache(4);
+  cache.store(inst, plan);
+  check(cache.lookup(inst) == engine::plan_order(plan), "cached order not found for its own instance");
+
+  // One box fewer: not the same instance, but the same truck and most of its ids.
+  const std::vector<engine::Box> fewer(boxes.begin() + 1, boxes.end());
+  check(!cache.lookup(engine::prepare_instance(truck, fewer)).empty(), "near match on the same truck not reused");
+
+  const struct {
+    const char* name;
+    double engine::Truck::*field;
+  } limits[] = {{"front_axle_z", &engine::Truck::front_axle_z},
+                {"rear_axle_z", &engine::Truck::rear_axle_z},
+                {"front_axle_max", &engine::Truck::front_axle_max},
+                {"rear_axle_max", &engine::Truck::rear_axle_max},
+                {"max_lateral_offset", &engine::Truck::max_lateral_offset}};
+  for (const auto& limit : limits) {
+    engine::Truck other = truck;
+    other.*limit.field += 0.5;
+    check(cache.lookup(engine::prepare_instance(other, fewer)).empty(),
+          std::string("order reused on a truck with another ") + limit.name);
+  }
+
+  return finish("warm start");
+}
@@ -1,6 +1,6 @@
 import React, { useEffect, useMemo, useState } from 'react'
 import TruckViewer from './components/TruckViewer.jsx'
-import { optimize, resetAll, runTests, simulateReplacing } from './services/api.js'
+import { optimizeAsJob, optimizeStream, resetAll, runTests, simulateReplacing } from './services/api.js'
 
 const MIN_STEP_MS = 16
 const DEFAULT_STEP_MS = 80
@@ -140,6 +140,7 @@ export default function App() {
 
   const [visibleCount, setVisibleCount] = useState(0)
   const [isPlaying, setIsPlaying] = useState(false)
+  const [live, setLive] = useState(false)
   const [stepMs, setStepMs] = useState(DEFAULT_STEP_MS)
   const [stepMsInput, setStepMsInput] = useState(String(DEFAULT_STEP_MS))
   const [selected, setSelected] = useState(null)
@@ -147,8 +148,9 @@ export default function App() {
   const params = useMemo(() => ({ population: 20, generations: 15, mutation_rate: 0.08, seed }), [seed])
 
   const placedView = useMemo(() => {
-    return buildSupportAwareLoadOrder(placed)
-  }, [placed])
+    // Streamed intermediate plans change every few hundred ms; skip the ordering pass.
+    return live ? placed : buildSupportAwareLoadOrder(placed)
+  }, [placed, live])
 
   // Animation is for inspection; never show boxes before their supports.
   const selectedPlaced = useMemo(() => {
@@ -202,7 +204,42 @@ export default function App() {
     setError('')
     setStatus('Optimizando…')
     try {
-      const out = await optimize({ dataset_id: datasetId, truck, params })
+      const request = { dataset_id: datasetId, truck, params }
+      const showProgress = (p) => {
+        const util = (p.utilization * 100).toFixed(1)
+        setStatus(`Optimizando… gen ${p.generation}/${p.generations} · util ${util}%`)
+      }
+      let out
+      if (typeof TextDecoderStream !== 'undefined') {
+        // Live mode: render each improving plan as it streams in, unordered and fully visible.
+        const incumbent = new Map()
+        setLive(true)
+        setSelected(null)
+        out = await optimizeStream(request, {
+          onProgress: (p) => {
+            for (const id of p.delta.removed) incumbent.delete(id)
+            for (const b of p.delta.upserts) incumbent.set(b.id, b)
+            if (p.delta.removed.length || p.delta.upserts.length) {
+              const plan = Array.from(incumbent.values())
+              setPlaced(plan)
+              setVisibleCount(plan.length)
+            }
+            showProgress(p)
+          },
+        })
+      } else {
+        out = await optimizeAsJob(request, {
+          onProgress: (job) => {
+            if (job.status === 'queued') setStatus('Optimizando… (en cola)')
+            else if (job.progress) showProgress(job.progress)
+          },
+        })
+      }
+      setLive(false)
+      if (out.cancelled) {
+        setStatus('Optimización cancelada.')
+        return
+      }
       setPlaced(out.placed || [])
       setUnplaced(out.unplaced || [])
       setMetrics(out.metrics || null)
@@ -213,6 +250,7 @@ export default function App() {
     } catch (e) {
       setError(e?.response?.data?.message || e?.message || 'Error optimizando')
       setStatus('')
+      setLive(false)
     } finally {
       setBusy(false)
     }
@@ -402,7 +440,7 @@ export default function App() {
               selectedId={selected?.id || null}
               onSelect={setSelected}
             />
-            {busy && status?.toLowerCase?.().includes('optimiz') ? (
+            {busy && !live && status?.toLowerCase?.().includes('optimiz') ? (
               <div className="overlay" aria-label="Optimizando">
                 <div className="spinner" />
                 <div style={{ marginTop: 10, fontSize: 12 }}>Optimizando…</div>
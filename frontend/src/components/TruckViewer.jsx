@@ -19,6 +19,7 @@ export default function TruckViewer({ truck, placed, visibleCount, selectedId, o
   const truckMeshRef = useRef(null)
   const boxGroupRef = useRef(null)
   const meshesRef = useRef([])
+  const meshByKeyRef = useRef(new Map())
   const hoverHelperRef = useRef(null)
   const selectedHelperRef = useRef(null)
   const boxMaterialRef = useRef(null)
@@ -167,6 +168,7 @@ export default function TruckViewer({ truck, placed, visibleCount, selectedId, o
         mesh.geometry?.dispose?.()
       }
       meshesRef.current = []
+      meshByKeyRef.current = new Map()
 
       if (boxMaterialRef.current) {
         boxMaterialRef.current.dispose()
@@ -205,28 +207,45 @@ export default function TruckViewer({ truck, placed, visibleCount, selectedId, o
     const group = boxGroupRef.current
     if (!group) return
 
-    for (const mesh of meshesRef.current) {
-      group.remove(mesh)
-      mesh.geometry?.dispose?.()
-    }
-    meshesRef.current = []
-
-    if (boxMaterialRef.current) {
-      boxMaterialRef.current.dispose()
-      boxMaterialRef.current = null
-    }
+    // Reconcile by id instead of rebuilding: while a run streams improving plans, most
+    // boxes keep their pose between updates and their meshes can be reused as-is.
+    if (!boxMaterialRef.current) boxMaterialRef.current = new THREE.MeshNormalMaterial()
+    const normalMat = boxMaterialRef.current
 
-    const normalMat = new THREE.MeshNormalMaterial()
-    boxMaterialRef.current = normalMat
+    const previous = meshByKeyRef.current
+    const next = new Map()
+    const meshes = []
+    const seen = new Map()
 
     for (const b of placed || []) {
-      const g = new THREE.BoxGeometry(b.w, b.h, b.d)
-      const m = new THREE.Mesh(g, normalMat)
+      const occurrence = seen.get(b.id) || 0
+      seen.set(b.id, occurrence + 1)
+      const key = `${b.id}\u0000${occurrence}`
+
+      let m = previous.get(key)
+      if (m) {
+        previous.delete(key)
+        const g = m.geometry.parameters
+        if (g.width !== b.w || g.height !== b.h || g.depth !== b.d) {
+          m.geometry.dispose()
+          m.geometry = new THREE.BoxGeometry(b.w, b.h, b.d)
+        }
+      } else {
+        m = new THREE.Mesh(new THREE.BoxGeometry(b.w, b.h, b.d), normalMat)
+        group.add(m)
+      }
       m.position.set(b.x + b.w / 2, b.y + b.h / 2, b.z + b.d / 2)
       m.userData = { id: b.id }
-      group.add(m)
-      meshesRef.current.push(m)
+      next.set(key, m)
+      meshes.push(m)
+    }
+
+    for (const m of previous.values()) {
+      group.remove(m)
+      m.geometry?.dispose?.()
     }
+    meshByKeyRef.current = next
+    meshesRef.current = meshes
   }, [placed])
 
   useEffect(() => {
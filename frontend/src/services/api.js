@@ -37,6 +37,100 @@ export async function optimize({ dataset_id, truck, boxes, params }) {
   return data
 }
 
+/**
+ * Queue an optimization job; resolves to `{ job_id, status }` right away.
+ */
+export async function submitOptimizeJob({ dataset_id, truck, boxes, params, priority = 0 }) {
+  const { data } = await api.post(
+    '/api/optimize/jobs',
+    { dataset_id, truck, boxes, params },
+    { params: { priority } },
+  )
+  return data
+}
+
+export async function getOptimizeJob(jobId, { includeResult = true } = {}) {
+  const { data } = await api.get(`/api/optimize/jobs/${jobId}`, {
+    params: { result: includeResult ? 1 : 0 },
+  })
+  return data
+}
+
+export async function cancelOptimizeJob(jobId) {
+  const { data } = await api.delete(`/api/optimize/jobs/${jobId}`)
+  return data
+}
+
+/**
+ * Optimize through the async job API and poll until it finishes.
+ *
+ * Large datasets can outlive a single HTTP request; polling keeps each call short and
+ * lets the UI show GA progress. `onProgress` receives the job status on every poll.
+ * Resolves with the result, or with `{ cancelled: true }` if the job was cancelled.
+ */
+export async function optimizeAsJob(request, { onProgress, intervalMs = 1000 } = {}) {
+  const { job_id } = await submitOptimizeJob(request)
+  for (;;) {
+    await new Promise((resolve) => setTimeout(resolve, intervalMs))
+    const job = await getOptimizeJob(job_id, { includeResult: false })
+    onProgress?.(job)
+    if (job.status === 'done') {
+      const final = await getOptimizeJob(job_id)
+      return final.result
+    }
+    if (job.status === 'cancelled') {
+      return { cancelled: true }
+    }
+    if (job.status === 'failed') {
+      throw new Error(job.error || 'Optimization job failed')
+    }
+  }
+}
+
+/**
+ * Optimize while receiving best-so-far plans over Server-Sent Events.
+ *
+ * `onProgress` gets each `progress` event (`{generation, generations, utilization,
+ * delta: {upserts, removed}, ...}`); deltas apply to the previous event's plan. Resolves
+ * with the final result. Uses fetch rather than EventSource because the request is a POST.
+ */
+export async function optimizeStream({ dataset_id, truck, boxes, params }, { onProgress, signal } = {}) {
+  const resp = await fetch(`${baseURL}/api/optimize/stream`, {
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json', Accept: 'text/event-stream' },
+    body: JSON.stringify({ dataset_id, truck, boxes, params }),
+    signal,
+  })
+  if (!resp.ok || !resp.body) {
+    const body = await resp.json().catch(() => ({}))
+    throw new Error(body.message || body.error || `HTTP ${resp.status}`)
+  }
+
+  const reader = resp.body.pipeThrough(new TextDecoderStream()).getReader()
+  let buffer = ''
+  for (;;) {
+    const { value, done } = await reader.read()
+    if (done) break
+    buffer += value
+    let end
+    while ((end = buffer.indexOf('\n\n')) !== -1) {
+      const block = buffer.slice(0, end)
+      buffer = buffer.slice(end + 2)
+      let event = 'message'
+      let data = ''
+      for (const line of block.split('\n')) {
+        if (line.startsWith('event:')) event = line.slice(6).trim()
+        else if (line.startsWith('data:')) data += line.slice(5).trim()
+      }
+      const payload = data ? JSON.parse(data) : null
+      if (event === 'progress') onProgress?.(payload)
+      else if (event === 'result') return payload
+      else if (event === 'error') throw new Error(payload?.message || 'Optimization failed')
+    }
+  }
+  throw new Error('Stream ended without a result')
+}
+
 export async function runTests() {
   const { data } = await api.post('/api/tests/run', {})
   return data
@@ -0,0 +1,107 @@
+import os
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    # Integration tests run against a real engine service; allow CI/Compose to override.
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _cubes(n: int, weight: float) -> list[dict]:
+    return [
+        {"id": f"c{i}", "w": 1.0, "h": 1.0, "d": 1.0, "weight": weight, "priority": 1}
+        for i in range(n)
+    ]
+
+
+@pytest.mark.parametrize("decoder", ["extreme_points", "wall", "ems"])
+def test_front_axle_limit_caps_the_load(decoder):
+    engine = _engine_url()
+
+    # Scenario: a single row of 100 kg cubes on a truck whose supports sit at both ends.
+    # The front support carries 150 kg once two cubes are loaded from the front, so a
+    # third would overload it wherever it goes.
+    payload = {
+        "truck": {
+            "w": 1.0,
+            "h": 1.0,
+            "d": 4.0,
+            "max_weight": 5000,
+            "front_axle_z": 0.0,
+            "rear_axle_z": 4.0,
+            "front_axle_max": 150,
+        },
+        "boxes": _cubes(4, 100),
+        "params": {"population": 8, "generations": 4, "seed": 1, "decoder": decoder},
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    data = r.json()
+    metrics = data["metrics"]
+
+    assert len(data["placed"]) == 2
+    assert metrics["front_axle_load"] <= 150 + 1e-6
+    axles = metrics["front_axle_load"] + metrics["rear_axle_load"]
+    assert axles == pytest.approx(metrics["total_weight"])
+
+
+def test_lateral_offset_balances_the_load():
+    engine = _engine_url()
+
+    # Scenario: two equal cubes side by side are centred; a 100 kg and a 10 kg cube never
+    # are, so only one of them can go.
+    truck = {"w": 2.0, "h": 1.0, "d": 1.0, "max_weight": 5000, "max_lateral_offset": 0.1}
+    params = {"population": 8, "generations": 4, "seed": 2}
+
+    payload = {"truck": truck, "boxes": _cubes(2, 100), "params": params}
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    data = r.json()
+    assert data["unplaced"] == []
+    assert data["metrics"]["cog_x"] == pytest.approx(1.0)
+
+    payload["boxes"][1]["weight"] = 10
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    assert len(r.json()["unplaced"]) == 1
+
+
+def test_axle_limits_need_both_supports():
+    engine = _engine_url()
+
+    # Scenario: a limit without a wheelbase to split the load over is a client error.
+    payload = {
+        "truck": {"w": 1.0, "h": 1.0, "d": 4.0, "max_weight": 5000, "front_axle_max": 150},
+        "boxes": _cubes(1, 100),
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 400
+
+
+@pytest.mark.parametrize("decoder", ["extreme_points", "wall", "ems"])
+def test_lateral_offset_holds_when_boxes_stay_out(decoder):
+    engine = _engine_url()
+
+    # Scenario: 30 half-metre cubes, heavy and light in turn, for room for 16; whatever
+    # stays out, the centre of gravity of what is loaded stays within 5 cm of the middle.
+    truck = {"w": 2.0, "h": 1.0, "d": 1.0, "max_weight": 5000, "max_lateral_offset": 0.05}
+    boxes = [
+        {"id": f"h{i}", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 100 if i % 2 else 5}
+        for i in range(30)
+    ]
+    params = {"population": 8, "generations": 4, "seed": 4, "decoder": decoder}
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=60
+    )
+    assert r.status_code == 200
+    data = r.json()
+    assert data["unplaced"]
+    weight = {b["id"]: b["weight"] for b in boxes}
+    total = sum(weight[p["id"]] for p in data["placed"])
+    moment = sum(weight[p["id"]] * (p["x"] + p["w"] / 2) for p in data["placed"])
+    assert abs(moment / total - 1.0) <= 0.05 + 1e-6
+    assert data["metrics"]["cog_x"] == pytest.approx(moment / total)
@@ -0,0 +1,35 @@
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_batch_matches_single_calls_in_order():
+    engine = _engine_url()
+
+    # Scenario: a batch returns, in order, what separate /optimize calls would, and a
+    # broken instance only fails itself.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 1000}
+    params = {"population": 8, "generations": 4, "seed": 3}
+    instances = []
+    for k in range(3):
+        boxes = [{"id": f"B{i}", "w": 0.4 + 0.1 * k, "h": 0.5, "d": 0.6} for i in range(4 + k)]
+        instances.append({"truck": truck, "boxes": boxes, "params": params})
+
+    r = requests.post(f"{engine}/optimize/batch", json={"instances": instances}, timeout=120)
+    assert r.status_code == 200
+    results = r.json()["results"]
+    assert len(results) == 3
+
+    for instance, result in zip(instances, results):
+        single = requests.post(f"{engine}/optimize", json=instance, timeout=60).json()
+        assert result.pop("elapsed_ms") >= 0
+        assert result == single
+
+    bad = requests.post(
+        f"{engine}/optimize/batch", json={"instances": [{"truck": truck}]}, timeout=30
+    )
+    assert bad.status_code == 400
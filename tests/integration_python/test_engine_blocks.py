@@ -0,0 +1,72 @@
+import os
+import random
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_blocks_expand_to_every_box():
+    engine = _engine_url()
+
+    # Scenario: a manifest of three repeated SKUs packed with block-building comes back
+    # box by box, with every id accounted for once and original box sizes in the plan.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 8000}
+    skus = [(0.4, 0.3, 0.5, 8.0), (0.6, 0.4, 0.4, 12.0), (0.3, 0.3, 0.3, 4.0)]
+    boxes = [
+        {"id": f"K{k}-{i}", "w": w, "h": h, "d": d, "weight": m}
+        for k, (w, h, d, m) in enumerate(skus)
+        for i in range(40)
+    ]
+    params = {"population": 6, "generations": 3, "blocks": True, "block_boxes": 8}
+
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=60
+    )
+    assert r.status_code == 200
+    body = r.json()
+
+    ids = [p["id"] for p in body["placed"]] + body["unplaced"]
+    assert sorted(ids) == sorted(b["id"] for b in boxes)
+    dims = {b["id"]: sorted((b["w"], b["h"], b["d"])) for b in boxes}
+    for p in body["placed"]:
+        assert sorted((p["w"], p["h"], p["d"])) == pytest.approx(dims[p["id"]])
+
+
+
+@pytest.mark.parametrize("decoder", ["extreme_points", "wall", "ems"])
+def test_blocks_place_about_as_many_boxes(decoder):
+    engine = _engine_url()
+
+    # Scenario: five SKUs of forty boxes on a short truck. Blocks leave gaps single boxes
+    # would fill; the short single-box run after them, on the generations the blocks saved,
+    # keeps blocks within a tenth of the boxes packing without them places.
+    rng = random.Random(4)
+    boxes = []
+    for k in range(5):
+        w, h, d = rng.uniform(0.2, 0.6), rng.uniform(0.15, 0.5), rng.uniform(0.2, 0.6)
+        weight = round(rng.uniform(2, 22), 1)
+        sku = {"w": round(w, 3), "h": round(h, 3), "d": round(d, 3), "weight": weight}
+        boxes += [dict(sku, id=f"S{k}-{i}") for i in range(40)]
+    truck = {"w": 2.4, "h": 2.6, "d": 2.0, "max_weight": 24000}
+
+    placed = {}
+    for blocks in (False, True):
+        params = {
+            "population": 12,
+            "generations": 6,
+            "seed": 1,
+            "decoder": decoder,
+            "blocks": blocks,
+        }
+        body = {"truck": truck, "boxes": boxes, "params": params}
+        r = requests.post(f"{engine}/optimize", json=body, timeout=120)
+        assert r.status_code == 200
+        data = r.json()
+        ids = [p["id"] for p in data["placed"]] + data["unplaced"]
+        assert sorted(ids) == sorted(b["id"] for b in boxes)
+        placed[blocks] = len(data["placed"])
+    assert placed[True] >= placed[False] - len(boxes) // 10
@@ -0,0 +1,41 @@
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_registered_dataset_optimizes_by_id():
+    engine = _engine_url()
+
+    # Scenario: upload once, optimize many — a registered manifest gives the same plan as
+    # sending the boxes inline, and can be dropped again.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 1000}
+    boxes = [
+        {"id": "A", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 2, "priority": 2},
+        {"id": "B", "w": 0.6, "h": 0.4, "d": 0.7, "weight": 3, "priority": 1},
+        {"id": "C", "w": 0.6, "h": 0.4, "d": 0.7, "weight": 3, "priority": 1},
+    ]
+    params = {"population": 8, "generations": 4, "seed": 3}
+
+    r = requests.put(
+        f"{engine}/datasets/it-registry", json={"truck": truck, "boxes": boxes}, timeout=60
+    )
+    assert r.status_code == 201
+    assert r.json()["count"] == 3
+    assert r.json()["types"] == 2
+
+    by_id = requests.post(
+        f"{engine}/optimize", json={"dataset_id": "it-registry", "params": params}, timeout=60
+    )
+    inline = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=60
+    )
+    assert by_id.status_code == 200
+    assert by_id.json() == inline.json()
+
+    assert requests.delete(f"{engine}/datasets/it-registry", timeout=10).status_code == 200
+    missing = requests.post(f"{engine}/optimize", json={"dataset_id": "it-registry"}, timeout=60)
+    assert missing.status_code == 404
@@ -0,0 +1,46 @@
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _overlaps(a: dict, b: dict) -> bool:
+    eps = 1e-6
+    return all(
+        a[o] + eps < b[o] + b[s] and b[o] + eps < a[o] + a[s]
+        for o, s in (("x", "w"), ("y", "h"), ("z", "d"))
+    )
+
+
+def test_alternative_decoders_return_valid_plans():
+    engine = _engine_url()
+
+    # Scenario: the wall-building and empty-space decoders place every box of an easy
+    # manifest without overlaps, and an unknown decoder name is rejected.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 5000}
+    boxes = [
+        {"id": f"W{i}", "w": 0.3 + 0.1 * (i % 4), "h": 0.25 + 0.05 * (i % 3), "d": 0.4}
+        for i in range(80)
+    ]
+    for decoder in ("wall", "ems"):
+        params = {"population": 6, "generations": 3, "decoder": decoder}
+        r = requests.post(
+            f"{engine}/optimize",
+            json={"truck": truck, "boxes": boxes, "params": params},
+            timeout=60,
+        )
+        assert r.status_code == 200
+        placed = r.json()["placed"]
+        assert len(placed) == len(boxes), decoder
+        for i, a in enumerate(placed):
+            assert all(not _overlaps(a, b) for b in placed[i + 1 :]), decoder
+
+    bad = requests.post(
+        f"{engine}/optimize",
+        json={"truck": truck, "boxes": boxes, "params": {"decoder": "spiral"}},
+        timeout=30,
+    )
+    assert bad.status_code == 400
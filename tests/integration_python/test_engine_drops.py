@@ -0,0 +1,46 @@
+import os
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    # Integration tests run against a real engine service; allow CI/Compose to override.
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+@pytest.mark.parametrize("decoder", ["extreme_points", "wall", "ems"])
+def test_first_stop_loads_next_to_the_door(decoder):
+    engine = _engine_url()
+
+    # Scenario: three stops in a truck one cube wide and high. Listed first-stop first, the
+    # cubes must still end up last stop at the front and first stop at the rear door.
+    payload = {
+        "truck": {"w": 1.0, "h": 1.0, "d": 3.0, "max_weight": 1000},
+        "boxes": [
+            {"id": f"stop_{s}", "w": 1.0, "h": 1.0, "d": 1.0, "weight": 10, "drop": s}
+            for s in (1, 2, 3)
+        ],
+        "params": {"population": 8, "generations": 4, "seed": 1, "decoder": decoder},
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    data = r.json()
+
+    assert data["unplaced"] == []
+    z = {p["id"]: p["z"] for p in data["placed"]}
+    assert z["stop_3"] < z["stop_2"] < z["stop_1"]
+
+
+def test_negative_drop_is_rejected():
+    engine = _engine_url()
+
+    # Scenario: stops are numbered from 1; 0 means the box stays on board.
+    payload = {
+        "truck": {"w": 1.0, "h": 1.0, "d": 1.0, "max_weight": 1000},
+        "boxes": [{"id": "a", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 1, "drop": -1}],
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 400
@@ -0,0 +1,53 @@
+import os
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_fixed_point_decoder_matches_double_path():
+    engine = _engine_url()
+
+    # Scenario: the same request decoded on a millimetre grid and in doubles. The sides are
+    # multiples of 1/8 m, exact in both, so every box lands at the same spot give or take
+    # one unit (1 mm); a negative unit is rejected.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 12000}
+    boxes = [
+        {
+            "id": f"F{i}",
+            "w": 0.25 + 0.125 * (i % 4),
+            "h": 0.25 + 0.125 * (i % 3),
+            "d": 0.375 + 0.125 * (i % 5),
+            "weight": 5.0 + i % 7,
+        }
+        for i in range(80)
+    ]
+    params = {"population": 8, "generations": 4, "seed": 7, "slab_mode": "off"}
+
+    def optimize(extra):
+        r = requests.post(
+            f"{engine}/optimize",
+            json={"truck": truck, "boxes": boxes, "params": dict(params, **extra)},
+            timeout=120,
+        )
+        assert r.status_code == 200
+        return r.json()
+
+    exact = optimize({})
+    fixed = optimize({"fixed_unit": 0.001})
+
+    assert [p["id"] for p in fixed["placed"]] == [p["id"] for p in exact["placed"]]
+    for a, b in zip(exact["placed"], fixed["placed"]):
+        for k in ("x", "y", "z", "w", "h", "d"):
+            assert b[k] == pytest.approx(a[k], abs=0.001)
+    assert fixed["utilization"] == pytest.approx(exact["utilization"], abs=1e-6)
+
+    bad = requests.post(
+        f"{engine}/optimize",
+        json={"truck": truck, "boxes": boxes[:3], "params": dict(params, fixed_unit=-1)},
+        timeout=30,
+    )
+    assert bad.status_code == 400
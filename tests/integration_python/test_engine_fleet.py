@@ -0,0 +1,34 @@
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_fleet_spreads_boxes_over_trucks():
+    engine = _engine_url()
+
+    # Scenario: more boxes than one small van holds; every box ends up in exactly one truck
+    # (or unplaced) and no truck type is used beyond its count.
+    fleet = [
+        {"id": "van", "w": 1.2, "h": 1.2, "d": 1.5, "max_weight": 500, "count": 3},
+        {"id": "oversize-only", "w": 0.2, "h": 0.2, "d": 0.2, "count": 5},
+    ]
+    boxes = [{"id": f"B{i}", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 10} for i in range(30)]
+    params = {"population": 6, "generations": 3}
+
+    r = requests.post(
+        f"{engine}/optimize/fleet",
+        json={"fleet": fleet, "boxes": boxes, "params": params},
+        timeout=120,
+    )
+    assert r.status_code == 200
+    body = r.json()
+
+    placed = [p["id"] for t in body["trucks"] for p in t["placed"]]
+    assert sorted(placed + body["unplaced"]) == sorted(b["id"] for b in boxes)
+    assert body["metrics"]["trucks_used"] == len(body["trucks"]) > 1
+    assert all(t["truck_type"] == "van" for t in body["trucks"])
+    assert len(body["trucks"]) <= 3
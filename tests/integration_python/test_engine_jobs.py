@@ -0,0 +1,42 @@
+import os
+import time
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_job_runs_to_completion_with_progress():
+    engine = _engine_url()
+
+    # Scenario: an async job gives the same plan as a blocking /optimize call.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 1000}
+    boxes = [
+        {"id": "A", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 2, "priority": 2},
+        {"id": "B", "w": 0.6, "h": 0.4, "d": 0.7, "weight": 3, "priority": 1},
+    ]
+    params = {"population": 8, "generations": 4, "seed": 3}
+    body = {"truck": truck, "boxes": boxes, "params": params}
+
+    r = requests.post(f"{engine}/jobs?priority=1", json=body, timeout=30)
+    assert r.status_code == 202
+    job_id = r.json()["job_id"]
+
+    deadline = time.time() + 60
+    while True:
+        status = requests.get(f"{engine}/jobs/{job_id}", timeout=30).json()
+        if status["status"] in ("done", "failed", "cancelled") or time.time() > deadline:
+            break
+        time.sleep(0.2)
+
+    assert status["status"] == "done"
+    assert status["priority"] == 1
+    assert status["progress"]["generation"] == status["progress"]["generations"]
+
+    blocking = requests.post(f"{engine}/optimize", json=body, timeout=60).json()
+    assert status["result"] == blocking
+
+    assert requests.get(f"{engine}/jobs/999999999", timeout=10).status_code == 404
+    assert requests.delete(f"{engine}/jobs/{job_id}", timeout=10).status_code == 409
@@ -0,0 +1,114 @@
+import os
+import random
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _manifest(count: int, seed: int) -> list[dict]:
+    rng = random.Random(seed)
+    return [
+        {
+            "id": f"M{i}",
+            "w": round(rng.uniform(0.2, 0.8), 3),
+            "h": round(rng.uniform(0.2, 0.7), 3),
+            "d": round(rng.uniform(0.2, 1.0), 3),
+            "weight": round(rng.uniform(1, 20), 1),
+        }
+        for i in range(count)
+    ]
+
+
+TRUCK = {"w": 2.4, "h": 2.6, "d": 2.0, "max_weight": 24000}
+
+
+def test_local_search_reports_gain_and_cpu_time():
+    engine = _engine_url()
+
+    # Scenario: a planner turns on the memetic step; the plan is still a full accounting
+    # of the manifest and the metrics say what the local search bought and what it cost.
+    boxes = _manifest(50, 1)
+    params = {"generations": 4, "seed": 9, "local_search_elites": 2, "local_search_moves": 16}
+    body = {"truck": TRUCK, "boxes": boxes, "params": params}
+    r = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert r.status_code == 200
+    data = r.json()
+    ids = [p["id"] for p in data["placed"]] + data["unplaced"]
+    assert sorted(ids) == sorted(b["id"] for b in boxes)
+    metrics = data["metrics"]
+    assert metrics["local_search_gain"] >= 0
+    assert metrics["local_search_ms"] > 0
+
+
+def test_local_search_off_by_default():
+    engine = _engine_url()
+
+    # Scenario: existing clients see the same metrics as before.
+    body = {"truck": TRUCK, "boxes": _manifest(20, 2), "params": {"generations": 2}}
+    r = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert r.status_code == 200
+    assert "local_search_ms" not in r.json()["metrics"]
+
+
+@pytest.mark.parametrize(
+    "params",
+    [{"local_search_elites": -1}, {"local_search_moves": -5}],
+)
+def test_bad_local_search_params_rejected(params):
+    engine = _engine_url()
+
+    # Scenario: negative budgets are a client error.
+    body = {"truck": TRUCK, "boxes": _manifest(3, 3), "params": params}
+    r = requests.post(f"{engine}/optimize", json=body, timeout=30)
+    assert r.status_code == 400
+
+
+def _overflowing_manifest() -> list[dict]:
+    # ~17.8 m³ of boxes for a 12.5 m³ truck, in SKUs of three.
+    rng = random.Random(5)
+    boxes = []
+    for i in range(120):
+        if i % 3 == 2:
+            box = dict(boxes[-1])
+        else:
+            box = {
+                "w": round(rng.uniform(0.3, 0.8), 3),
+                "h": round(rng.uniform(0.2, 0.7), 3),
+                "d": round(rng.uniform(0.3, 0.9), 3),
+                "weight": round(rng.uniform(2, 40), 1),
+            }
+        box["id"] = f"O{i}"
+        boxes.append(box)
+    return boxes
+
+
+@pytest.mark.parametrize("decoder", ["extreme_points", "wall", "ems"])
+def test_local_search_gains_when_boxes_exceed_truck(decoder):
+    engine = _engine_url()
+
+    # Scenario: more box volume than truck volume, the case the memetic step is for; every
+    # decoder, EMS included, improves its elites and still accounts for every box.
+    boxes = _overflowing_manifest()
+    truck = {"w": 2.4, "h": 2.6, "d": 2.0, "max_weight": 24000}
+    assert sum(b["w"] * b["h"] * b["d"] for b in boxes) > truck["w"] * truck["h"] * truck["d"]
+    params = {
+        "generations": 4,
+        "population": 12,
+        "seed": 3,
+        "decoder": decoder,
+        "local_search_elites": 2,
+        "local_search_moves": 16,
+    }
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=120
+    )
+    assert r.status_code == 200
+    data = r.json()
+    assert data["unplaced"]
+    assert data["metrics"]["local_search_gain"] > 0
+    ids = [p["id"] for p in data["placed"]] + data["unplaced"]
+    assert sorted(ids) == sorted(b["id"] for b in boxes)
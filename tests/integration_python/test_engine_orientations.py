@@ -0,0 +1,43 @@
+import os
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_upright_boxes_keep_their_height_vertical():
+    engine = _engine_url()
+
+    # Scenario: "this side up" boxes are only turned about the vertical axis, so every
+    # placement keeps the box's own h as its height; a bad mask is rejected.
+    truck = {"w": 2.4, "h": 2.6, "d": 4.0, "max_weight": 5000}
+    boxes = [
+        {
+            "id": f"U{i}",
+            "w": 0.3 + 0.1 * (i % 3),
+            "h": 0.5,
+            "d": 0.2 + 0.1 * (i % 2),
+            "upright": True,
+        }
+        for i in range(30)
+    ]
+    params = {"population": 6, "generations": 3}
+
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=60
+    )
+    assert r.status_code == 200
+    placed = r.json()["placed"]
+    assert placed
+    for p in placed:
+        assert p["h"] == pytest.approx(0.5)
+
+    bad = requests.post(
+        f"{engine}/optimize",
+        json={"truck": truck, "boxes": [dict(boxes[0], orientations=0)], "params": params},
+        timeout=30,
+    )
+    assert bad.status_code == 400
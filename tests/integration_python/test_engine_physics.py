@@ -48,3 +48,94 @@ def test_crush_blocks_heavy_on_light():
     data = r.json()
 
     assert "heavy_top" in data["unplaced"]
+
+
+def test_crush_counts_every_tier_above():
+    engine = _engine_url()
+
+    # Scenario: the bottom of a stack carries the boxes resting on the box above it too.
+    # Each 0.5 x 0.5 m box holds 625 kg by pressure, so one 400 kg box on another is fine
+    # but a third would put 800 kg on the bottom one.
+    payload = {
+        # Constraint: a single footprint fits on the floor, so the only way to place all
+        # three boxes is one stack.
+        "truck": {"w": 0.5, "h": 1.0, "d": 0.5, "max_weight": 2000},
+        "boxes": [
+            {"id": f"tier_{i}", "w": 0.5, "h": 0.3, "d": 0.5, "weight": 400, "priority": 1}
+            for i in range(3)
+        ],
+        "params": {"population": 8, "generations": 4, "mutation_rate": 0.1, "seed": 3},
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    data = r.json()
+
+    assert len(data["placed"]) == 2
+    assert len(data["unplaced"]) == 1
+
+
+def test_fragile_box_carries_nothing():
+    engine = _engine_url()
+
+    # Scenario: a box marked fragile keeps its top clear, however light the box above.
+    payload = {
+        # Constraint: one footprint fits on the floor, so "top" can only go on "base".
+        "truck": {"w": 1.0, "h": 0.9, "d": 1.0, "max_weight": 1000},
+        "boxes": [
+            {"id": "base", "w": 1.0, "h": 0.65, "d": 1.0, "weight": 50, "priority": 1, "fragile": True},
+            {"id": "top", "w": 1.0, "h": 0.2, "d": 1.0, "weight": 1, "priority": 1},
+        ],
+        "params": {"population": 8, "generations": 4, "mutation_rate": 0.1, "seed": 4},
+    }
+
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    assert r.json()["unplaced"] == ["top"]
+
+    # Scenario: an explicit max_load below the weight above rejects the stack the same way.
+    payload["boxes"][0].pop("fragile")
+    payload["boxes"][0]["max_load"] = 0.5
+    r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+    assert r.status_code == 200
+    assert r.json()["unplaced"] == ["top"]
+
+
+def test_physics_mode_turns_crush_off():
+    engine = _engine_url()
+
+    # Scenario: the three-tier stack above places in full once crush is not checked.
+    for mode in ("support", "none"):
+        payload = {
+            "truck": {"w": 0.5, "h": 1.0, "d": 0.5, "max_weight": 2000},
+            "boxes": [
+                {"id": f"tier_{i}", "w": 0.5, "h": 0.3, "d": 0.5, "weight": 400, "priority": 1}
+                for i in range(3)
+            ],
+            "params": {"population": 8, "generations": 4, "mutation_rate": 0.1, "seed": 3, "physics": mode},
+        }
+
+        r = requests.post(f"{engine}/optimize", json=payload, timeout=60)
+        assert r.status_code == 200
+        data = r.json()
+
+        assert len(data["placed"]) == 3
+        assert data["unplaced"] == []
+
+
+def test_physics_params_are_validated():
+    engine = _engine_url()
+
+    # Scenario: unknown physics modes and out-of-range limits are client errors.
+    base = {
+        "truck": {"w": 1.0, "h": 1.0, "d": 1.0, "max_weight": 1000},
+        "boxes": [{"id": "a", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 1, "priority": 1}],
+    }
+    bad_params = [{"physics": "gravity"}, {"min_support": 1.5}, {"max_pressure": 0}]
+    for params in bad_params:
+        r = requests.post(f"{engine}/optimize", json={**base, "params": params}, timeout=60)
+        assert r.status_code == 400
+
+    boxes = [{**base["boxes"][0], "max_load": -1}]
+    r = requests.post(f"{engine}/optimize", json={**base, "boxes": boxes}, timeout=60)
+    assert r.status_code == 400
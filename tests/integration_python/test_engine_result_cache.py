@@ -0,0 +1,69 @@
+import os
+import random
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _cache_stats(engine: str) -> dict:
+    r = requests.get(f"{engine}/metrics", timeout=10)
+    assert r.status_code == 200
+    return r.json()["result_cache"]
+
+
+def _fresh_seed() -> int:
+    # A seed no earlier run on this engine is likely to have used, so the first call misses.
+    return random.SystemRandom().randrange(1, 2**31)
+
+
+def _body(seed: int) -> dict:
+    boxes = [
+        {"id": f"RC{i}", "w": 0.3 + 0.05 * (i % 5), "h": 0.4, "d": 0.5, "weight": 4}
+        for i in range(24)
+    ]
+    truck = {"w": 2.4, "h": 2.6, "d": 3.1, "max_weight": 5000}
+    return {"truck": truck, "boxes": boxes, "params": {"generations": 3, "seed": seed}}
+
+
+def test_repeat_optimize_is_served_from_cache():
+    engine = _engine_url()
+
+    # Scenario: a planner clicks Optimize twice on the same manifest and seed; the second
+    # call returns the stored plan, and reordering the boxes does not change the key.
+    body = _body(_fresh_seed())
+    before = _cache_stats(engine)
+    first = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert first.status_code == 200
+    after_first = _cache_stats(engine)
+
+    second = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert second.json() == first.json()
+    reordered = {**body, "boxes": list(reversed(body["boxes"]))}
+    third = requests.post(f"{engine}/optimize", json=reordered, timeout=60)
+    assert third.json() == first.json()
+
+    after = _cache_stats(engine)
+    if after["capacity_bytes"] == 0:
+        return  # cache disabled on this engine
+    assert after_first["misses"] == before["misses"] + 1
+    assert after["hits"] + after["disk_hits"] >= after_first["hits"] + after_first["disk_hits"] + 2
+
+
+def test_changed_params_miss_the_cache():
+    engine = _engine_url()
+
+    # Scenario: another seed is another run; its plan is computed, not reused.
+    body = _body(_fresh_seed())
+    requests.post(f"{engine}/optimize", json=body, timeout=60)
+    before = _cache_stats(engine)
+    body["params"]["seed"] += 1
+    r = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert r.status_code == 200
+    after = _cache_stats(engine)
+    if after["capacity_bytes"] == 0:
+        return
+    assert after["misses"] == before["misses"] + 1
+    assert set(after) >= {"entries", "bytes", "evictions", "spilled"}
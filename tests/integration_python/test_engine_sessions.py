@@ -0,0 +1,128 @@
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _overlaps(a: dict, b: dict) -> bool:
+    return all(
+        a[k] < b[k] + b[s] - 1e-9 and b[k] < a[k] + a[s] - 1e-9
+        for k, s in (("x", "w"), ("y", "h"), ("z", "d"))
+    )
+
+
+def test_session_places_boxes_as_they_arrive():
+    engine = _engine_url()
+
+    # Scenario: boxes reach the dock one at a time; each is placed next to the earlier
+    # ones, which never move, and the snapshot matches the placements handed out.
+    truck = {"w": 1.0, "h": 1.0, "d": 2.0, "max_weight": 1000}
+    r = requests.post(f"{engine}/sessions", json={"truck": truck}, timeout=10)
+    assert r.status_code == 201
+    session = f"{engine}/sessions/{r.json()['session_id']}"
+
+    placements = {}
+    for i in range(6):
+        box = {"id": f"B{i}", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 5}
+        r = requests.post(f"{session}/boxes", json=box, timeout=10)
+        assert r.status_code == 200
+        assert r.json()["placed"] is True
+        placements[box["id"]] = r.json()["placement"]
+
+    first = placements["B0"]
+    assert (first["x"], first["y"], first["z"]) == (0, 0, 0)
+
+    snap = requests.get(session, timeout=10).json()
+    assert {p["id"]: p for p in snap["placed"]} == placements
+    assert snap["unplaced"] == []
+    assert abs(snap["metrics"]["total_weight"] - 30) < 1e-9
+    placed = snap["placed"]
+    for i, a in enumerate(placed):
+        for b in placed[i + 1 :]:
+            assert not _overlaps(a, b)
+
+    # A placed id cannot be added twice.
+    dup = {"id": "B0", "w": 0.1, "h": 0.1, "d": 0.1}
+    assert requests.post(f"{session}/boxes", json=dup, timeout=10).status_code == 400
+
+    assert requests.delete(session, timeout=10).status_code == 200
+    assert requests.get(session, timeout=10).status_code == 404
+
+
+def test_session_remove_frees_space_and_respects_stacking():
+    engine = _engine_url()
+
+    # Scenario: the truck holds one floor box with one on top. The lower box cannot be
+    # removed while it carries the upper one; once both are out, a box that only fits on
+    # the floor goes in where they were.
+    truck = {"w": 0.5, "h": 1.0, "d": 0.5, "max_weight": 1000}
+    r = requests.post(f"{engine}/sessions", json={"truck": truck}, timeout=10)
+    session = f"{engine}/sessions/{r.json()['session_id']}"
+
+    for box_id in ("low", "high"):
+        box = {"id": box_id, "w": 0.5, "h": 0.5, "d": 0.5, "weight": 5}
+        assert requests.post(f"{session}/boxes", json=box, timeout=10).json()["placed"]
+
+    tall = {"id": "tall", "w": 0.5, "h": 1.0, "d": 0.5, "weight": 5, "upright": True}
+    r = requests.post(f"{session}/boxes", json=tall, timeout=10)
+    assert r.json() == {"placed": False, "placement": None}
+    assert requests.get(session, timeout=10).json()["unplaced"] == ["tall"]
+
+    assert requests.delete(f"{session}/boxes/low", timeout=10).status_code == 409
+    assert requests.delete(f"{session}/boxes/high", timeout=10).status_code == 200
+    assert requests.delete(f"{session}/boxes/low", timeout=10).status_code == 200
+    assert requests.delete(f"{session}/boxes/low", timeout=10).status_code == 409
+
+    r = requests.post(f"{session}/boxes", json=tall, timeout=10)
+    assert r.json()["placed"] is True
+    snap = requests.get(session, timeout=10).json()
+    assert [p["id"] for p in snap["placed"]] == ["tall"]
+    assert snap["unplaced"] == []
+
+    requests.delete(session, timeout=10)
+
+
+def test_session_rejects_bad_input():
+    engine = _engine_url()
+
+    # Scenario: invalid trucks, params and boxes are client errors; unknown sessions 404.
+    r = requests.post(f"{engine}/sessions", json={"truck": {"w": 1.0}}, timeout=10)
+    assert r.status_code == 400
+    truck = {"w": 1.0, "h": 1.0, "d": 1.0, "max_weight": 10}
+    body = {"truck": truck, "params": {"physics": "bogus"}}
+    assert requests.post(f"{engine}/sessions", json=body, timeout=10).status_code == 400
+
+    r = requests.post(f"{engine}/sessions", json={"truck": truck}, timeout=10)
+    session = f"{engine}/sessions/{r.json()['session_id']}"
+    assert requests.post(f"{session}/boxes", json=[1, 2], timeout=10).status_code == 400
+    assert requests.post(f"{session}/boxes", json={"id": "X"}, timeout=10).status_code == 400
+    requests.delete(session, timeout=10)
+
+    missing = f"{engine}/sessions/does-not-exist"
+    assert requests.get(missing, timeout=10).status_code == 404
+    box = {"id": "A", "w": 0.1, "h": 0.1, "d": 0.1}
+    assert requests.post(f"{missing}/boxes", json=box, timeout=10).status_code == 404
+    assert requests.delete(f"{missing}/boxes/A", timeout=10).status_code == 404
+
+
+def test_session_refuses_balance_limits_and_drops():
+    engine = _engine_url()
+
+    # Scenario: a session has no planned load or stop order, so trucks with axle or lateral
+    # limits and boxes with a drop are refused rather than silently loaded without them.
+    truck = {"w": 2.4, "h": 2.6, "d": 13.6, "max_weight": 24000}
+    axles = dict(truck, front_axle_z=1.0, rear_axle_z=11.0, rear_axle_max=18000)
+    for limited in (axles, dict(truck, max_lateral_offset=0.1)):
+        r = requests.post(f"{engine}/sessions", json={"truck": limited}, timeout=10)
+        assert r.status_code == 400
+
+    r = requests.post(f"{engine}/sessions", json={"truck": truck}, timeout=10)
+    session = f"{engine}/sessions/{r.json()['session_id']}"
+    box = {"id": "S", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 10, "drop": 2}
+    assert requests.post(f"{session}/boxes", json=box, timeout=10).status_code == 400
+    snapshot = requests.get(session, timeout=10).json()
+    assert snapshot["placed"] == [] and snapshot["unplaced"] == []
+    requests.delete(session, timeout=10)
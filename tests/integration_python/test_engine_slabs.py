@@ -0,0 +1,82 @@
+import json
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_slab_mode_returns_a_consistent_plan():
+    engine = _engine_url()
+
+    # Scenario: slab mode on a small manifest still accounts for every box once and keeps
+    # every placement inside the truck.
+    truck = {"w": 2.4, "h": 2.6, "d": 4.0, "max_weight": 5000}
+    boxes = [
+        {"id": f"S{i}", "w": 0.2 + 0.05 * (i % 5), "h": 0.3, "d": 0.25 + 0.05 * (i % 3)}
+        for i in range(60)
+    ]
+    params = {"population": 6, "generations": 3, "slab_mode": "on", "slab_boxes": 20}
+
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=120
+    )
+    assert r.status_code == 200
+    body = r.json()
+
+    ids = [p["id"] for p in body["placed"]] + body["unplaced"]
+    assert sorted(ids) == sorted(b["id"] for b in boxes)
+    for p in body["placed"]:
+        assert p["z"] >= 0 and p["z"] + p["d"] <= truck["d"] + 1e-9
+
+    bad = requests.post(
+        f"{engine}/optimize",
+        json={"truck": truck, "boxes": boxes, "params": {"slab_mode": "sideways"}},
+        timeout=30,
+    )
+    assert bad.status_code == 400
+
+
+def test_slab_mode_streams_progress_per_slab():
+    engine = _engine_url()
+
+    # Scenario: in slab mode the stream reports after every slab instead of once at the
+    # end, the step count only grows, and the deltas still rebuild the final plan.
+    truck = {"w": 2.4, "h": 2.6, "d": 4.0, "max_weight": 5000}
+    boxes = [
+        {"id": f"S{i}", "w": 0.2 + 0.05 * (i % 5), "h": 0.3, "d": 0.25 + 0.05 * (i % 3)}
+        for i in range(60)
+    ]
+    params = {"population": 6, "generations": 3, "slab_mode": "on", "slab_boxes": 20}
+    body = {"truck": truck, "boxes": boxes, "params": params}
+
+    r = requests.post(
+        f"{engine}/optimize/stream?interval_ms=0", json=body, stream=True, timeout=120
+    )
+    assert r.status_code == 200
+
+    events = []
+    name = None
+    for line in r.iter_lines(decode_unicode=True):
+        if line.startswith("event:"):
+            name = line[len("event:") :].strip()
+        elif line.startswith("data:"):
+            events.append((name, json.loads(line[len("data:") :])))
+
+    progress = [data for kind, data in events if kind == "progress"]
+    assert len(progress) >= 3
+    steps = [p["generation"] for p in progress]
+    assert steps == sorted(steps)
+    assert progress[0]["generation"] < progress[0]["generations"]
+    assert progress[-1]["generation"] == progress[-1]["generations"]
+
+    incumbent = {}
+    for p in progress:
+        for box_id in p["delta"]["removed"]:
+            incumbent.pop(box_id)
+        for placement in p["delta"]["upserts"]:
+            incumbent[placement["id"]] = placement
+    assert events[-1][0] == "result"
+    assert incumbent == {p["id"]: p for p in events[-1][1]["placed"]}
@@ -0,0 +1,47 @@
+import json
+import os
+
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_stream_deltas_rebuild_final_plan():
+    engine = _engine_url()
+
+    # Scenario: applying every streamed delta in order reproduces the final plan.
+    truck = {"w": 1.4, "h": 1.2, "d": 1.0, "max_weight": 1000}
+    boxes = [
+        {"id": f"B{i}", "w": 0.3 + 0.05 * (i % 4), "h": 0.3, "d": 0.4, "weight": 1}
+        for i in range(24)
+    ]
+    body = {"truck": truck, "boxes": boxes, "params": {"population": 8, "generations": 5}}
+
+    r = requests.post(f"{engine}/optimize/stream?interval_ms=0", json=body, stream=True, timeout=60)
+    assert r.status_code == 200
+    assert r.headers["Content-Type"].startswith("text/event-stream")
+
+    events = []
+    name = None
+    for line in r.iter_lines(decode_unicode=True):
+        if line.startswith("event:"):
+            name = line[len("event:") :].strip()
+        elif line.startswith("data:"):
+            events.append((name, json.loads(line[len("data:") :])))
+
+    progress = [data for kind, data in events if kind == "progress"]
+    assert progress
+    assert events[-1][0] == "result"
+
+    incumbent = {}
+    for p in progress:
+        for box_id in p["delta"]["removed"]:
+            incumbent.pop(box_id)
+        for placement in p["delta"]["upserts"]:
+            incumbent[placement["id"]] = placement
+
+    final = events[-1][1]
+    assert incumbent == {p["id"]: p for p in final["placed"]}
+    assert progress[-1]["generation"] == progress[-1]["generations"]
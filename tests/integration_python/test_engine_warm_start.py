@@ -0,0 +1,98 @@
+import os
+import random
+
+import pytest
+import requests
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def _manifest(count: int, seed: int) -> list[dict]:
+    rng = random.Random(seed)
+    return [
+        {
+            "id": f"B{i}",
+            "w": round(rng.uniform(0.2, 0.8), 3),
+            "h": round(rng.uniform(0.2, 0.7), 3),
+            "d": round(rng.uniform(0.2, 1.0), 3),
+            "weight": round(rng.uniform(1, 20), 1),
+        }
+        for i in range(count)
+    ]
+
+
+def _score(result: dict) -> float:
+    return result["metrics"]["utilization"] * 100 - 0.5 * len(result["unplaced"])
+
+
+TRUCK = {"w": 2.4, "h": 2.6, "d": 2.0, "max_weight": 24000}
+
+
+def test_previous_result_is_never_lost():
+    engine = _engine_url()
+
+    # Scenario: re-running the same manifest from its previous plan keeps at least that
+    # plan's quality, even with a different seed and a single generation.
+    boxes = _manifest(60, 1)
+    body = {"truck": TRUCK, "boxes": boxes, "params": {"generations": 10, "seed": 3}}
+    first = requests.post(f"{engine}/optimize", json=body, timeout=60).json()
+
+    params = {"generations": 1, "seed": 77, "previous_result": first}
+    body = {"truck": TRUCK, "boxes": boxes, "params": params}
+    r = requests.post(f"{engine}/optimize", json=body, timeout=60)
+    assert r.status_code == 200
+    assert _score(r.json()) >= _score(first) - 1e-9
+
+
+def test_changed_manifest_drops_and_inserts_boxes():
+    engine = _engine_url()
+
+    # Scenario: one box left the manifest and one arrived since the previous plan; the
+    # seed order skips the missing id and still plans the new box.
+    boxes = _manifest(40, 2)
+    body = {"truck": TRUCK, "boxes": boxes, "params": {"generations": 4, "seed": 3}}
+    first = requests.post(f"{engine}/optimize", json=body, timeout=60).json()
+
+    changed = boxes[1:] + [{"id": "NEW", "w": 0.3, "h": 0.3, "d": 0.3, "weight": 2}]
+    params = {"generations": 2, "seed": 3, "previous_result": first}
+    r = requests.post(
+        f"{engine}/optimize", json={"truck": TRUCK, "boxes": changed, "params": params}, timeout=60
+    )
+    assert r.status_code == 200
+    data = r.json()
+    ids = [p["id"] for p in data["placed"]] + data["unplaced"]
+    assert sorted(ids) == sorted(b["id"] for b in changed)
+
+
+def test_warm_start_cache_seeds_the_next_run():
+    engine = _engine_url()
+
+    # Scenario: with warm_start the engine remembers the plan itself, so a repeat run on
+    # the same manifest is at least as good without the client sending anything back.
+    boxes = _manifest(50, 3)
+    params = {"generations": 6, "seed": 5, "warm_start": True}
+    body = {"truck": TRUCK, "boxes": boxes, "params": params}
+    first = requests.post(f"{engine}/optimize", json=body, timeout=60).json()
+
+    body["params"] = {**params, "generations": 1, "seed": 6}
+    again = requests.post(f"{engine}/optimize", json=body, timeout=60).json()
+    assert _score(again) >= _score(first) - 1e-9
+
+
+@pytest.mark.parametrize(
+    "params",
+    [
+        {"seed_orders": "B0"},
+        {"seed_orders": [[1, 2]]},
+        {"previous_result": {"placed": [{"x": 0}]}},
+    ],
+)
+def test_bad_seed_orders_rejected(params):
+    engine = _engine_url()
+
+    # Scenario: seeds must name boxes by id.
+    body = {"truck": TRUCK, "boxes": _manifest(3, 4), "params": params}
+    r = requests.post(f"{engine}/optimize", json=body, timeout=30)
+    assert r.status_code == 400
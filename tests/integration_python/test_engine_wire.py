@@ -0,0 +1,50 @@
+import os
+
+import requests
+
+from app.core import wire
+
+
+def _engine_url() -> str:
+    return os.environ.get("ENGINE_URL", "http://localhost:6000").rstrip("/")
+
+
+def test_binary_request_matches_json():
+    engine = _engine_url()
+
+    # Scenario: the binary wire format is a transport detail — same instance, same plan.
+    truck = {"w": 2.4, "h": 2.6, "d": 6.0, "max_weight": 1000}
+    boxes = [
+        {"id": "A", "w": 0.5, "h": 0.5, "d": 0.5, "weight": 2, "priority": 2},
+        {"sku": "B", "w": 0.6, "h": 0.4, "d": 0.7, "weight": 3, "priority": 1},
+    ]
+    params = {"population": 10, "generations": 5, "mutation_rate": 0.1, "seed": 7}
+
+    as_json = requests.post(
+        f"{engine}/optimize", json={"truck": truck, "boxes": boxes, "params": params}, timeout=60
+    )
+    as_wire = requests.post(
+        f"{engine}/optimize",
+        data=wire.encode_request(truck, boxes, params),
+        headers={"Content-Type": wire.CONTENT_TYPE, "Accept": wire.CONTENT_TYPE},
+        timeout=60,
+    )
+
+    assert as_json.status_code == 200
+    assert as_wire.status_code == 200
+    assert as_wire.headers["Content-Type"].startswith(wire.CONTENT_TYPE)
+    assert wire.decode_result(as_wire.content) == as_json.json()
+
+
+def test_truncated_binary_request_is_rejected():
+    engine = _engine_url()
+
+    data = wire.encode_request({"w": 1, "h": 1, "d": 1}, [{"id": "A", "w": 1, "h": 1, "d": 1}], {})
+    r = requests.post(
+        f"{engine}/optimize",
+        data=data[:-20],
+        headers={"Content-Type": wire.CONTENT_TYPE},
+        timeout=60,
+    )
+    assert r.status_code == 400
+    assert r.json()["error"] == "invalid_request"